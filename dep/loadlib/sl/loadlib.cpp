@@ -250,10 +250,8 @@ FileLoader::~FileLoader()
     free();
 }
 
-bool FileLoader::loadFile(char* filename, bool log)
+bool ReadNewestFile(char const* filename, uint8*& data, uint32& size, bool log)
 {
-    free();
-
     HANDLE fileHandle = 0;
 
     if (!OpenNewestFile(filename, &fileHandle))
@@ -263,24 +261,48 @@ bool FileLoader::loadFile(char* filename, bool log)
         return false;
     }
 
-    data_size = SFileGetFileSize(fileHandle, NULL);
+    size = SFileGetFileSize(fileHandle, NULL);
 
-    data = new uint8 [data_size];
+    data = new uint8 [size];
     if (!data)
     {
         SFileCloseFile(fileHandle);
         return false;
     }
 
-    if (!SFileReadFile(fileHandle, data, data_size, NULL, NULL))
+    if (!SFileReadFile(fileHandle, data, size, NULL, NULL))
     {
         if (log)
             printf("Can't read file %s\n", filename);
         SFileCloseFile(fileHandle);
+        delete[] data;
+        data = 0;
         return false;
     }
 
     SFileCloseFile(fileHandle);
+    return true;
+}
+
+bool FileLoader::loadFile(char* filename, bool log)
+{
+    uint8* fileData;
+    uint32 fileSize;
+
+    free();
+
+    if (!ReadNewestFile(filename, fileData, fileSize, log))
+        return false;
+
+    return loadData(fileData, fileSize);
+}
+
+bool FileLoader::loadData(uint8* fileData, uint32 fileSize)
+{
+    free();
+
+    data = fileData;
+    data_size = fileSize;
 
     // ToDo: Fix WDT errors...
     if (!prepareLoadedData())
@@ -59,6 +59,8 @@ typedef std::pair<ArchiveSet::const_iterator, ArchiveSet::const_iterator> Archiv
 
 bool OpenArchive(char const* mpqFileName, HANDLE* mpqHandlePtr = NULL);
 bool OpenNewestFile(char const* filename, HANDLE* fileHandlerPtr);
+// read the newest version of a file into a new[] buffer, for parsing in another thread with FileLoader::loadData
+bool ReadNewestFile(char const* filename, uint8*& data, uint32& size, bool log = true);
 ArchiveSetBounds GetArchivesBounds();
 bool ExtractFile(char const* mpq_name, std::string const& filename);
 void CloseArchives();
@@ -98,6 +100,8 @@ class FileLoader
         FileLoader();
         ~FileLoader();
         bool loadFile(char* filename, bool log = true);
+        // take a buffer read by ReadNewestFile, it is deleted by free()
+        bool loadData(uint8* fileData, uint32 fileSize);
         virtual void free();
 };
 
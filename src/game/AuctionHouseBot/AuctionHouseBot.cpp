@@ -2199,7 +2199,8 @@ void AuctionHouseBot::Rebuild(bool all)
 {
     for (uint32 i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
     {
-        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i))->GetAuctionsBounds();
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i));
+        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
         for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AuctionEntry* entry = itr->second;
@@ -2208,6 +2209,7 @@ void AuctionHouseBot::Rebuild(bool all)
                 if (all || entry->bid == 0)                                                        // expire auction now if no bid or forced
                 {
                     entry->expireTime = sWorld.GetGameTime();
+                    auctionHouse->ScheduleAuction(entry);
                 }
             }
         }
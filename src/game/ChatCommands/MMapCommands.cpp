@@ -27,6 +27,7 @@
 #include "World.h"
 #include "MoveMap.h"
 #include "PathFinder.h" // for mmap manager
+#include "PathCache.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"          // for mmap manager
 #include "CellImpl.h"
@@ -242,6 +243,12 @@ bool ChatHandler::HandleMmapStatsCommand(char* /*args*/)
     MMAP::MMapManager* manager = MMAP::MMapFactory::createOrGetMMapManager();
     PSendSysMessage(" %u maps loaded with %u tiles overall", manager->getLoadedMapsCount(), manager->getLoadedTilesCount());
 
+    if (PathCache* cache = m_session->GetPlayer()->GetMap()->GetPathCache())
+    {
+        PSendSysMessage(" path cache of current map: %u entries, " UI64FMTD " hits, " UI64FMTD " misses",
+                        uint32(cache->GetSize()), cache->GetHits(), cache->GetMisses());
+    }
+
     const dtNavMesh* navmesh = manager->GetNavMesh(m_session->GetPlayer()->GetMapId());
     if (!navmesh)
     {
@@ -30,8 +30,11 @@
 #include "SystemConfig.h"
 #include "BattleGroundMgr.h"
 #include "UpdateTime.h"
+#include "UpdateData.h"
 #include "MapPersistentStateMgr.h"
 #include "ObjectAccessor.h"
+#include "MapManager.h"
+#include "OpcodeProfiler.h"
 #include "revision_data.h"
 
  /**********************************************************************
@@ -77,6 +80,88 @@ bool ChatHandler::HandleServerInfoCommand(char* /*args*/)
     PSendSysMessage(LANG_UPTIME, str.c_str());
     PSendSysMessage("World Delay: %u", updateTime); // ToDo: move to language string
 
+    if (uint64 compressed = UpdateData::GetCompressedPackets())
+    {
+        uint64 savedKB = (UpdateData::GetCompressedBytesIn() - UpdateData::GetCompressedBytesOut()) / 1024;
+        PSendSysMessage("Compressed update packets: " UI64FMTD ", " UI64FMTD " KB saved", compressed, savedKB); // ToDo: move to language string
+    }
+
+    return true;
+}
+
+/// Display the update time statistics of the slowest maps
+bool ChatHandler::HandleServerMapStatsCommand(char* args)
+{
+    uint32 limit;
+    if (!ExtractOptUInt32(&args, limit, 10))
+    {
+        return false;
+    }
+
+    std::vector<Map*> maps;
+    maps.reserve(sMapMgr.Maps().size());
+    for (MapManager::MapMapType::const_iterator itr = sMapMgr.Maps().begin(); itr != sMapMgr.Maps().end(); ++itr)
+    {
+        maps.push_back(itr->second);
+    }
+
+    std::sort(maps.begin(), maps.end(), [](Map const* a, Map const* b)
+    {
+        return a->GetUpdateTimeStats().GetAverageTime() > b->GetUpdateTimeStats().GetAverageTime();
+    });
+
+    PSendSysMessage("Maps: %u, map update threads: %u", uint32(maps.size()), sMapMgr.GetNumMapUpdateThreads()); // ToDo: move to language string
+
+    for (std::vector<Map*>::const_iterator itr = maps.begin(); itr != maps.end() && limit; ++itr, --limit)
+    {
+        Map const* map = *itr;
+        MapUpdateTimeStats const& stats = map->GetUpdateTimeStats();
+        PSendSysMessage("Map %u (%s) instance %u, players %u: last %u ms, avg %u ms, max %u ms, updates %u",
+                        map->GetId(), map->GetMapName(), map->GetInstanceId(), map->GetPlayers().getSize(),
+                        stats.lastTime, stats.GetAverageTime(), stats.maxTime, stats.updateCount);
+    }
+
+    return true;
+}
+
+/// Display the slowest packet handlers, or switch the opcode profiling on/off or reset it
+bool ChatHandler::HandleServerOpcodeStatsCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "on"))
+    {
+        sOpcodeProfiler.SetEnabled(true);
+        SendSysMessage("Opcode profiling enabled");         // ToDo: move to language string
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "off"))
+    {
+        sOpcodeProfiler.SetEnabled(false);
+        SendSysMessage("Opcode profiling disabled");
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sOpcodeProfiler.Reset();
+        SendSysMessage("Opcode profiling stats reset");
+        return true;
+    }
+
+    uint32 limit;
+    if (!ExtractOptUInt32(&args, limit, 10))
+    {
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    sOpcodeProfiler.BuildReport(lines, limit);
+
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+    {
+        SendSysMessage(itr->c_str());
+    }
+
     return true;
 }
 
@@ -33,6 +33,7 @@
 
 #ifdef _DEBUG_VMAPS
 #include "VMapFactory.h"
+#include "LineOfSightCache.h"
 #endif
  /*
      All commands related to Teleportation
@@ -681,6 +682,11 @@ bool ChatHandler::HandleGPSCommand(char* args)
     }
 
     PSendSysMessage("Static map height (maps and vmaps): %f", obj->GetTerrain()->GetHeightStatic(obj->GetPositionX(), obj->GetPositionY(), obj->GetPositionZ()));
+
+    if (LineOfSightCache* losCache = obj->GetMap()->GetLineOfSightCache())
+    {
+        PSendSysMessage("LoS cache: %u entries, " UI64FMTD " hits, " UI64FMTD " misses", uint32(losCache->GetSize()), losCache->GetHits(), losCache->GetMisses());
+    }
 #endif
 
     return true;
@@ -0,0 +1,111 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "LineOfSightCache.h"
+
+#include <ace/Guard_T.h>
+
+// ends less than a quarter yard apart share their result
+static int32 QuantizeCoord(float coord)
+{
+    return int32(floor(coord * 4.0f));
+}
+
+LineOfSightCacheKey::LineOfSightCacheKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 mask)
+    : phaseMask(mask)
+{
+    int32 from[3] = { QuantizeCoord(x1), QuantizeCoord(y1), QuantizeCoord(z1) };
+    int32 to[3] = { QuantizeCoord(x2), QuantizeCoord(y2), QuantizeCoord(z2) };
+
+    if (std::lexicographical_compare(to, to + 3, from, from + 3))
+    {
+        std::swap(from, to);
+    }
+
+    std::copy(from, from + 3, pos);
+    std::copy(to, to + 3, pos + 3);
+}
+
+LineOfSightCache::LineOfSightCache(uint32 maxEntries)
+    : m_maxEntries(maxEntries), m_generation(0), m_hits(0), m_misses(0)
+{
+}
+
+uint32 LineOfSightCache::GetGeneration()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, 0);
+
+    return m_generation;
+}
+
+bool LineOfSightCache::Find(const LineOfSightCacheKey& key, bool& inLineOfSight)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, false);
+
+    ResultMap::const_iterator itr = m_results.find(key);
+    if (itr == m_results.end())
+    {
+        ++m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    inLineOfSight = itr->second;
+    return true;
+}
+
+void LineOfSightCache::Store(const LineOfSightCacheKey& key, uint32 generation, bool inLineOfSight)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    // the collision changed while the result was computed
+    if (generation != m_generation)
+    {
+        return;
+    }
+
+    // results only live for one update, so just stop adding when full
+    if (m_results.size() >= m_maxEntries)
+    {
+        return;
+    }
+
+    m_results[key] = inLineOfSight;
+}
+
+void LineOfSightCache::Invalidate()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    ++m_generation;
+    m_results.clear();
+}
+
+size_t LineOfSightCache::GetSize()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, 0);
+
+    return m_results.size();
+}
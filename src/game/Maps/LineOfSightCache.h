@@ -0,0 +1,116 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_LINEOFSIGHTCACHE_H
+#define MANGOS_LINEOFSIGHTCACHE_H
+
+#include "Common.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+/**
+ * @brief Line of sight between two points of one map, ends rounded to a quarter yard.
+ *
+ * The ends are stored in a fixed order, the ray is tested the same way in both
+ * directions so a caster checking its target and the target checking the caster
+ * share an entry.
+ */
+struct LineOfSightCacheKey
+{
+    LineOfSightCacheKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask);
+
+    bool operator==(const LineOfSightCacheKey& other) const
+    {
+        return std::equal(pos, pos + 6, other.pos) && phaseMask == other.phaseMask;
+    }
+
+    int32 pos[6];
+    uint32 phaseMask;
+};
+
+struct LineOfSightCacheKeyHash
+{
+    size_t operator()(const LineOfSightCacheKey& key) const
+    {
+        uint64 hash = key.phaseMask;
+        for (int i = 0; i < 6; ++i)
+        {
+            hash = (hash ^ uint32(key.pos[i])) * UI64LIT(0x100000001B3);
+        }
+        return size_t(hash ^ (hash >> 32));
+    }
+};
+
+/**
+ * @brief Line of sight results of one map, kept for a single map update.
+ *
+ * AoE spells, assist calls and target selection test the line of sight between the
+ * same units many times in a tick. Results are dropped at the start of every map
+ * update, and whenever the collision of a gameobject (doors, transports) changes.
+ *
+ * A result computed while the collision changed is not stored, the generation read
+ * before computing it is given to Store for that. May be used by the region workers
+ * of the map concurrently.
+ */
+class LineOfSightCache
+{
+    public:
+
+        explicit LineOfSightCache(uint32 maxEntries);
+
+        /// Generation of the stored results, read it before computing a result to store
+        uint32 GetGeneration();
+
+        /// Get the cached result, returns false on a miss
+        bool Find(const LineOfSightCacheKey& key, bool& inLineOfSight);
+
+        /// Remember a result, dropped if the cache was invalidated since generation was read
+        void Store(const LineOfSightCacheKey& key, uint32 generation, bool inLineOfSight);
+
+        /// Drop all results
+        void Invalidate();
+
+        size_t GetSize();
+        uint64 GetHits() const { return m_hits; }
+        uint64 GetMisses() const { return m_misses; }
+
+    private:
+
+        typedef std::unordered_map<LineOfSightCacheKey, bool, LineOfSightCacheKeyHash> ResultMap;
+
+        uint32 m_maxEntries;
+        uint32 m_generation;
+
+        ACE_Thread_Mutex m_mutex;
+        ResultMap m_results;
+
+        uint64 m_hits;
+        uint64 m_misses;
+};
+
+#endif
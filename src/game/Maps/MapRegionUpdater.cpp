@@ -0,0 +1,59 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "MapRegionUpdater.h"
+#include "Map.h"
+
+MapRegionUpdater::MapRegionUpdater()
+{
+}
+
+MapRegionUpdater::~MapRegionUpdater()
+{
+    deactivate();
+}
+
+int MapRegionUpdater::activate(size_t num_threads)
+{
+    return m_executor.activate(int(num_threads));
+}
+
+int MapRegionUpdater::deactivate()
+{
+    return m_executor.deactivate();
+}
+
+bool MapRegionUpdater::activated()
+{
+    return m_executor.activated();
+}
+
+void MapRegionUpdater::UpdateRegions(std::vector<MapUpdateRegion>& regions, uint32 diff)
+{
+    // the map thread takes the first region instead of idling until the workers are done
+    m_executor.execute_slices(regions.size(), [&regions, diff](size_t i)
+    {
+        regions[i].map->UpdateCellRegion(regions[i], diff);
+    });
+}
@@ -0,0 +1,61 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_MAPREGIONUPDATER_H
+#define MANGOS_MAPREGIONUPDATER_H
+
+#include "Common.h"
+#include "Threading/DelayExecutor.h"
+
+struct MapUpdateRegion;
+
+/**
+ * @brief Worker threads updating the cell regions of one continent concurrently.
+ *
+ * A single pool is shared by all continents. The map thread asking for a region
+ * update works on the first region itself and only returns once all regions of
+ * its map are done, so the merge phase in Map::Update sees a quiet map.
+ */
+class MapRegionUpdater
+{
+    public:
+
+        MapRegionUpdater();
+        ~MapRegionUpdater();
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated();
+
+        /// Update all regions (of the same map), returns when every region is done
+        void UpdateRegions(std::vector<MapUpdateRegion>& regions, uint32 diff);
+
+    private:
+
+        DelayExecutor m_executor;
+};
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "MapUpdater.h"
+#include "Map.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+class MapUpdateRequest : public ACE_Method_Request
+{
+    public:
+
+        MapUpdateRequest(std::vector<Map*> const& m, MapUpdater& u, uint32 d)
+            : m_maps(m), m_updater(u), m_diff(d)
+        {
+        }
+
+        virtual int call() override
+        {
+            for (std::vector<Map*>::const_iterator itr = m_maps.begin(); itr != m_maps.end(); ++itr)
+            {
+                MapUpdater::UpdateMap(**itr, m_diff);
+            }
+
+            m_updater.update_finished();
+            return 0;
+        }
+
+    private:
+
+        std::vector<Map*> m_maps;
+        MapUpdater& m_updater;
+        uint32 m_diff;
+};
+
+MapUpdater::MapUpdater()
+    : m_executor(), m_mutex(), m_condition(m_mutex), m_pendingRequests(0)
+{
+}
+
+MapUpdater::~MapUpdater()
+{
+    deactivate();
+}
+
+int MapUpdater::activate(size_t num_threads)
+{
+    return m_executor.activate(int(num_threads));
+}
+
+int MapUpdater::deactivate()
+{
+    wait();
+
+    return m_executor.deactivate();
+}
+
+int MapUpdater::wait()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
+
+    while (m_pendingRequests > 0)
+    {
+        m_condition.wait();
+    }
+
+    return 0;
+}
+
+int MapUpdater::schedule_update(std::vector<Map*> const& maps, uint32 diff)
+{
+    if (!activated())
+    {
+        for (std::vector<Map*>::const_iterator itr = maps.begin(); itr != maps.end(); ++itr)
+        {
+            UpdateMap(**itr, diff);
+        }
+        return 0;
+    }
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
+        ++m_pendingRequests;
+    }
+
+    if (m_executor.execute(new MapUpdateRequest(maps, *this, diff)) == -1)
+    {
+        ACE_ERROR((LM_ERROR, ACE_TEXT("(%t) %s\n"), ACE_TEXT("MapUpdater::schedule_update failed to schedule the map update")));
+
+        // the executor already dropped the request, so the maps will not be updated this tick
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
+        --m_pendingRequests;
+        m_condition.broadcast();
+        return -1;
+    }
+
+    return 0;
+}
+
+bool MapUpdater::activated()
+{
+    return m_executor.activated();
+}
+
+void MapUpdater::update_finished()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    if (m_pendingRequests == 0)
+    {
+        ACE_ERROR((LM_ERROR, ACE_TEXT("(%t) %s\n"), ACE_TEXT("MapUpdater::update_finished BUG, report to devs")));
+        return;
+    }
+
+    --m_pendingRequests;
+
+    // wake up the world thread only when the last map of this tick is done
+    if (m_pendingRequests == 0)
+    {
+        m_condition.broadcast();
+    }
+}
+
+void MapUpdater::UpdateMap(Map& map, uint32 diff)
+{
+    uint32 startTime = getMSTime();
+
+    map.Update(diff);
+
+    map.GetUpdateTimeStats().AddUpdateTime(GetMSTimeDiffToNow(startTime));
+}
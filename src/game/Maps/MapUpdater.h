@@ -0,0 +1,84 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+#include "Threading/DelayExecutor.h"
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include <vector>
+
+class Map;
+
+/**
+ * @brief Pool of worker threads updating independent Map objects concurrently.
+ *
+ * MapManager schedules one request per map id and then waits for all of them
+ * to finish before it touches transports or unloads maps, so the rest of the
+ * world tick never sees a map in the middle of its update. The instances of a
+ * map id share its terrain (grid maps, vmap tree and navmesh), they are updated
+ * one after the other by the same request.
+ *
+ * When the pool is not activated (MapUpdateThreads <= 1) the maps are updated
+ * directly in the calling thread, in the order they are scheduled.
+ */
+class MapUpdater
+{
+    public:
+
+        MapUpdater();
+        virtual ~MapUpdater();
+
+        friend class MapUpdateRequest;
+
+        /// Queue the update of maps sharing a terrain, or run it right away if there are no worker threads
+        int schedule_update(std::vector<Map*> const& maps, uint32 diff);
+
+        /// Block until all scheduled map updates have finished
+        int wait();
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated();
+
+        /// Update a map in the current thread and account the time spent in its statistics
+        static void UpdateMap(Map& map, uint32 diff);
+
+    private:
+
+        DelayExecutor m_executor;
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+        size_t m_pendingRequests;
+
+        void update_finished();
+};
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "TerrainPrefetcher.h"
+#include "GridMap.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+class TerrainPrefetchRequest : public ACE_Method_Request
+{
+    public:
+
+        TerrainPrefetchRequest(TerrainPrefetcher& prefetcher, TerrainInfo* terrain, uint64 key, uint32 x, uint32 y)
+            : m_prefetcher(prefetcher), m_terrain(terrain), m_key(key), m_x(x), m_y(y)
+        {
+            // keep the terrain alive while the request is queued
+            m_terrain->AddRef();
+        }
+
+        ~TerrainPrefetchRequest()
+        {
+            // the last reference may unload the terrain, that has to happen in the world thread
+            m_prefetcher.ReleaseTerrain(m_terrain);
+        }
+
+        virtual int call() override
+        {
+            m_terrain->Prefetch(m_x, m_y);
+            m_prefetcher.PrefetchFinished(m_key);
+            return 0;
+        }
+
+    private:
+
+        TerrainPrefetcher& m_prefetcher;
+        TerrainInfo* m_terrain;
+        uint64 m_key;
+        uint32 m_x;
+        uint32 m_y;
+};
+
+TerrainPrefetcher::TerrainPrefetcher()
+{
+}
+
+TerrainPrefetcher::~TerrainPrefetcher()
+{
+    deactivate();
+}
+
+int TerrainPrefetcher::activate(size_t num_threads)
+{
+    return m_executor.activate(int(num_threads));
+}
+
+int TerrainPrefetcher::deactivate()
+{
+    int result = m_executor.deactivate();
+
+    {
+        // requests still queued were dropped
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_queuedLock, -1);
+        m_queued.clear();
+    }
+
+    // no request is left to hold a reference
+    Update();
+
+    return result;
+}
+
+bool TerrainPrefetcher::activated()
+{
+    return m_executor.activated();
+}
+
+void TerrainPrefetcher::Prefetch(TerrainInfo* terrain, uint32 x, uint32 y)
+{
+    uint64 key = uint64(terrain->GetMapId()) << 32 | (x * MAX_NUMBER_OF_GRIDS + y);
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_queuedLock);
+
+        if (!m_queued.insert(key).second)
+        {
+            return;
+        }
+    }
+
+    if (m_executor.execute(new TerrainPrefetchRequest(*this, terrain, key, x, y)) == -1)
+    {
+        // nothing is lost, the grid is read by the map thread when needed
+        PrefetchFinished(key);
+    }
+}
+
+void TerrainPrefetcher::PrefetchFinished(uint64 key)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_queuedLock);
+    m_queued.erase(key);
+}
+
+void TerrainPrefetcher::ReleaseTerrain(TerrainInfo* terrain)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_queuedLock);
+    m_released.push_back(terrain);
+}
+
+void TerrainPrefetcher::Update()
+{
+    std::vector<TerrainInfo*> released;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_queuedLock);
+        released.swap(m_released);
+    }
+
+    for (std::vector<TerrainInfo*>::const_iterator itr = released.begin(); itr != released.end(); ++itr)
+    {
+        if ((*itr)->Release())
+        {
+            sTerrainMgr.UnloadTerrain((*itr)->GetMapId());
+        }
+    }
+}
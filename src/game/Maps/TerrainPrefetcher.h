@@ -0,0 +1,81 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_TERRAINPREFETCHER_H
+#define MANGOS_TERRAINPREFETCHER_H
+
+#include "Common.h"
+#include "Threading/DelayExecutor.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <unordered_set>
+#include <vector>
+
+class TerrainInfo;
+
+/**
+ * @brief I/O threads reading the terrain of grids before the players reach them.
+ *
+ * Map::PlayerRelocation asks for the grids ahead of a moving player. A worker
+ * reads the .map file, the vmap models and the mmap tile of the grid, and
+ * leaves them in the prefetch slots of TerrainInfo, VMapManager2 and MMapManager.
+ * Nothing is published to the map by the workers: the map thread picks the
+ * data up when it loads the grid as usual, only without touching the disk.
+ */
+class TerrainPrefetcher
+{
+    public:
+
+        TerrainPrefetcher();
+        ~TerrainPrefetcher();
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated();
+
+        /// Queue the read of a grid, does nothing if it is already queued
+        void Prefetch(TerrainInfo* terrain, uint32 x, uint32 y);
+
+        /// Called by the request of a grid once it is read
+        void PrefetchFinished(uint64 key);
+
+        /// Called by a request when it is destroyed, the terrain is released by Update
+        void ReleaseTerrain(TerrainInfo* terrain);
+
+        /// Drop the terrain references of finished requests, world thread only
+        void Update();
+
+    private:
+
+        DelayExecutor m_executor;
+
+        ACE_Thread_Mutex m_queuedLock;
+        std::unordered_set<uint64> m_queued;
+        std::vector<TerrainInfo*> m_released;               // guarded by m_queuedLock
+};
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "UpdatePacketSender.h"
+#include "Player.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include "UpdateData.h"
+
+// Below this many players per batch the hand over to a worker costs more than it saves
+#define MIN_PLAYERS_PER_BATCH 16
+
+UpdatePacketSender::UpdatePacketSender() : m_numThreads(0)
+{
+}
+
+UpdatePacketSender::~UpdatePacketSender()
+{
+    deactivate();
+}
+
+int UpdatePacketSender::activate(size_t num_threads)
+{
+    if (m_executor.activate(int(num_threads)) == -1)
+    {
+        return -1;
+    }
+
+    m_numThreads = num_threads;
+    return 0;
+}
+
+int UpdatePacketSender::deactivate()
+{
+    m_numThreads = 0;
+    return m_executor.deactivate();
+}
+
+bool UpdatePacketSender::activated()
+{
+    return m_executor.activated();
+}
+
+void UpdatePacketSender::SendUpdates(UpdateDataMapType& update_players)
+{
+    std::vector<UpdateDataMapType::value_type*> updates;
+    updates.reserve(update_players.size());
+
+    // bots and the players controlling them stay on the map thread, their outgoing packets
+    // are inspected by the bot AI or the bot manager, which change the bot state
+    std::vector<UpdateDataMapType::value_type*> local;
+
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        if (iter->first->GetPlayerbotMgr() || iter->first->GetPlayerbotAI())
+        {
+            local.push_back(&*iter);
+        }
+        else
+        {
+            updates.push_back(&*iter);
+        }
+    }
+
+    size_t batches = activated() ? std::min(updates.size() / MIN_PLAYERS_PER_BATCH, m_numThreads + 1) : 0;
+
+    if (batches < 2)
+    {
+        SendBatch(updates.data(), updates.size());
+        SendBatch(local.data(), local.size());
+        return;
+    }
+
+    m_executor.execute_slices(batches, [&updates, &local, batches](size_t i)
+    {
+        const size_t begin = i * updates.size() / batches;
+        const size_t count = (i + 1) * updates.size() / batches - begin;
+        SendBatch(updates.data() + begin, count);
+
+        // the map thread also sends to the players kept out of the batches
+        if (i == 0)
+        {
+            SendBatch(local.data(), local.size());
+        }
+    });
+}
+
+void UpdatePacketSender::SendBatch(UpdateDataMapType::value_type* const* updates, size_t count)
+{
+    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
+    for (size_t i = 0; i < count; ++i)
+    {
+        updates[i]->second.BuildPacket(&packet);
+        updates[i]->first->GetSession()->SendPacket(&packet);
+        packet.clear();                                     // clean the string
+    }
+}
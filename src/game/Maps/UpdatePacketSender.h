@@ -0,0 +1,68 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_UPDATEPACKETSENDER_H
+#define MANGOS_UPDATEPACKETSENDER_H
+
+#include "Common.h"
+#include "Object.h"
+#include "Threading/DelayExecutor.h"
+
+/**
+ * @brief Worker threads building and sending the SMSG_UPDATE_OBJECT packets of a map.
+ *
+ * Map::SendObjectUpdates collects the update data of all changed objects per
+ * player, then hands the result to SendUpdates. The players are split into
+ * batches, the calling map thread takes the first batch and waits until the
+ * workers are done with the others, so the update data can be freed after.
+ *
+ * Without worker threads (MapUpdatePacketThreads = 0), or for a handful of
+ * players only, everything is done by the calling thread.
+ */
+class UpdatePacketSender
+{
+    public:
+
+        UpdatePacketSender();
+        ~UpdatePacketSender();
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated();
+
+        /// Build and send the packet of every player, returns when all are sent
+        void SendUpdates(UpdateDataMapType& update_players);
+
+        /// Build and send the packets of a batch of players in the current thread
+        static void SendBatch(UpdateDataMapType::value_type* const* updates, size_t count);
+
+    private:
+
+        DelayExecutor m_executor;
+        size_t m_numThreads;
+};
+
+#endif
@@ -57,10 +57,33 @@ void FleeingMovementGenerator<T>::_setTargetLocation(T& owner)
 
     owner.addUnitState(UNIT_STAT_FLEEING_MOVE);
 
-    PathFinder path(&owner);
-    path.setPathLengthLimit(30.0f);
-    path.calculate(x, y, z);
-    if (path.getPathType() & PATHFIND_NOPATH)
+    if (!i_path)
+    {
+        i_path = new PathFinder(&owner);
+        i_path->setPathLengthLimit(30.0f);
+    }
+
+    i_path->calculateAsync(x, y, z);
+    if (i_path->isPending())
+    {
+        // Path is built at the end of this map update, follow it on the next one
+        i_waitingForPath = true;
+        return;
+    }
+
+    _moveAlongPath(owner);
+}
+
+/**
+ * @brief Launches the movement along the last calculated path.
+ * @param owner Reference to the unit.
+ */
+template<class T>
+void FleeingMovementGenerator<T>::_moveAlongPath(T& owner)
+{
+    i_waitingForPath = false;
+
+    if (i_path->getPathType() & PATHFIND_NOPATH)
     {
         // Path not found, recheck later
         i_nextCheckTime.Reset(50);
@@ -68,7 +91,7 @@ void FleeingMovementGenerator<T>::_setTargetLocation(T& owner)
     }
 
     Movement::MoveSplineInit init(owner);
-    init.MovebyPath(path.getPath());
+    init.MovebyPath(i_path->getPath());
     init.SetWalk(false);
     int32 traveltime = init.Launch();
     i_nextCheckTime.Reset(traveltime + urand(800, 1500));
@@ -233,6 +256,15 @@ bool FleeingMovementGenerator<T>::Update(T& owner, const uint32& time_diff)
         return true;
     }
 
+    if (i_waitingForPath)
+    {
+        if (!i_path->isPending())
+        {
+            _moveAlongPath(owner);
+        }
+        return true;
+    }
+
     i_nextCheckTime.Update(time_diff);
     if (i_nextCheckTime.Passed() && owner.movespline->Finalized())
     {
@@ -249,6 +281,8 @@ template bool FleeingMovementGenerator<Player>::_getPoint(Player&, float&, float
 template bool FleeingMovementGenerator<Creature>::_getPoint(Creature&, float&, float&, float&);
 template void FleeingMovementGenerator<Player>::_setTargetLocation(Player&);
 template void FleeingMovementGenerator<Creature>::_setTargetLocation(Creature&);
+template void FleeingMovementGenerator<Player>::_moveAlongPath(Player&);
+template void FleeingMovementGenerator<Creature>::_moveAlongPath(Creature&);
 template void FleeingMovementGenerator<Player>::Interrupt(Player&);
 template void FleeingMovementGenerator<Creature>::Interrupt(Creature&);
 template void FleeingMovementGenerator<Player>::Reset(Player&);
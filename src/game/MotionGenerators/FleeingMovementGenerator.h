@@ -27,6 +27,7 @@
 
 #include "MovementGenerator.h"
 #include "ObjectGuid.h"
+#include "PathFinder.h"
 
 /**
  * @brief FleeingMovementGenerator is a movement generator that makes a unit flee from a specified target.
@@ -40,7 +41,12 @@ class FleeingMovementGenerator
          * @brief Constructor for FleeingMovementGenerator.
          * @param fright The GUID of the target to flee from.
          */
-        FleeingMovementGenerator(ObjectGuid fright) : i_frightGuid(fright), i_nextCheckTime(0) {}
+        FleeingMovementGenerator(ObjectGuid fright) : i_frightGuid(fright), i_nextCheckTime(0), i_path(NULL), i_waitingForPath(false) {}
+
+        /**
+         * @brief Destructor for FleeingMovementGenerator.
+         */
+        ~FleeingMovementGenerator() { delete i_path; }
 
         /**
          * @brief Initializes the movement generator.
@@ -87,6 +93,12 @@ class FleeingMovementGenerator
          */
         void _setTargetLocation(T& owner);
 
+        /**
+         * @brief Launches the movement along the last calculated path.
+         * @param owner Reference to the unit.
+         */
+        void _moveAlongPath(T& owner);
+
         /**
          * @brief Gets a point for the unit to flee to.
          * @param owner Reference to the unit.
@@ -99,6 +111,8 @@ class FleeingMovementGenerator
 
         ObjectGuid i_frightGuid; ///< The GUID of the target to flee from.
         TimeTracker i_nextCheckTime; ///< Time tracker for the next check.
+        PathFinder* i_path; ///< Path to the flee point, reused between checks.
+        bool i_waitingForPath; ///< Whether a path request is queued on the map.
 };
 
 /**
@@ -0,0 +1,188 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "PathCache.h"
+
+#include "../recastnavigation/Detour/Include/DetourCommon.h"
+
+#include <ace/Guard_T.h>
+
+// a cached point path is reused when both ends are within a yard of the requested ones
+#define PATH_CACHE_POINT_TOLERANCE_SQ 1.0f
+
+PathCache::PathCache(uint32 maxEntries) : m_maxEntries(maxEntries), m_generation(0), m_hits(0), m_misses(0)
+{
+}
+
+bool PathCache::FindCorridor(const PathCacheKey& key, uint32 generation, dtPolyRef* polyRefs, uint32& polyLength)
+{
+    if (!m_maxEntries)
+    {
+        return false;
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, false);
+
+    CheckGeneration(generation);
+
+    Entry* entry = Lookup(key);
+    if (!entry)
+    {
+        ++m_misses;
+        return false;
+    }
+
+    polyLength = entry->polyLength;
+    memcpy(polyRefs, entry->polyRefs, polyLength * sizeof(dtPolyRef));
+
+    ++m_hits;
+    return true;
+}
+
+void PathCache::StoreCorridor(const PathCacheKey& key, uint32 generation, const dtPolyRef* polyRefs, uint32 polyLength)
+{
+    if (!m_maxEntries)
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    CheckGeneration(generation);
+
+    Entry& entry = Insert(key);
+    entry.polyLength = polyLength;
+    memcpy(entry.polyRefs, polyRefs, polyLength * sizeof(dtPolyRef));
+    entry.pointCount = 0;
+}
+
+bool PathCache::FindPointPath(const PathCacheKey& key, uint32 generation, const dtPolyRef* polyRefs, uint32 polyLength,
+                              bool straightPath, uint32 pointPathLimit, const float* startPoint, const float* endPoint,
+                              float* points, uint32& pointCount)
+{
+    if (!m_maxEntries)
+    {
+        return false;
+    }
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, false);
+
+    CheckGeneration(generation);
+
+    Entry* entry = Lookup(key);
+    if (!entry || !entry->pointCount || entry->straightPath != straightPath || entry->pointPathLimit != pointPathLimit ||
+        entry->polyLength != polyLength || memcmp(entry->polyRefs, polyRefs, polyLength * sizeof(dtPolyRef)) != 0 ||
+        dtVdistSqr(entry->startPoint, startPoint) > PATH_CACHE_POINT_TOLERANCE_SQ ||
+        dtVdistSqr(entry->endPoint, endPoint) > PATH_CACHE_POINT_TOLERANCE_SQ)
+    {
+        ++m_misses;
+        return false;
+    }
+
+    pointCount = entry->pointCount;
+    memcpy(points, entry->points, pointCount * VERTEX_SIZE * sizeof(float));
+
+    // the path starts where we are and ends where we go, not where the cached one did
+    dtVcopy(points, startPoint);
+    dtVcopy(&points[(pointCount - 1) * VERTEX_SIZE], endPoint);
+
+    ++m_hits;
+    return true;
+}
+
+void PathCache::StorePointPath(const PathCacheKey& key, uint32 generation, const dtPolyRef* polyRefs, uint32 polyLength,
+                               bool straightPath, uint32 pointPathLimit, const float* startPoint, const float* endPoint,
+                               const float* points, uint32 pointCount)
+{
+    if (!m_maxEntries)
+    {
+        return;
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    CheckGeneration(generation);
+
+    Entry& entry = Insert(key);
+    entry.polyLength = polyLength;
+    memcpy(entry.polyRefs, polyRefs, polyLength * sizeof(dtPolyRef));
+
+    entry.pointCount = pointCount;
+    memcpy(entry.points, points, pointCount * VERTEX_SIZE * sizeof(float));
+    entry.pointPathLimit = pointPathLimit;
+    entry.straightPath = straightPath;
+    dtVcopy(entry.startPoint, startPoint);
+    dtVcopy(entry.endPoint, endPoint);
+}
+
+size_t PathCache::GetSize()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, 0);
+
+    return m_index.size();
+}
+
+void PathCache::CheckGeneration(uint32 generation)
+{
+    if (generation == m_generation)
+    {
+        return;
+    }
+
+    // poly refs of reloaded tiles are not valid anymore, and new tiles may give better paths
+    m_index.clear();
+    m_entries.clear();
+    m_generation = generation;
+}
+
+PathCache::Entry* PathCache::Lookup(const PathCacheKey& key)
+{
+    EntryMap::iterator itr = m_index.find(key);
+    if (itr == m_index.end())
+    {
+        return NULL;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    return &itr->second->second;
+}
+
+PathCache::Entry& PathCache::Insert(const PathCacheKey& key)
+{
+    if (Entry* entry = Lookup(key))
+    {
+        return *entry;
+    }
+
+    if (m_index.size() >= m_maxEntries)
+    {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+
+    m_entries.push_front(std::make_pair(key, Entry()));
+    m_index[key] = m_entries.begin();
+    return m_entries.front().second;
+}
@@ -0,0 +1,144 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_PATHCACHE_H
+#define MANGOS_PATHCACHE_H
+
+#include "Common.h"
+#include "PathFinder.h"
+
+#include <ace/Thread_Mutex.h>
+
+#include <list>
+#include <unordered_map>
+
+/**
+ * @brief Everything a detour corridor depends on.
+ */
+struct PathCacheKey
+{
+    PathCacheKey(dtPolyRef start, dtPolyRef end, uint16 include, uint16 exclude)
+        : startPoly(start), endPoly(end), includeFlags(include), excludeFlags(exclude) {}
+
+    bool operator==(const PathCacheKey& other) const
+    {
+        return startPoly == other.startPoly && endPoly == other.endPoly &&
+               includeFlags == other.includeFlags && excludeFlags == other.excludeFlags;
+    }
+
+    dtPolyRef startPoly;
+    dtPolyRef endPoly;
+    uint16 includeFlags;
+    uint16 excludeFlags;
+};
+
+struct PathCacheKeyHash
+{
+    size_t operator()(const PathCacheKey& key) const
+    {
+        uint64 hash = uint64(key.startPoly) * UI64LIT(0x9E3779B97F4A7C15) ^ uint64(key.endPoly);
+        hash ^= (uint64(key.includeFlags) << 48) | (uint64(key.excludeFlags) << 32);
+        return size_t(hash ^ (hash >> 29));
+    }
+};
+
+/**
+ * @brief Bounded cache of the corridors and point paths built on one map.
+ *
+ * Patrols, evading units walking home and pets following their owner ask for
+ * the same paths over and over. A fresh corridor between two polygons is looked
+ * up here before running findPath, and the point path built along a corridor is
+ * reused when the start and end points are close to the cached ones.
+ *
+ * The least recently used entry is dropped when the cache is full, and the whole
+ * cache is flushed when a navmesh tile of the map is loaded or unloaded (see
+ * MMapManager::GetTileGeneration). May be used by the path threads concurrently.
+ */
+class PathCache
+{
+    public:
+
+        explicit PathCache(uint32 maxEntries);
+
+        /// Copy the cached corridor of the key, returns false on a miss
+        bool FindCorridor(const PathCacheKey& key, uint32 generation, dtPolyRef* polyRefs, uint32& polyLength);
+
+        /// Remember a corridor built by findPath, the point path of the key is dropped
+        void StoreCorridor(const PathCacheKey& key, uint32 generation, const dtPolyRef* polyRefs, uint32 polyLength);
+
+        /// Copy the cached point path along the same corridor with the same options, its ends moved to startPoint and endPoint; returns false on a miss
+        bool FindPointPath(const PathCacheKey& key, uint32 generation, const dtPolyRef* polyRefs, uint32 polyLength,
+                           bool straightPath, uint32 pointPathLimit, const float* startPoint, const float* endPoint,
+                           float* points, uint32& pointCount);
+
+        /// Remember a point path and the corridor it was built along
+        void StorePointPath(const PathCacheKey& key, uint32 generation, const dtPolyRef* polyRefs, uint32 polyLength,
+                            bool straightPath, uint32 pointPathLimit, const float* startPoint, const float* endPoint,
+                            const float* points, uint32 pointCount);
+
+        size_t GetSize();
+        uint64 GetHits() const { return m_hits; }
+        uint64 GetMisses() const { return m_misses; }
+
+    private:
+
+        struct Entry
+        {
+            dtPolyRef polyRefs[MAX_PATH_LENGTH];
+            uint32 polyLength;
+
+            // point path along the corridor, pointCount is 0 when none was built yet
+            float points[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
+            uint32 pointCount;
+            uint32 pointPathLimit;
+            bool straightPath;
+            float startPoint[VERTEX_SIZE];
+            float endPoint[VERTEX_SIZE];
+        };
+
+        typedef std::list<std::pair<PathCacheKey, Entry> > EntryList;
+        typedef std::unordered_map<PathCacheKey, EntryList::iterator, PathCacheKeyHash> EntryMap;
+
+        /// Flush the cache if the tiles changed since the entries were built, must hold m_mutex
+        void CheckGeneration(uint32 generation);
+
+        /// Find the entry and mark it as recently used, must hold m_mutex
+        Entry* Lookup(const PathCacheKey& key);
+
+        /// Find or add the entry and mark it as recently used, must hold m_mutex
+        Entry& Insert(const PathCacheKey& key);
+
+        uint32 m_maxEntries;
+        uint32 m_generation;
+
+        ACE_Thread_Mutex m_mutex;
+        EntryList m_entries;        // most recently used first
+        EntryMap m_index;
+
+        uint64 m_hits;
+        uint64 m_misses;
+};
+
+#endif
@@ -28,6 +28,9 @@
 #include "GridMap.h"
 #include "Creature.h"
 #include "PathFinder.h"
+#include "PathRequestQueue.h"
+#include "PathCache.h"
+#include "MapManager.h"
 #include "Log.h"
 
 ////////////////// PathFinder //////////////////
@@ -39,7 +42,7 @@
 PathFinder::PathFinder(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL)
+    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL), m_requestQueue(NULL)
 {
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
@@ -60,6 +63,11 @@ PathFinder::PathFinder(const Unit* owner) :
 PathFinder::~PathFinder()
 {
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+
+    if (m_requestQueue)
+    {
+        m_requestQueue->Remove(this);
+    }
 }
 
 /**
@@ -72,8 +80,70 @@ PathFinder::~PathFinder()
  */
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
 {
-    // Vector3 oldDest = getEndPosition();
-    Vector3 dest(destX, destY, destZ);
+    // a queued request would overwrite the results later on
+    if (m_requestQueue)
+    {
+        m_requestQueue->Remove(this);
+    }
+
+    if (initCalculation(Vector3(destX, destY, destZ), forceDest))
+    {
+        // the cell regions of the map are updated concurrently, each one has its own query
+        if (MapUpdateRegion* region = m_sourceUnit->GetMap()->GetCurrentUpdateRegion())
+        {
+            if (region->navMeshQuery)
+            {
+                buildPath(region->navMeshQuery);
+            }
+            else
+            {
+                BuildShortcut();
+                m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+            }
+        }
+        else
+        {
+            BuildPolyPath(getStartPosition(), getEndPosition());
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Queues the path calculation to the map of the source unit.
+ * @param destX The X-coordinate of the destination.
+ * @param destY The Y-coordinate of the destination.
+ * @param destZ The Z-coordinate of the destination.
+ * @param forceDest Whether to force the destination.
+ */
+void PathFinder::calculateAsync(float destX, float destY, float destZ, bool forceDest)
+{
+    if (!sMapMgr.GetPathRequestUpdater() || !m_navMeshQuery)
+    {
+        calculate(destX, destY, destZ, forceDest);
+        return;
+    }
+
+    // the start position is taken when the request is processed, a queued request just gets the new destination
+    setEndPosition(Vector3(destX, destY, destZ));
+    m_forceDestination = forceDest;
+
+    if (!m_requestQueue)
+    {
+        m_requestQueue = &m_sourceUnit->GetMap()->GetPathRequests();
+        m_requestQueue->Add(this);
+    }
+}
+
+/**
+ * @brief Sets up a new calculation and handles the cases needing no poly path.
+ * @param dest The destination.
+ * @param forceDest Whether to force the destination.
+ * @return True if the poly path has to be built.
+ */
+bool PathFinder::initCalculation(const Vector3& dest, bool forceDest)
+{
     setEndPosition(dest);
 
     float x, y, z;
@@ -92,15 +162,100 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
+        return false;
     }
 
     updateFilter();
-
-    BuildPolyPath(start, dest);
     return true;
 }
 
+/**
+ * @brief Builds the path of an initialized calculation, may be called from a path thread.
+ * @param query The navigation mesh query to use.
+ */
+void PathFinder::buildPath(const dtNavMeshQuery* query)
+{
+    const dtNavMesh* navMesh = m_navMesh;
+    const dtNavMeshQuery* navMeshQuery = m_navMeshQuery;
+
+    m_navMeshQuery = query;
+    m_navMesh = query->getAttachedNavMesh();
+
+    BuildPolyPath(getStartPosition(), getEndPosition());
+
+    m_navMesh = navMesh;
+    m_navMeshQuery = navMeshQuery;
+}
+
+/**
+ * @brief Hashes the inputs of an initialized calculation.
+ * @return The hash.
+ */
+uint32 PathFinder::getRequestHash() const
+{
+    const float values[6] = { m_startPosition.x, m_startPosition.y, m_startPosition.z, m_endPosition.x, m_endPosition.y, m_endPosition.z };
+
+    uint32 hash = 2166136261U;
+    const uint8* bytes = reinterpret_cast<const uint8*>(values);
+    for (size_t i = 0; i < sizeof(values); ++i)
+    {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+
+    return hash ^ m_polyLength;
+}
+
+/**
+ * @brief Checks if the other request has exactly the same inputs.
+ * @param other The other path.
+ * @return True if both would build the same path.
+ */
+bool PathFinder::isSameRequest(const PathFinder& other) const
+{
+    if (m_startPosition != other.m_startPosition || m_endPosition != other.m_endPosition ||
+        m_forceDestination != other.m_forceDestination || m_useStraightPath != other.m_useStraightPath ||
+        m_pointPathLimit != other.m_pointPathLimit || m_navMesh != other.m_navMesh ||
+        m_filter.getIncludeFlags() != other.m_filter.getIncludeFlags() ||
+        m_filter.getExcludeFlags() != other.m_filter.getExcludeFlags())
+    {
+        return false;
+    }
+
+    // the fallbacks of BuildPolyPath depend on the kind of unit
+    if (m_sourceUnit->GetTypeId() != other.m_sourceUnit->GetTypeId())
+    {
+        return false;
+    }
+
+    if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+    {
+        const Creature* creature = (const Creature*)m_sourceUnit;
+        const Creature* otherCreature = (const Creature*)other.m_sourceUnit;
+        if (creature->CanFly() != otherCreature->CanFly() || creature->CanSwim() != otherCreature->CanSwim())
+        {
+            return false;
+        }
+    }
+
+    // the old poly path is reused when the new one overlaps it
+    return m_polyLength == other.m_polyLength &&
+           memcmp(m_pathPolyRefs, other.m_pathPolyRefs, m_polyLength * sizeof(dtPolyRef)) == 0;
+}
+
+/**
+ * @brief Copies the results of an identical request.
+ * @param other The built path.
+ */
+void PathFinder::copyResults(const PathFinder& other)
+{
+    m_polyLength = other.m_polyLength;
+    memcpy(m_pathPolyRefs, other.m_pathPolyRefs, m_polyLength * sizeof(dtPolyRef));
+
+    m_pathPoints = other.m_pathPoints;
+    m_type = other.m_type;
+    m_actualEndPosition = other.m_actualEndPosition;
+}
+
 /**
  * @brief Gets the nearest polygon reference by position.
  * @param polyPath The polygon path.
@@ -427,23 +582,36 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
-                       startPoly,          // start polygon
-                       endPoly,            // end polygon
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       &m_filter,           // polygon search filter
-                       m_pathPolyRefs,     // [out] path
-                       (int*)&m_polyLength,
-                       MAX_PATH_LENGTH);   // max number of polygons in output path
+        // patrols and units going home ask for the same corridors again and again
+        uint32 cacheGeneration = 0;
+        PathCache* cache = getPathCache(cacheGeneration);
+        PathCacheKey cacheKey(startPoly, endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags());
 
-        if (!m_polyLength || dtStatusFailed(dtResult))
+        if (!cache || !cache->FindCorridor(cacheKey, cacheGeneration, m_pathPolyRefs, m_polyLength))
         {
-            // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
-            BuildShortcut();
-            m_type = PATHFIND_NOPATH;
-            return;
+            dtResult = m_navMeshQuery->findPath(
+                           startPoly,          // start polygon
+                           endPoly,            // end polygon
+                           startPoint,         // start position
+                           endPoint,           // end position
+                           &m_filter,           // polygon search filter
+                           m_pathPolyRefs,     // [out] path
+                           (int*)&m_polyLength,
+                           MAX_PATH_LENGTH);   // max number of polygons in output path
+
+            if (!m_polyLength || dtStatusFailed(dtResult))
+            {
+                // only happens if we passed bad data to findPath(), or navmesh is messed up
+                sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+                BuildShortcut();
+                m_type = PATHFIND_NOPATH;
+                return;
+            }
+
+            if (cache)
+            {
+                cache->StoreCorridor(cacheKey, cacheGeneration, m_pathPolyRefs, m_polyLength);
+            }
         }
     }
 
@@ -458,42 +626,62 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     }
 
     // generate the point-path out of our up-to-date poly-path
-    BuildPointPath(startPoint, endPoint);
+    BuildPointPath(startPoint, endPoint, endPoly);
 }
 
 /**
  * @brief Builds the point path from the start point to the end point.
  * @param startPoint The start point.
  * @param endPoint The end point.
+ * @param endPoly The polygon of the end point.
  */
-void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
+void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint, dtPolyRef endPoly)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
     uint32 pointCount = 0;
     dtStatus dtResult = DT_FAILURE;
-    if (m_useStraightPath)
+
+    uint32 cacheGeneration = 0;
+    PathCache* cache = getPathCache(cacheGeneration);
+    PathCacheKey cacheKey(m_pathPolyRefs[0], endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags());
+
+    if (cache && cache->FindPointPath(cacheKey, cacheGeneration, m_pathPolyRefs, m_polyLength, m_useStraightPath, m_pointPathLimit,
+                                      startPoint, endPoint, pathPoints, pointCount))
     {
-        dtResult = m_navMeshQuery->findStraightPath(
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       m_pathPolyRefs,     // current path
-                       m_polyLength,       // length of current path
-                       pathPoints,         // [out] path corner points
-                       NULL,               // [out] flags
-                       NULL,               // [out] shortened path
-                       (int*)&pointCount,
-                       m_pointPathLimit);   // maximum number of points/polygons to use
+        dtResult = DT_SUCCESS;
     }
     else
     {
-        dtResult = findSmoothPath(
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       m_pathPolyRefs,     // current path
-                       m_polyLength,       // length of current path
-                       pathPoints,         // [out] path corner points
-                       (int*)&pointCount,
-                       m_pointPathLimit);    // maximum number of points
+        if (m_useStraightPath)
+        {
+            dtResult = m_navMeshQuery->findStraightPath(
+                           startPoint,         // start position
+                           endPoint,           // end position
+                           m_pathPolyRefs,     // current path
+                           m_polyLength,       // length of current path
+                           pathPoints,         // [out] path corner points
+                           NULL,               // [out] flags
+                           NULL,               // [out] shortened path
+                           (int*)&pointCount,
+                           m_pointPathLimit);   // maximum number of points/polygons to use
+        }
+        else
+        {
+            dtResult = findSmoothPath(
+                           startPoint,         // start position
+                           endPoint,           // end position
+                           m_pathPolyRefs,     // current path
+                           m_polyLength,       // length of current path
+                           pathPoints,         // [out] path corner points
+                           (int*)&pointCount,
+                           m_pointPathLimit);    // maximum number of points
+        }
+
+        if (cache && pointCount >= 2 && dtStatusSucceed(dtResult))
+        {
+            cache->StorePointPath(cacheKey, cacheGeneration, m_pathPolyRefs, m_polyLength, m_useStraightPath, m_pointPathLimit,
+                                  startPoint, endPoint, pathPoints, pointCount);
+        }
     }
 
     if (pointCount < 2 || dtStatusFailed(dtResult))
@@ -539,6 +727,22 @@ void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
     DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::BuildPointPath path type %d size %d poly-size %d\n", m_type, pointCount, m_polyLength);
 }
 
+/**
+ * @brief Gets the path cache of the map of the source unit.
+ * @param generation The tile generation of the navmesh.
+ * @return The cache, NULL if disabled.
+ */
+PathCache* PathFinder::getPathCache(uint32& generation) const
+{
+    PathCache* cache = m_sourceUnit->GetMap()->GetPathCache();
+    if (cache)
+    {
+        generation = MMAP::MMapFactory::createOrGetMMapManager()->GetTileGeneration(m_sourceUnit->GetMapId());
+    }
+
+    return cache;
+}
+
 /**
  * @brief Builds a shortcut path directly from the start position to the end position.
  */
@@ -943,9 +1147,24 @@ float PathFinder::dist3DSqr(const Vector3& p1, const Vector3& p2) const
 
 void PathFinder::NormalizePath(uint32& size)
 {
-    for (uint32 i = 0; i < m_pathPoints.size(); ++i)
+    // the terrain heights of all points are looked up together
+    uint32 count = m_pathPoints.size();
+    if (count)
     {
-        m_sourceUnit->UpdateAllowedPositionZ(m_pathPoints[i].x, m_pathPoints[i].y, m_pathPoints[i].z);
+        std::vector<float> x(count), y(count), z(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            x[i] = m_pathPoints[i].x;
+            y[i] = m_pathPoints[i].y;
+            z[i] = m_pathPoints[i].z;
+        }
+
+        m_sourceUnit->UpdateAllowedPositionZ(count, &x[0], &y[0], &z[0]);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            m_pathPoints[i].z = z[i];
+        }
     }
 
     // check if the Z difference between each point is higher than SMOOTH_PATH_HEIGHT.
@@ -35,6 +35,8 @@ using Movement::Vector3;
 using Movement::PointsArray;
 
 class Unit;
+class PathRequestQueue;
+class PathCache;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -89,6 +91,23 @@ class PathFinder
          */
         bool calculate(float destX, float destY, float destZ, bool forceDest = false);
 
+        /**
+         * @brief Queue the path calculation to the owner's map, built at the end of its update.
+         *
+         * Without path threads (see MapUpdatePathThreads) the path is calculated right away.
+         * @param destX X-coordinate of the destination.
+         * @param destY Y-coordinate of the destination.
+         * @param destZ Z-coordinate of the destination.
+         * @param forceDest Whether to force the destination.
+         */
+        void calculateAsync(float destX, float destY, float destZ, bool forceDest = false);
+
+        /**
+         * @brief Check if a queued calculation is not done yet, the results are those of the previous one meanwhile.
+         * @return True while the request is queued.
+         */
+        bool isPending() const { return m_requestQueue != NULL; }
+
         // Option setters - use optional
         /**
          * @brief Set whether to use a straight path.
@@ -136,6 +155,9 @@ class PathFinder
 
     private:
 
+        friend class PathRequestQueue;
+        friend class PathRequestUpdater;
+
         dtPolyRef      m_pathPolyRefs[MAX_PATH_LENGTH];   // Array of detour polygon references
         uint32         m_polyLength;                      // Number of polygons in the path
 
@@ -156,6 +178,41 @@ class PathFinder
 
         dtQueryFilter m_filter;                     // Use a single filter for all movements, update it when needed
 
+        PathRequestQueue* m_requestQueue;           // Queue holding our request, NULL when the results are available
+
+        /**
+         * @brief Set the positions of a new calculation and build the path if it needs no poly path.
+         * @param dest The destination.
+         * @param forceDest Whether to force the destination.
+         * @return True if the poly path still has to be built.
+         */
+        bool initCalculation(const Vector3& dest, bool forceDest);
+
+        /**
+         * @brief Build the poly and point path of an initialized calculation with the given query.
+         * @param query The navigation mesh query to use, owned by the calling thread.
+         */
+        void buildPath(const dtNavMeshQuery* query);
+
+        /**
+         * @brief Hash of everything the built path depends on, see isSameRequest.
+         * @return The hash.
+         */
+        uint32 getRequestHash() const;
+
+        /**
+         * @brief Check if building the path of the other request gives the same results.
+         * @param other The other path.
+         * @return True if the requests are identical.
+         */
+        bool isSameRequest(const PathFinder& other) const;
+
+        /**
+         * @brief Take over the results of an identical request.
+         * @param other The path built for it.
+         */
+        void copyResults(const PathFinder& other);
+
         /**
          * @brief Set the start position of the path.
          * @param point The start position.
@@ -247,8 +304,16 @@ class PathFinder
          * @brief Build the point path.
          * @param startPoint The start point.
          * @param endPoint The end point.
+         * @param endPoly The polygon of the end point, the corridor may stop short of it.
+         */
+        void BuildPointPath(const float* startPoint, const float* endPoint, dtPolyRef endPoly);
+
+        /**
+         * @brief Get the path cache of the map of the source unit.
+         * @param generation [out] The tile generation of the navmesh, see MMapManager::GetTileGeneration.
+         * @return The cache, NULL if disabled.
          */
-        void BuildPointPath(const float* startPoint, const float* endPoint);
+        PathCache* getPathCache(uint32& generation) const;
 
         /**
          * @brief Build a shortcut path.
@@ -0,0 +1,226 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "PathRequestQueue.h"
+#include "PathFinder.h"
+#include "MoveMap.h"
+#include "MapManager.h"
+#include "Map.h"
+#include "Unit.h"
+
+#include <ace/Guard_T.h>
+
+#include <unordered_map>
+
+// -----------------------------------  PathRequestUpdater  ------------------------------------ //
+
+PathRequestUpdater::PathRequestUpdater() : m_numThreads(0)
+{
+}
+
+PathRequestUpdater::~PathRequestUpdater()
+{
+    deactivate();
+}
+
+int PathRequestUpdater::activate(size_t num_threads)
+{
+    if (m_executor.activate(int(num_threads)) == -1)
+    {
+        return -1;
+    }
+
+    m_numThreads = num_threads;
+    return 0;
+}
+
+int PathRequestUpdater::deactivate()
+{
+    m_numThreads = 0;
+    return m_executor.deactivate();
+}
+
+bool PathRequestUpdater::activated()
+{
+    return m_executor.activated();
+}
+
+void PathRequestUpdater::BuildPaths(std::vector<PathFinder*> const& paths, std::vector<dtNavMeshQuery const*> const& queries)
+{
+    if (paths.empty() || queries.empty())
+    {
+        return;
+    }
+
+    // the map thread builds the first part instead of idling until the workers are done
+    m_executor.execute_slices(queries.size(), [&paths, &queries](size_t part)
+    {
+        // interleaved, so long and short paths spread over all parts
+        for (size_t i = part; i < paths.size(); i += queries.size())
+        {
+            paths[i]->buildPath(queries[part]);
+        }
+    });
+}
+
+// -----------------------------------  PathRequestQueue  -------------------------------------- //
+
+PathRequestQueue::PathRequestQueue(Map& map) : m_map(map)
+{
+}
+
+PathRequestQueue::~PathRequestQueue()
+{
+    for (std::vector<PathFinder*>::iterator itr = m_requests.begin(); itr != m_requests.end(); ++itr)
+    {
+        (*itr)->m_requestQueue = NULL;
+    }
+}
+
+void PathRequestQueue::Add(PathFinder* path)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+    m_requests.push_back(path);
+}
+
+void PathRequestQueue::Remove(PathFinder* path)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    std::vector<PathFinder*>::iterator itr = std::find(m_requests.begin(), m_requests.end(), path);
+    if (itr != m_requests.end())
+    {
+        m_requests.erase(itr);
+    }
+
+    path->m_requestQueue = NULL;
+}
+
+void PathRequestQueue::Process()
+{
+    std::vector<PathFinder*> requests;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+        requests.swap(m_requests);
+    }
+
+    if (requests.empty())
+    {
+        return;
+    }
+
+    std::vector<PathFinder*> paths;                                 // distinct requests, to be built
+    std::vector<std::pair<PathFinder*, PathFinder*> > copies;       // identical request, path built for it
+    std::unordered_multimap<uint32, PathFinder*> pathsByHash;
+
+    for (std::vector<PathFinder*>::iterator itr = requests.begin(); itr != requests.end(); ++itr)
+    {
+        PathFinder* path = *itr;
+        path->m_requestQueue = NULL;
+
+        // the owner left the map since the request, the generator has to ask again
+        if (!path->m_sourceUnit->IsInWorld() || path->m_sourceUnit->GetMap() != &m_map)
+        {
+            path->m_type = PATHFIND_NOPATH;
+            continue;
+        }
+
+        // starts at the current position, the owner may have moved since the request
+        Vector3 dest = path->getEndPosition();
+        if (!path->initCalculation(dest, path->m_forceDestination))
+        {
+            continue;
+        }
+
+        uint32 hash = path->getRequestHash();
+        PathFinder* builtPath = NULL;
+
+        std::pair<std::unordered_multimap<uint32, PathFinder*>::const_iterator, std::unordered_multimap<uint32, PathFinder*>::const_iterator> range = pathsByHash.equal_range(hash);
+        for (std::unordered_multimap<uint32, PathFinder*>::const_iterator same = range.first; same != range.second; ++same)
+        {
+            if (same->second->isSameRequest(*path))
+            {
+                builtPath = same->second;
+                break;
+            }
+        }
+
+        if (builtPath)
+        {
+            copies.push_back(std::make_pair(path, builtPath));
+        }
+        else
+        {
+            pathsByHash.insert(std::make_pair(hash, path));
+            paths.push_back(path);
+        }
+    }
+
+    if (!paths.empty())
+    {
+        PathRequestUpdater* updater = sMapMgr.GetPathRequestUpdater();
+        size_t numParts = updater ? std::min(updater->GetNumThreads() + 1, paths.size()) : 1;
+
+        // one query per part, the first one is the query of the map instance used by the map thread anyway
+        MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+        std::vector<dtNavMeshQuery const*> queries;
+        for (size_t i = 0; i < numParts; ++i)
+        {
+            dtNavMeshQuery const* query = mmap->GetNavMeshQuery(m_map.GetId(), m_map.GetInstanceId(), uint32(i));
+            if (!query)
+            {
+                break;
+            }
+
+            queries.push_back(query);
+        }
+
+        if (queries.empty())
+        {
+            // the navmesh is gone, only a shortcut is left
+            for (std::vector<PathFinder*>::iterator itr = paths.begin(); itr != paths.end(); ++itr)
+            {
+                (*itr)->BuildShortcut();
+                (*itr)->m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+            }
+        }
+        else if (queries.size() == 1)
+        {
+            for (std::vector<PathFinder*>::iterator itr = paths.begin(); itr != paths.end(); ++itr)
+            {
+                (*itr)->buildPath(queries[0]);
+            }
+        }
+        else
+        {
+            updater->BuildPaths(paths, queries);
+        }
+    }
+
+    for (std::vector<std::pair<PathFinder*, PathFinder*> >::const_iterator itr = copies.begin(); itr != copies.end(); ++itr)
+    {
+        itr->first->copyResults(*itr->second);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_PATHREQUESTQUEUE_H
+#define MANGOS_PATHREQUESTQUEUE_H
+
+#include "Common.h"
+#include "Threading/DelayExecutor.h"
+
+#include <ace/Thread_Mutex.h>
+
+class Map;
+class PathFinder;
+class dtNavMeshQuery;
+
+/**
+ * @brief Worker threads building the queued paths of the maps.
+ *
+ * A single pool is shared by all maps. dtNavMeshQuery is not thread safe, so every
+ * part of a batch is built with its own query. The map thread processing the batch
+ * builds the first part itself and returns once all parts are done.
+ */
+class PathRequestUpdater
+{
+    public:
+
+        PathRequestUpdater();
+        ~PathRequestUpdater();
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated();
+
+        size_t GetNumThreads() const { return m_numThreads; }
+
+        /// Build the paths split into one part per query, returns when every part is done
+        void BuildPaths(std::vector<PathFinder*> const& paths, std::vector<dtNavMeshQuery const*> const& queries);
+
+    private:
+
+        DelayExecutor m_executor;
+        size_t m_numThreads;
+};
+
+/**
+ * @brief Paths requested on one map, see PathFinder::calculateAsync.
+ *
+ * The paths are built at the end of Map::Update, when the units and navmesh tiles
+ * of the map do not change, and the movement generators pick up the results on their
+ * next update. A PathFinder is queued once, asking again only changes its destination.
+ * Identical requests of different units (adds spawned on the same spot chasing the
+ * same target) are built once.
+ */
+class PathRequestQueue
+{
+    public:
+
+        explicit PathRequestQueue(Map& map);
+        ~PathRequestQueue();
+
+        /// Queue a path, may be called by the region update workers of the map
+        void Add(PathFinder* path);
+
+        /// Drop a queued path, e.g. when it is deleted before it was built
+        void Remove(PathFinder* path);
+
+        /// Build all queued paths, called by the map thread
+        void Process();
+
+    private:
+
+        Map& m_map;
+
+        ACE_Thread_Mutex m_mutex;
+        std::vector<PathFinder*> m_requests;
+};
+
+#endif
@@ -98,7 +98,29 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetTypeId() == TYPEID_UNIT && ((Creature*)&owner)->IsPet()
                       && owner.hasUnitState(UNIT_STAT_FOLLOW));
-    i_path->calculate(x, y, z, forceDest);
+    i_path->calculateAsync(x, y, z, forceDest);
+    if (i_path->isPending())
+    {
+        // built at the end of the map update, followed on the next one
+        i_waitingForPath = true;
+        return;
+    }
+
+    _moveAlongPath(owner);
+}
+
+/**
+ * @brief Start moving along the calculated path.
+ *
+ * @tparam T The type of the owner.
+ * @tparam D The type of the derived class.
+ * @param owner The owner.
+ */
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_moveAlongPath(T& owner)
+{
+    i_waitingForPath = false;
+
     if (i_path->getPathType() & PATHFIND_NOPATH)
     {
         return;
@@ -166,6 +188,11 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         return true;
     }
 
+    if (i_waitingForPath && !i_path->isPending())
+    {
+        _moveAlongPath(owner);
+    }
+
     bool targetMoved = false;
     i_recheckDistance.Update(time_diff);
     if (i_recheckDistance.Passed())
@@ -180,7 +207,8 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         _setTargetLocation(owner, targetMoved);
     }
 
-    if (owner.movespline->Finalized())
+    // standing still while the path is built does not mean the target is reached
+    if (owner.movespline->Finalized() && !i_waitingForPath)
     {
         if (i_angle == 0.f && !owner.HasInArc(0.01f, i_target.getTarget()))
         {
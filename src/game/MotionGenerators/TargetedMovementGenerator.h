@@ -72,7 +72,7 @@ class TargetedMovementGeneratorMedium
             TargetedMovementGeneratorBase(target),
             i_recheckDistance(0),
             i_offset(offset), i_angle(angle),
-            m_speedChanged(false), i_targetReached(false),
+            m_speedChanged(false), i_targetReached(false), i_waitingForPath(false),
             i_path(NULL)
         {
         }
@@ -116,6 +116,12 @@ class TargetedMovementGeneratorMedium
          */
         void _setTargetLocation(T&, bool updateDestination);
 
+        /**
+         * @brief Starts moving along the calculated path.
+         * @param owner Reference to the unit.
+         */
+        void _moveAlongPath(T& owner);
+
         /**
          * @brief Checks if a new position is required.
          * @param owner Reference to the unit.
@@ -139,6 +145,7 @@ class TargetedMovementGeneratorMedium
         float i_angle; ///< Angle to maintain from the target.
         bool m_speedChanged : 1; ///< Indicates if the speed has changed.
         bool i_targetReached : 1; ///< Indicates if the target has been reached.
+        bool i_waitingForPath : 1; ///< Indicates if a queued path has to be followed once it is built.
 
         PathFinder* i_path; ///< Path finder for the movement.
 };
@@ -23,6 +23,7 @@
  */
 
 #include "WorldPacket.h"
+#include "SharedPacket.h"
 #include "ObjectMgr.h"
 #include "ObjectGuid.h"
 #include "ArenaTeam.h"
@@ -542,12 +543,14 @@ void ArenaTeam::SetStats(uint32 stat_type, uint32 value)
 
 void ArenaTeam::BroadcastPacket(WorldPacket* packet)
 {
+    SharedPacket shared(*packet);
+
     for (MemberList::const_iterator itr = m_members.begin(); itr != m_members.end(); ++itr)
     {
         Player* player = sObjectMgr.GetPlayer(itr->guid);
         if (player)
         {
-            player->GetSession()->SendPacket(packet);
+            player->GetSession()->SendPacket(shared);
         }
     }
 }
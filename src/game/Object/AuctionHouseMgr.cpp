@@ -177,9 +177,7 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
         msgAuctionWonBody << std::dec << ":" << auction->bid << ":" << auction->buyout;
         DEBUG_LOG("AuctionWon body string : %s", msgAuctionWonBody.str().c_str());
 
-        // set owner to bidder (to prevent delete item with sender char deleting)
-        // owner in `data` will set at mail receive and item extracting
-        CharacterDatabase.PExecute("UPDATE `item_instance` SET `owner_guid` = '%u' WHERE `guid`='%u'", auction->bidder, auction->itemGuidLow);
+        // the owner of the item is set to the bidder by SendMailTo, in the transaction of the mail
 
         if (bidder)
         {
@@ -221,6 +219,9 @@ void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction)
     // owner exist
     if (owner || owner_accId)
     {
+        // the money goes to the async connection of the owner, ordered with its later requests
+        SqlAsyncAffinity dbAffinity(owner ? owner->GetSession()->GetAccountId() : owner_accId);
+
         std::ostringstream msgAuctionSuccessfulSubject;
         msgAuctionSuccessfulSubject << auction->itemTemplate << ":" << auction->itemRandomPropertyId << ":" << AUCTION_SUCCESSFUL;
 
@@ -272,6 +273,9 @@ void AuctionHouseMgr::SendAuctionExpiredMail(AuctionEntry* auction)
     // owner exist
     if (owner || owner_accId)
     {
+        // the item goes back in the async connection of the owner, ordered with its later requests
+        SqlAsyncAffinity dbAffinity(owner ? owner->GetSession()->GetAccountId() : owner_accId);
+
         std::ostringstream subject;
         subject << auction->itemTemplate << ":" << auction->itemRandomPropertyId << ":" << AUCTION_EXPIRED << ":" << auction->Id << ":" << auction->itemCount;
 
@@ -618,49 +622,89 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
+void AuctionHouseObject::ScheduleAuction(AuctionEntry const* auction)
+{
+    ExpiryQueue.push(AuctionExpiry(GetAuctionDueTime(auction), auction->Id));
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
-    ///- Handle expired auctions
-    for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end();)
+    std::vector<uint32> deletedAuctions;
+
+    ///- Handle expired auctions, only the ones that came due are visited
+    while (!ExpiryQueue.empty() && curTime > ExpiryQueue.top().first)
     {
-        if (itr->second->moneyDeliveryTime)                 // pending auction
+        AuctionExpiry due = ExpiryQueue.top();
+        ExpiryQueue.pop();
+
+        AuctionEntryMap::iterator itr = AuctionsMap.find(due.second);
+        if (itr == AuctionsMap.end())                       // already removed
         {
-            if (curTime > itr->second->moneyDeliveryTime)
-            {
-                sAuctionMgr.SendAuctionSuccessfulMail(itr->second);
+            continue;
+        }
 
-                itr->second->DeleteFromDB();
-                MANGOS_ASSERT(!itr->second->itemGuidLow);   // already removed or send in mail at won
-                delete itr->second;
-                AuctionsMap.erase(itr++);
-                continue;
-            }
+        AuctionEntry* auction = itr->second;
+        if (GetAuctionDueTime(auction) != due.first)        // rescheduled, a newer entry is queued
+        {
+            continue;
+        }
+
+        if (auction->moneyDeliveryTime)                     // pending auction
+        {
+            sAuctionMgr.SendAuctionSuccessfulMail(auction);
+
+            MANGOS_ASSERT(!auction->itemGuidLow);           // already removed or send in mail at won
+            deletedAuctions.push_back(auction->Id);
+            SearchIndex.Remove(auction);
+            delete auction;
+            AuctionsMap.erase(itr);
         }
         else                                                // active auction
         {
-            if (curTime > itr->second->expireTime)
+            ///- perform the transaction if there was bidder
+            if (auction->bid)
             {
-                ///- perform the transaction if there was bidder
-                if (itr->second->bid)
-                {
-                    itr->second->AuctionBidWinning();
-                }
-                ///- cancel the auction if there was no bidder and clear the auction
-                else
-                {
-                    sAuctionMgr.SendAuctionExpiredMail(itr->second);
+                auction->AuctionBidWinning();
+            }
+            ///- cancel the auction if there was no bidder and clear the auction
+            else
+            {
+                sAuctionMgr.SendAuctionExpiredMail(auction);
 
-                    itr->second->DeleteFromDB();
-                    delete itr->second;
-                    AuctionsMap.erase(itr++);
-                    continue;
-                }
+                deletedAuctions.push_back(auction->Id);
+                SearchIndex.Remove(auction);
+                delete auction;
+                AuctionsMap.erase(itr);
             }
         }
+    }
 
-        ++itr;
+    if (deletedAuctions.empty())
+    {
+        return;
     }
+
+    ///- Delete the finished auctions from DB in one transaction
+    // the mails and items above were written in the connections of their receivers,
+    // nothing writes to the rows of a finished auction anymore, so these need no affinity
+    CharacterDatabase.BeginTransaction();
+    for (size_t i = 0; i < deletedAuctions.size(); i += 500)
+    {
+        std::ostringstream ss;
+        ss << "DELETE FROM `auction` WHERE `id` IN (";
+        for (size_t j = i; j < deletedAuctions.size() && j < i + 500; ++j)
+        {
+            if (j != i)
+            {
+                ss << ",";
+            }
+            ss << deletedAuctions[j];
+        }
+        ss << ")";
+        CharacterDatabase.Execute(ss.str().c_str());
+    }
+    CharacterDatabase.CommitTransaction();
 }
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
@@ -888,16 +932,11 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
 
 bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const
 {
-    if (m_sort[0] == MAX_AUCTION_SORT)                      // not sorted
-    {
-        return false;
-    }
-
     for (uint32 i = 0; i < MAX_AUCTION_SORT; ++i)
     {
         if (m_sort[i] == MAX_AUCTION_SORT)                  // end of sort
         {
-            return false;
+            break;
         }
 
         int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_viewPlayer);
@@ -910,14 +949,16 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
         return (res < 0) == ((m_sort[i] & AUCTION_SORT_REVERSED) == 0);
     }
 
-    return false;                                           // "equal" by all sorts
+    // "equal" by all sorts (or not sorted), fall back to the auction id so the
+    // order is total and partial_sort pages stay stable between requests
+    return auc1->Id < auc2->Id;
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
-        uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull)
+void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*>& auctions, WorldPacket& data, AuctionSorter const& sorter, uint32 listfrom, uint32 usable,
+        uint32& count, uint32& totalcount, bool isFull)
 {
-    int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
-
+    // drop the candidates that can't be listed to this player, the index already applied the item template filters
+    std::vector<AuctionEntry*>::iterator last = auctions.begin();
     for (std::vector<AuctionEntry*>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
     {
         AuctionEntry* Aentry = *itr;
@@ -931,81 +972,48 @@ void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& aucti
             continue;
         }
 
-        if (isFull)
-        {
-            ++count;
-            Aentry->BuildAuctionInfo(data);
-        }
-        else
+        if (!isFull && usable != 0x00)
         {
-            ItemPrototype const* proto = item->GetProto();
-
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-            {
-                continue;
-            }
-
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-            {
-                continue;
-            }
-
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-            {
-                continue;
-            }
-
-            if (quality != 0xffffffff && proto->Quality < quality)
-            {
-                continue;
-            }
-
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
+            if (_player->CanUseItem(item) != EQUIP_ERR_OK)
             {
                 continue;
             }
 
-            if (usable != 0x00)
+            ItemPrototype const* proto = item->GetProto();
+            if (proto->Class == ITEM_CLASS_RECIPE)
             {
-                if (_player->CanUseItem(item) != EQUIP_ERR_OK)
+                if (SpellEntry const* spell = sSpellStore.LookupEntry(proto->Spells[0].SpellId))
                 {
-                    continue;
-                }
+                    SpellEffectEntry const* spellEff = spell->GetSpellEffect(EFFECT_INDEX_0);
+                    if (!spellEff)
+                    {
+                        continue;
+                    }
 
-                if (proto->Class == ITEM_CLASS_RECIPE)
-                {
-                    if (SpellEntry const* spell = sSpellStore.LookupEntry(proto->Spells[0].SpellId))
+                    if (_player->HasSpell(spellEff->EffectTriggerSpell))
                     {
-                        SpellEffectEntry const* spellEff = spell->GetSpellEffect(EFFECT_INDEX_0);
-                        if (!spellEff)
-                        {
-                            continue;
-                        }
-
-                        if (_player->HasSpell(spellEff->EffectTriggerSpell))
-                        {
-                            continue;
-                        }
+                        continue;
                     }
                 }
             }
+        }
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+        *last++ = Aentry;
+    }
+    auctions.erase(last, auctions.end());
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-            {
-                continue;
-            }
+    totalcount = auctions.size();
 
-            if (count < 50 && totalcount >= listfrom)
-            {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
-            }
-        }
+    // only the requested page has to be ordered
+    size_t pageBegin = isFull ? 0 : std::min<size_t>(listfrom, auctions.size());
+    size_t pageEnd = isFull ? auctions.size() : std::min<size_t>(size_t(listfrom) + 50, auctions.size());
+
+    std::partial_sort(auctions.begin(), auctions.begin() + pageEnd, auctions.end(), sorter);
 
-        ++totalcount;
+    for (size_t i = pageBegin; i < pageEnd; ++i)
+    {
+        ++count;
+        auctions[i]->BuildAuctionInfo(data);
     }
 }
 
@@ -1160,6 +1168,9 @@ void AuctionEntry::AuctionBidWinning(Player* newbidder)
     }
     CharacterDatabase.CommitTransaction();
 
+    // money is sent to the owner at moneyDeliveryTime
+    sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->ScheduleAuction(this);
+
     sAuctionMgr.SendAuctionWonMail(this);
 }
 
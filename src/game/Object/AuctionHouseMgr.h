@@ -41,6 +41,9 @@
 #include "Common.h"
 #include "DBCStructure.h"
 #include "World.h"
+#include "AuctionSearchIndex.h"
+
+#include <queue>
 
 /** \addtogroup auctionhouse
  * @{
@@ -139,6 +142,8 @@ class AuctionHouseObject
         {
             MANGOS_ASSERT(ah);
             AuctionsMap[ah->Id] = ah;
+            SearchIndex.Insert(ah);
+            ScheduleAuction(ah);
         }
 
         AuctionEntry* GetAuction(uint32 id) const
@@ -149,9 +154,26 @@ class AuctionHouseObject
 
         bool RemoveAuction(uint32 id)
         {
-            return AuctionsMap.erase(id);
+            AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+            if (itr == AuctionsMap.end())
+            {
+                return false;
+            }
+
+            SearchIndex.Remove(itr->second);
+            AuctionsMap.erase(itr);
+            return true;
+        }
+
+        /// Appends the auctions matching the filter, see \ref AuctionSearchIndex
+        void SearchAuctions(AuctionSearchFilter const& filter, std::vector<AuctionEntry*>& result)
+        {
+            SearchIndex.Search(filter, result);
         }
 
+        /// Queues the auction for its next expire or money delivery time, must be called when one of them changes
+        void ScheduleAuction(AuctionEntry const* auction);
+
         void Update();
 
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
@@ -160,7 +182,18 @@ class AuctionHouseObject
 
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint64 bid, uint64 buyout = 0, uint64 deposit = 0, Player* pl = NULL);
     private:
+        // (due time, auction id), entries of removed or rescheduled auctions are skipped when they come due
+        typedef std::pair<time_t, uint32> AuctionExpiry;
+        typedef std::priority_queue<AuctionExpiry, std::vector<AuctionExpiry>, std::greater<AuctionExpiry> > AuctionExpiryQueue;
+
+        static time_t GetAuctionDueTime(AuctionEntry const* auction)
+        {
+            return auction->moneyDeliveryTime ? auction->moneyDeliveryTime : auction->expireTime;
+        }
+
         AuctionEntryMap AuctionsMap;
+        AuctionSearchIndex SearchIndex;
+        AuctionExpiryQueue ExpiryQueue;
 };
 
 class AuctionSorter
@@ -0,0 +1,353 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "AuctionSearchIndex.h"
+#include "AuctionHouseMgr.h"
+#include "ItemPrototype.h"
+#include "ObjectMgr.h"
+#include "Util.h"
+
+// Utf8 code points fit in 21 bits, so three of them fit in one key
+static inline uint64 MakeTrigram(std::wstring const& str, size_t pos)
+{
+    return (uint64(str[pos] & 0x1FFFFF) << 42) | (uint64(str[pos + 1] & 0x1FFFFF) << 21) | uint64(str[pos + 2] & 0x1FFFFF);
+}
+
+uint32 AuctionSearchIndex::MakeBucketKey(ItemPrototype const* proto)
+{
+    return ((proto->Class & 0xFF) << 24) | ((proto->SubClass & 0xFF) << 16) | ((proto->InventoryType & 0xFF) << 8) | (proto->Quality & 0xFF);
+}
+
+bool AuctionSearchIndex::MatchesTemplate(ItemPrototype const* proto, AuctionSearchFilter const& filter)
+{
+    if (filter.itemClass != AUCTION_SEARCH_ANY && proto->Class != filter.itemClass)
+    {
+        return false;
+    }
+
+    if (filter.itemSubClass != AUCTION_SEARCH_ANY && proto->SubClass != filter.itemSubClass)
+    {
+        return false;
+    }
+
+    if (filter.inventoryType != AUCTION_SEARCH_ANY && proto->InventoryType != filter.inventoryType)
+    {
+        return false;
+    }
+
+    if (filter.quality != AUCTION_SEARCH_ANY && proto->Quality < filter.quality)
+    {
+        return false;
+    }
+
+    if (filter.levelmin != 0x00 && (proto->RequiredLevel < filter.levelmin || (filter.levelmax != 0x00 && proto->RequiredLevel > filter.levelmax)))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void AuctionSearchIndex::Insert(AuctionEntry* auction)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+    {
+        return;
+    }
+
+    m_buckets[MakeBucketKey(proto)][std::make_pair(proto->RequiredLevel, auction->Id)] = auction;
+
+    TemplateAuctions& auctions = m_templates[auction->itemTemplate];
+    if (auctions.empty())
+    {
+        for (LocaleIndexMap::iterator itr = m_localeIndexes.begin(); itr != m_localeIndexes.end(); ++itr)
+        {
+            AddName(itr->second, itr->first, auction->itemTemplate);
+        }
+    }
+
+    auctions[auction->Id] = auction;
+}
+
+void AuctionSearchIndex::Remove(AuctionEntry const* auction)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+    {
+        return;
+    }
+
+    BucketMap::iterator bucket = m_buckets.find(MakeBucketKey(proto));
+    if (bucket != m_buckets.end())
+    {
+        bucket->second.erase(std::make_pair(proto->RequiredLevel, auction->Id));
+        if (bucket->second.empty())
+        {
+            m_buckets.erase(bucket);
+        }
+    }
+
+    TemplateMap::iterator auctions = m_templates.find(auction->itemTemplate);
+    if (auctions == m_templates.end())
+    {
+        return;
+    }
+
+    auctions->second.erase(auction->Id);
+    if (auctions->second.empty())
+    {
+        m_templates.erase(auctions);
+
+        for (LocaleIndexMap::iterator itr = m_localeIndexes.begin(); itr != m_localeIndexes.end(); ++itr)
+        {
+            RemoveName(itr->second, auction->itemTemplate);
+        }
+    }
+}
+
+void AuctionSearchIndex::Search(AuctionSearchFilter const& filter, std::vector<AuctionEntry*>& result)
+{
+    if (filter.searchedName.empty())
+    {
+        SearchBuckets(filter, result);
+    }
+    else
+    {
+        SearchName(filter, result);
+    }
+}
+
+void AuctionSearchIndex::SearchBuckets(AuctionSearchFilter const& filter, std::vector<AuctionEntry*>& result) const
+{
+    if (filter.levelmin != 0x00 && filter.levelmax != 0x00 && filter.levelmax < filter.levelmin)
+    {
+        return;
+    }
+
+    BucketMap::const_iterator first = m_buckets.begin();
+    BucketMap::const_iterator last = m_buckets.end();
+
+    // class and subclass are the high bytes of the key, so they select a contiguous range of buckets
+    if (filter.itemClass != AUCTION_SEARCH_ANY)
+    {
+        if (filter.itemClass > 0xFF)
+        {
+            return;
+        }
+
+        uint64 lowKey = uint64(filter.itemClass) << 24;
+        uint64 highKey = uint64(filter.itemClass + 1) << 24;
+
+        if (filter.itemSubClass != AUCTION_SEARCH_ANY)
+        {
+            if (filter.itemSubClass > 0xFF)
+            {
+                return;
+            }
+
+            lowKey |= uint64(filter.itemSubClass) << 16;
+            highKey = lowKey + (uint64(1) << 16);
+        }
+
+        first = m_buckets.lower_bound(uint32(lowKey));
+        last = highKey > 0xFFFFFFFF ? m_buckets.end() : m_buckets.lower_bound(uint32(highKey));
+    }
+
+    for (BucketMap::const_iterator bucket = first; bucket != last; ++bucket)
+    {
+        uint32 subClass = (bucket->first >> 16) & 0xFF;
+        uint32 inventoryType = (bucket->first >> 8) & 0xFF;
+        uint32 quality = bucket->first & 0xFF;
+
+        if (filter.itemSubClass != AUCTION_SEARCH_ANY && subClass != filter.itemSubClass)
+        {
+            continue;
+        }
+
+        if (filter.inventoryType != AUCTION_SEARCH_ANY && inventoryType != filter.inventoryType)
+        {
+            continue;
+        }
+
+        if (filter.quality != AUCTION_SEARCH_ANY && quality < filter.quality)
+        {
+            continue;
+        }
+
+        LevelBucket::const_iterator itr = bucket->second.begin();
+        LevelBucket::const_iterator end = bucket->second.end();
+
+        if (filter.levelmin != 0x00)
+        {
+            itr = bucket->second.lower_bound(std::make_pair(filter.levelmin, uint32(0)));
+            if (filter.levelmax != 0x00)
+            {
+                end = bucket->second.upper_bound(std::make_pair(filter.levelmax, uint32(0xFFFFFFFF)));
+            }
+        }
+
+        for (; itr != end; ++itr)
+        {
+            result.push_back(itr->second);
+        }
+    }
+}
+
+void AuctionSearchIndex::SearchName(AuctionSearchFilter const& filter, std::vector<AuctionEntry*>& result)
+{
+    LocaleNameIndex& index = GetLocaleIndex(filter.locale);
+    std::wstring const& searched = filter.searchedName;
+
+    std::vector<uint32> matchingTemplates;
+
+    if (searched.size() >= 3)
+    {
+        // only the templates containing the rarest trigram of the searched text can match it
+        TemplateSet const* candidates = NULL;
+        for (size_t i = 0; i + 3 <= searched.size(); ++i)
+        {
+            std::unordered_map<uint64, TemplateSet>::const_iterator posting = index.trigrams.find(MakeTrigram(searched, i));
+            if (posting == index.trigrams.end())
+            {
+                return;
+            }
+
+            if (!candidates || posting->second.size() < candidates->size())
+            {
+                candidates = &posting->second;
+            }
+        }
+
+        for (TemplateSet::const_iterator itr = candidates->begin(); itr != candidates->end(); ++itr)
+        {
+            if (index.names[*itr].find(searched) != std::wstring::npos)
+            {
+                matchingTemplates.push_back(*itr);
+            }
+        }
+    }
+    else
+    {
+        // too short for a trigram, check the names of the listed templates only
+        for (std::map<uint32, std::wstring>::const_iterator itr = index.names.begin(); itr != index.names.end(); ++itr)
+        {
+            if (itr->second.find(searched) != std::wstring::npos)
+            {
+                matchingTemplates.push_back(itr->first);
+            }
+        }
+    }
+
+    for (std::vector<uint32>::const_iterator itr = matchingTemplates.begin(); itr != matchingTemplates.end(); ++itr)
+    {
+        ItemPrototype const* proto = ObjectMgr::GetItemPrototype(*itr);
+        if (!proto || !MatchesTemplate(proto, filter))
+        {
+            continue;
+        }
+
+        TemplateMap::const_iterator auctions = m_templates.find(*itr);
+        if (auctions == m_templates.end())
+        {
+            continue;
+        }
+
+        for (TemplateAuctions::const_iterator auc = auctions->second.begin(); auc != auctions->second.end(); ++auc)
+        {
+            result.push_back(auc->second);
+        }
+    }
+}
+
+AuctionSearchIndex::LocaleNameIndex& AuctionSearchIndex::GetLocaleIndex(int32 locale)
+{
+    LocaleIndexMap::iterator itr = m_localeIndexes.find(locale);
+    if (itr != m_localeIndexes.end())
+    {
+        return itr->second;
+    }
+
+    LocaleNameIndex& index = m_localeIndexes[locale];
+    for (TemplateMap::const_iterator tpl = m_templates.begin(); tpl != m_templates.end(); ++tpl)
+    {
+        AddName(index, locale, tpl->first);
+    }
+
+    return index;
+}
+
+void AuctionSearchIndex::AddName(LocaleNameIndex& index, int32 locale, uint32 itemTemplate)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(itemTemplate);
+    if (!proto)
+    {
+        return;
+    }
+
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(itemTemplate, locale, &name);
+
+    std::wstring wname;
+    if (!Utf8toWStr(name, wname))
+    {
+        return;
+    }
+
+    wstrToLower(wname);
+
+    for (size_t i = 0; i + 3 <= wname.size(); ++i)
+    {
+        index.trigrams[MakeTrigram(wname, i)].insert(itemTemplate);
+    }
+
+    index.names[itemTemplate] = wname;
+}
+
+void AuctionSearchIndex::RemoveName(LocaleNameIndex& index, uint32 itemTemplate)
+{
+    std::map<uint32, std::wstring>::iterator name = index.names.find(itemTemplate);
+    if (name == index.names.end())
+    {
+        return;
+    }
+
+    std::wstring const& wname = name->second;
+    for (size_t i = 0; i + 3 <= wname.size(); ++i)
+    {
+        std::unordered_map<uint64, TemplateSet>::iterator posting = index.trigrams.find(MakeTrigram(wname, i));
+        if (posting == index.trigrams.end())
+        {
+            continue;
+        }
+
+        posting->second.erase(itemTemplate);
+        if (posting->second.empty())
+        {
+            index.trigrams.erase(posting);
+        }
+    }
+
+    index.names.erase(name);
+}
@@ -0,0 +1,110 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_AUCTION_SEARCH_INDEX
+#define MANGOS_H_AUCTION_SEARCH_INDEX
+
+#include "Common.h"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+
+struct AuctionEntry;
+struct ItemPrototype;
+
+#define AUCTION_SEARCH_ANY 0xFFFFFFFF
+
+/**
+ * The part of a CMSG_AUCTION_LIST_ITEMS request that only depends on the item template
+ * of an auction, and so can be answered by the \ref AuctionSearchIndex.
+ */
+struct AuctionSearchFilter
+{
+    AuctionSearchFilter() : levelmin(0), levelmax(0), inventoryType(AUCTION_SEARCH_ANY),
+        itemClass(AUCTION_SEARCH_ANY), itemSubClass(AUCTION_SEARCH_ANY), quality(AUCTION_SEARCH_ANY), locale(-1) {}
+
+    std::wstring searchedName;                              // already lower case, empty for any name
+    uint32 levelmin;                                        // 0 disables the level filter
+    uint32 levelmax;                                        // 0 for no upper bound
+    uint32 inventoryType;
+    uint32 itemClass;
+    uint32 itemSubClass;
+    uint32 quality;                                         // minimal quality
+    int32 locale;                                           // db locale index of the searched name
+};
+
+/**
+ * Index of the auctions of one auction house, so that a search only visits the auctions
+ * which can match it:
+ * - auctions are kept in buckets by item class/subclass/inventory type/quality, each bucket
+ *   ordered by required level, so the category filters select a range of buckets and the
+ *   level filter a range inside each bucket
+ * - item names are kept lower case per locale with a trigram index, so a name search only
+ *   checks the item templates which contain the rarest trigram of the searched text
+ *
+ * The name index of a locale is built the first time a player of that locale searches by name.
+ */
+class AuctionSearchIndex
+{
+    public:
+        void Insert(AuctionEntry* auction);
+        void Remove(AuctionEntry const* auction);
+
+        /// Appends the auctions which match the filter, in no particular order
+        void Search(AuctionSearchFilter const& filter, std::vector<AuctionEntry*>& result);
+
+    private:
+        // (required level, auction id)
+        typedef std::map<std::pair<uint32, uint32>, AuctionEntry*> LevelBucket;
+        // class/subclass/inventory type/quality packed in one key, see MakeBucketKey
+        typedef std::map<uint32, LevelBucket> BucketMap;
+        // auction id -> auction
+        typedef std::map<uint32, AuctionEntry*> TemplateAuctions;
+        typedef std::map<uint32, TemplateAuctions> TemplateMap;
+        typedef std::set<uint32> TemplateSet;
+
+        struct LocaleNameIndex
+        {
+            std::map<uint32, std::wstring> names;           // item template -> lower case name
+            std::unordered_map<uint64, TemplateSet> trigrams;
+        };
+        typedef std::map<int32, LocaleNameIndex> LocaleIndexMap;
+
+        static uint32 MakeBucketKey(ItemPrototype const* proto);
+        static bool MatchesTemplate(ItemPrototype const* proto, AuctionSearchFilter const& filter);
+
+        void SearchBuckets(AuctionSearchFilter const& filter, std::vector<AuctionEntry*>& result) const;
+        void SearchName(AuctionSearchFilter const& filter, std::vector<AuctionEntry*>& result);
+
+        LocaleNameIndex& GetLocaleIndex(int32 locale);
+        static void AddName(LocaleNameIndex& index, int32 locale, uint32 itemTemplate);
+        static void RemoveName(LocaleNameIndex& index, uint32 itemTemplate);
+
+        BucketMap m_buckets;
+        TemplateMap m_templates;
+        LocaleIndexMap m_localeIndexes;
+};
+
+#endif
@@ -2277,6 +2277,7 @@ void GameObject::UpdateCollisionState() const
     }
 
     m_model->enable(IsCollisionEnabled() ? GetPhaseMask() : 0);
+    GetMap()->InvalidateLineOfSightCache();
 }
 
 void GameObject::UpdateModel()
@@ -24,6 +24,7 @@
 
 #include "Database/DatabaseEnv.h"
 #include "WorldPacket.h"
+#include "SharedPacket.h"
 #include "WorldSession.h"
 #include "Player.h"
 #include "Opcodes.h"
@@ -772,18 +773,22 @@ void Guild::BroadcastAddonToOfficers(WorldSession* session, const std::string& m
 
 void Guild::BroadcastPacket(WorldPacket* packet)
 {
+    SharedPacket shared(*packet);
+
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player* player = sObjectAccessor.FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
         if (player)
         {
-            player->GetSession()->SendPacket(packet);
+            player->GetSession()->SendPacket(shared);
         }
     }
 }
 
 void Guild::BroadcastPacketToRank(WorldPacket* packet, uint32 rankId)
 {
+    SharedPacket shared(*packet);
+
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         if (itr->second.RankId == rankId)
@@ -791,7 +796,7 @@ void Guild::BroadcastPacketToRank(WorldPacket* packet, uint32 rankId)
             Player* player = sObjectAccessor.FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
             if (player)
             {
-                player->GetSession()->SendPacket(packet);
+                player->GetSession()->SendPacket(shared);
             }
         }
     }
@@ -68,6 +68,7 @@ Object::Object(): m_updateFlag(0)
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    m_clientUpdateListIndex = 0;
 }
 
 Object::~Object()
@@ -1394,6 +1395,33 @@ bool WorldObject::IsWithinLOSInMap(const WorldObject* obj) const
     return(IsWithinLOS(ox, oy, oz));
 }
 
+void WorldObject::IsWithinLOSInMap(uint32 count, WorldObject const* const* objs, bool* results) const
+{
+    if (!count)
+    {
+        return;
+    }
+
+    std::vector<float> ox(count), oy(count), oz(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        objs[i]->GetPosition(ox[i], oy[i], oz[i]);
+        oz[i] += 2.0f;
+    }
+
+    float x, y, z;
+    GetPosition(x, y, z);
+    GetMap()->IsInLineOfSight(x, y, z + 2.0f, count, &ox[0], &oy[0], &oz[0], GetPhaseMask(), results);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (!IsInMap(objs[i]))
+        {
+            results[i] = false;
+        }
+    }
+}
+
 bool WorldObject::IsWithinLOS(float ox, float oy, float oz) const
 {
     float x, y, z;
@@ -1612,6 +1640,39 @@ void WorldObject::GetRandomPoint(float x, float y, float z, float distance, floa
     UpdateGroundPositionZ(rand_x, rand_y, rand_z);          // update to LOS height if available
 }
 
+void WorldObject::GetRandomPoints(float x, float y, float z, float distance, uint32 count, float* rand_x, float* rand_y, float* rand_z, float minDist /*=0.0f*/) const
+{
+    if (distance == 0)
+    {
+        std::fill(rand_x, rand_x + count, x);
+        std::fill(rand_y, rand_y + count, y);
+        std::fill(rand_z, rand_z + count, z);
+        return;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float angle = rand_norm_f() * 2 * M_PI_F;
+        float new_dist = minDist + rand_norm_f() * (distance - minDist);
+
+        rand_x[i] = x + new_dist * cos(angle);
+        rand_y[i] = y + new_dist * sin(angle);
+
+        MaNGOS::NormalizeMapCoord(rand_x[i]);
+        MaNGOS::NormalizeMapCoord(rand_y[i]);
+    }
+
+    // update to LOS height if available
+    std::vector<float> ground(count);
+    std::vector<float> refZ(count, z);
+    GetMap()->GetHeights(GetPhaseMask(), count, rand_x, rand_y, &refZ[0], &ground[0]);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        rand_z[i] = ground[i] > INVALID_HEIGHT ? ground[i] + 0.05f : z;
+    }
+}
+
 void WorldObject::UpdateGroundPositionZ(float x, float y, float& z) const
 {
     float new_z = GetMap()->GetHeight(GetPhaseMask(), x, y, z);
@@ -1704,6 +1765,87 @@ void WorldObject::UpdateAllowedPositionZ(float x, float y, float& z, Map* atMap
     }
 }
 
+void WorldObject::UpdateAllowedPositionZ(uint32 count, const float* x, const float* y, float* z, Map* atMap /*=NULL*/) const
+{
+    if (!count)
+    {
+        return;
+    }
+
+    if (!atMap)
+    {
+        atMap = GetMap();
+    }
+
+    std::vector<float> ground_z(z, z + count);
+    std::vector<float> max_z(count);
+
+    // same rules as the single point version
+    bool canFly = false;
+    bool useWaterLevel = false;
+    switch (GetTypeId())
+    {
+        case TYPEID_UNIT:
+            canFly = ((Creature const*)this)->CanFly();
+            useWaterLevel = ((Creature const*)this)->CanSwim();
+            break;
+        case TYPEID_PLAYER:
+            canFly = ((Player const*)this)->CanFly();
+            useWaterLevel = true;
+            break;
+        default:
+        {
+            atMap->GetHeights(GetPhaseMask(), count, x, y, z, &ground_z[0]);
+            for (uint32 i = 0; i < count; ++i)
+            {
+                if (ground_z[i] > INVALID_HEIGHT)
+                {
+                    z[i] = ground_z[i];
+                }
+            }
+            return;
+        }
+    }
+
+    if (canFly)
+    {
+        atMap->GetHeights(GetPhaseMask(), count, x, y, z, &ground_z[0]);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (z[i] < ground_z[i])
+            {
+                z[i] = ground_z[i];
+            }
+        }
+        return;
+    }
+
+    if (useWaterLevel)
+    {
+        atMap->GetTerrain()->GetWaterOrGroundLevels(count, x, y, z, &max_z[0], &ground_z[0], !((Unit const*)this)->HasAuraType(SPELL_AURA_WATER_WALK));
+    }
+    else
+    {
+        atMap->GetHeights(GetPhaseMask(), count, x, y, z, &ground_z[0]);
+        max_z = ground_z;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (max_z[i] > INVALID_HEIGHT)
+        {
+            if (z[i] > max_z[i])
+            {
+                z[i] = max_z[i];
+            }
+            else if (z[i] < ground_z[i])
+            {
+                z[i] = ground_z[i];
+            }
+        }
+    }
+}
+
 bool WorldObject::IsPositionValid() const
 {
     return MaNGOS::IsValidMapCoord(m_position.x, m_position.y, m_position.z, m_position.o);
@@ -201,6 +201,10 @@ class Object
         void MarkForClientUpdate();
         void SendForcedObjectUpdate();
 
+        // position in the client update list of the map, maintained by Map::AddUpdateObject
+        uint32 GetClientUpdateListIndex() const { return m_clientUpdateListIndex; }
+        void SetClientUpdateListIndex(uint32 index) { m_clientUpdateListIndex = index; }
+
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
 
@@ -491,6 +495,7 @@ class Object
     private:
         bool m_inWorld;
         bool m_itsNewObject;
+        uint32 m_clientUpdateListIndex;
 
         PackedGuid m_PackGUID;
 
@@ -598,8 +603,12 @@ class WorldObject : public Object
         bool IsPositionValid() const;
         void UpdateGroundPositionZ(float x, float y, float& z) const;
         void UpdateAllowedPositionZ(float x, float y, float& z, Map* atMap = NULL) const;
+        // same for count points, their terrain heights are looked up together
+        void UpdateAllowedPositionZ(uint32 count, const float* x, const float* y, float* z, Map* atMap = NULL) const;
 
         void GetRandomPoint(float x, float y, float z, float distance, float& rand_x, float& rand_y, float& rand_z, float minDist = 0.0f, float const* ori = NULL) const;
+        // count independent random points around the same position
+        void GetRandomPoints(float x, float y, float z, float distance, uint32 count, float* rand_x, float* rand_y, float* rand_z, float minDist = 0.0f) const;
 
         uint32 GetMapId() const { return m_mapId; }
         uint32 GetInstanceId() const { return m_InstanceId; }
@@ -645,6 +654,8 @@ class WorldObject : public Object
         }
         bool IsWithinLOS(float x, float y, float z) const;
         bool IsWithinLOSInMap(const WorldObject* obj) const;
+        // batch version for many objects, e.g. the targets of an AoE spell
+        void IsWithinLOSInMap(uint32 count, WorldObject const* const* objs, bool* results) const;
         bool GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D = true) const;
         bool IsInRange(WorldObject const* obj, float minRange, float maxRange, bool is3D = true) const;
         bool IsInRange2d(float x, float y, float minRange, float maxRange) const;
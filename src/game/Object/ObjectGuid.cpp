@@ -77,12 +77,13 @@ std::string ObjectGuid::GetString() const
 template<HighGuid high>
 uint32 ObjectGuidGenerator<high>::Generate()
 {
-    if (m_nextGuid >= ObjectGuid::GetMaxCounter(high) - 1)
+    uint32 guid = m_nextGuid++;
+    if (guid >= ObjectGuid::GetMaxCounter(high) - 1)
     {
         sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", ObjectGuid::GetTypeName(high));
         World::StopNow(ERROR_EXIT_CODE);
     }
-    return m_nextGuid++;
+    return guid;
 }
 
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid)
@@ -305,7 +305,7 @@ class ObjectGuidGenerator
         uint32 GetNextAfterMaxUsed() const { return m_nextGuid; }
 
     private:                                                // fields
-        uint32 m_nextGuid;
+        std::atomic<uint32> m_nextGuid;                     // objects are created by concurrent map and region updates
 };
 
 ByteBuffer& operator<< (ByteBuffer& buf, ObjectGuid const& guid);
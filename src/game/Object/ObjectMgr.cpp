@@ -160,12 +160,13 @@ bool SpellClickInfo::IsFitToRequirements(Player const* player, Creature const* c
 template<typename T>
 T IdGenerator<T>::Generate()
 {
-    if (m_nextGuid >= std::numeric_limits<T>::max() - 1)
+    T guid = m_nextGuid++;
+    if (guid >= std::numeric_limits<T>::max() - 1)
     {
         sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", m_name);
         World::StopNow(ERROR_EXIT_CODE);
     }
-    return m_nextGuid++;
+    return guid;
 }
 
 template uint32 IdGenerator<uint32>::Generate();
@@ -512,6 +513,19 @@ void ObjectMgr::LoadPointOfInterestLocales()
     sLog.outString();
 }
 
+// Script ids are indexes in the sorted script name list, so table snapshots holding them are only valid for the same list
+static uint64 GetScriptNamesSnapshotSalt()
+{
+    std::string names;
+    for (uint32 i = 0; i < sScriptMgr.GetScriptIdsCount(); ++i)
+    {
+        names.append(sScriptMgr.GetScriptName(i));
+        names.push_back('\0');
+    }
+
+    return SQLStorageBase::SnapshotHash(names.data(), names.length());
+}
+
 struct SQLCreatureLoader : public SQLStorageLoaderBase<SQLCreatureLoader, SQLStorage>
 {
     template<class D>
@@ -519,6 +533,8 @@ struct SQLCreatureLoader : public SQLStorageLoaderBase<SQLCreatureLoader, SQLSto
     {
         dst = D(sScriptMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotSalt() const { return GetScriptNamesSnapshotSalt(); }
 };
 
 void ObjectMgr::LoadCreatureTemplates()
@@ -2135,6 +2151,8 @@ struct SQLItemLoader : public SQLStorageLoaderBase<SQLItemLoader, SQLStorage>
     {
         dst = D(sScriptMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotSalt() const { return GetScriptNamesSnapshotSalt(); }
 };
 
 void ObjectMgr::LoadItemPrototypes()
@@ -5306,6 +5324,8 @@ struct SQLInstanceLoader : public SQLStorageLoaderBase<SQLInstanceLoader, SQLSto
     {
         dst = D(sScriptMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotSalt() const { return GetScriptNamesSnapshotSalt(); }
 };
 
 void ObjectMgr::LoadInstanceTemplate()
@@ -5369,6 +5389,8 @@ struct SQLWorldLoader : public SQLStorageLoaderBase<SQLWorldLoader, SQLStorage>
     {
         dst = D(sScriptMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotSalt() const { return GetScriptNamesSnapshotSalt(); }
 };
 
 void ObjectMgr::LoadWorldTemplate()
@@ -6650,6 +6672,8 @@ struct SQLGameObjectLoader : public SQLStorageLoaderBase<SQLGameObjectLoader, SQ
     {
         dst = D(sScriptMgr.GetScriptId(src));
     }
+
+    uint64 GetSnapshotSalt() const { return GetScriptNamesSnapshotSalt(); }
 };
 
 inline void CheckGOLockId(GameObjectInfo const* goInfo, uint32 dataN, uint32 N)
@@ -8371,6 +8395,14 @@ int ObjectMgr::GetOrNewIndexForLocale(LocaleConstant loc)
     return m_LocalForIndex.size() - 1;
 }
 
+void ObjectMgr::InitLocaleIndexes()
+{
+    for (int i = 1; i < MAX_LOCALE; ++i)
+    {
+        GetOrNewIndexForLocale(LocaleConstant(i));
+    }
+}
+
 void ObjectMgr::LoadGameObjectForQuests()
 {
     mGameObjectForQuestSet.clear();                         // need for reload case
@@ -566,7 +566,7 @@ class IdGenerator
 
     private:                                                // fields
         char const* m_name;
-        T m_nextGuid;
+        std::atomic<T> m_nextGuid;                          // ids are generated by concurrent map and region updates
 };
 
 class ObjectMgr
@@ -1282,6 +1282,8 @@ class ObjectMgr
         }
 
         int GetOrNewIndexForLocale(LocaleConstant loc);
+        // create the index of every locale, so locale loaders running concurrently only read them
+        void InitLocaleIndexes();
 
         SpellClickInfoMapBounds GetSpellClickInfoMapBounds(uint32 creature_id) const
         {
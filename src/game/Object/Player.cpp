@@ -20238,6 +20238,9 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
+    // autosaves are made by the map threads, use the same async connection as the session
+    SqlAsyncAffinity dbAffinity(GetSession()->GetAccountId());
+
     CharacterDatabase.BeginTransaction();
 
 #ifdef ENABLE_ELUNA
@@ -13420,6 +13420,34 @@ void Unit::UpdateReactives(uint32 p_time)
     }
 }
 
+// remove the targets out of line of sight of the unit, tested in one batch
+static void RemoveTargetsNotInLOS(Unit const* unit, std::list<Unit*>& targets)
+{
+    if (targets.empty())
+    {
+        return;
+    }
+
+    std::vector<WorldObject const*> objects(targets.begin(), targets.end());
+    bool* inLos = new bool[objects.size()];
+    unit->IsWithinLOSInMap(uint32(objects.size()), &objects[0], inLos);
+
+    size_t i = 0;
+    for (std::list<Unit*>::iterator tIter = targets.begin(); tIter != targets.end(); ++i)
+    {
+        if (!inLos[i])
+        {
+            tIter = targets.erase(tIter);
+        }
+        else
+        {
+            ++tIter;
+        }
+    }
+
+    delete[] inLos;
+}
+
 Unit* Unit::SelectRandomUnfriendlyTarget(Unit* except /*= NULL*/, float radius /*= ATTACK_DISTANCE*/) const
 {
     std::list<Unit*> targets;
@@ -13435,19 +13463,7 @@ Unit* Unit::SelectRandomUnfriendlyTarget(Unit* except /*= NULL*/, float radius /
     }
 
     // remove not LoS targets
-    for (std::list<Unit*>::iterator tIter = targets.begin(); tIter != targets.end();)
-    {
-        if (!IsWithinLOSInMap(*tIter))
-        {
-            std::list<Unit*>::iterator tIter2 = tIter;
-            ++tIter;
-            targets.erase(tIter2);
-        }
-        else
-        {
-            ++tIter;
-        }
-    }
+    RemoveTargetsNotInLOS(this, targets);
 
     // no appropriate targets
     if (targets.empty())
@@ -13482,19 +13498,7 @@ Unit* Unit::SelectRandomFriendlyTarget(Unit* except /*= NULL*/, float radius /*=
     }
 
     // remove not LoS targets
-    for (std::list<Unit*>::iterator tIter = targets.begin(); tIter != targets.end();)
-    {
-        if (!IsWithinLOSInMap(*tIter))
-        {
-            std::list<Unit*>::iterator tIter2 = tIter;
-            ++tIter;
-            targets.erase(tIter2);
-        }
-        else
-        {
-            ++tIter;
-        }
-    }
+    RemoveTargetsNotInLOS(this, targets);
 
     // no appropriate targets
     if (targets.empty())
@@ -31,6 +31,8 @@
 #include "ObjectAccessor.h"
 #include "UnitEvents.h"
 
+#include <algorithm>
+
 //==============================================================
 //================= ThreatCalcHelper ===========================
 //==============================================================
@@ -78,6 +80,7 @@ HostileReference::HostileReference(Unit* pUnit, ThreatManager* pThreatManager, f
     iUnitGuid = pUnit->GetObjectGuid();
     iOnline = true;
     iAccessible = true;
+    iHeapIndex = 0;
 }
 
 //============================================================
@@ -242,30 +245,121 @@ Unit* HostileReference::getSourceUnit()
 
 void ThreatContainer::clearReferences()
 {
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
+    for (ThreatHeap::const_iterator i = iThreatHeap.begin(); i != iThreatHeap.end(); ++i)
     {
         (*i)->unlink();
         delete(*i);
     }
+    iThreatHeap.clear();
+    iThreatIndex.clear();
     iThreatList.clear();
+    iDirty = false;
 }
 
 //============================================================
-// Return the HostileReference of NULL, if not found
-HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
+
+void ThreatContainer::addReference(HostileReference* pHostileReference)
+{
+    iThreatIndex[pHostileReference->getUnitGuid()] = pHostileReference;
+    iThreatList.push_back(pHostileReference);
+    iThreatHeap.push_back(pHostileReference);
+    pHostileReference->iHeapIndex = iThreatHeap.size() - 1;
+    siftUp(pHostileReference->iHeapIndex);
+    iDirty = true;
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* pRef)
 {
-    HostileReference* result = NULL;
-    ObjectGuid guid = pVictim->GetObjectGuid();
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
+    if (!contains(pRef))
     {
-        if ((*i)->getUnitGuid() == guid)
+        return;
+    }
+
+    iThreatIndex.erase(pRef->getUnitGuid());
+    iThreatList.remove(pRef);
+
+    // move the last reference into the freed slot and restore its place
+    uint32 index = pRef->iHeapIndex;
+    HostileReference* last = iThreatHeap.back();
+    iThreatHeap.pop_back();
+    if (last != pRef)
+    {
+        placeAt(last, index);
+        updateReference(last);
+    }
+}
+
+//============================================================
+
+void ThreatContainer::updateReference(HostileReference* pRef)
+{
+    if (!contains(pRef))
+    {
+        return;
+    }
+
+    uint32 index = pRef->iHeapIndex;
+    siftUp(index);
+    if (pRef->iHeapIndex == index)
+    {
+        siftDown(index);
+    }
+    iDirty = true;
+}
+
+//============================================================
+
+void ThreatContainer::siftUp(uint32 pIndex)
+{
+    HostileReference* ref = iThreatHeap[pIndex];
+    while (pIndex > 0)
+    {
+        uint32 parent = (pIndex - 1) / 2;
+        if (iThreatHeap[parent]->getThreat() >= ref->getThreat())
         {
-            result = (*i);
             break;
         }
+        placeAt(iThreatHeap[parent], pIndex);
+        pIndex = parent;
     }
+    placeAt(ref, pIndex);
+}
 
-    return result;
+//============================================================
+
+void ThreatContainer::siftDown(uint32 pIndex)
+{
+    HostileReference* ref = iThreatHeap[pIndex];
+    uint32 size = iThreatHeap.size();
+    for (;;)
+    {
+        uint32 child = 2 * pIndex + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && iThreatHeap[child + 1]->getThreat() > iThreatHeap[child]->getThreat())
+        {
+            ++child;
+        }
+        if (iThreatHeap[child]->getThreat() <= ref->getThreat())
+        {
+            break;
+        }
+        placeAt(iThreatHeap[child], pIndex);
+        pIndex = child;
+    }
+    placeAt(ref, pIndex);
+}
+
+//============================================================
+// Return the HostileReference of NULL, if not found
+HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
+{
+    std::unordered_map<ObjectGuid, HostileReference*>::const_iterator itr = iThreatIndex.find(pVictim->GetObjectGuid());
+    return itr != iThreatIndex.end() ? itr->second : NULL;
 }
 
 //============================================================
@@ -308,35 +402,83 @@ bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileRef
 }
 
 //============================================================
-// Check if the list is dirty and sort if necessary
+// Sort the list if the threat changed since it was last read
 
-void ThreatContainer::update()
+ThreatList const& ThreatContainer::getThreatList() const
 {
     if (iDirty && iThreatList.size() > 1)
     {
         iThreatList.sort(HostileReferenceSortPredicate);
     }
     iDirty = false;
+    return iThreatList;
 }
 
+//============================================================
+// Visits the heap from the most hated reference down, only expanding the nodes it passes
+
+class ThreatHeapWalker
+{
+    public:
+        ThreatHeapWalker(ThreatHeap const& heap, std::vector<uint32>& frontier) : iHeap(heap), iFrontier(frontier) { restart(); }
+
+        void restart()
+        {
+            iFrontier.clear();
+            if (!iHeap.empty())
+            {
+                iFrontier.push_back(0);
+            }
+        }
+
+        // true when the last returned reference was the least hated one
+        bool done() const { return iFrontier.empty(); }
+
+        HostileReference* next()
+        {
+            if (iFrontier.empty())
+            {
+                return NULL;
+            }
+
+            std::pop_heap(iFrontier.begin(), iFrontier.end(), *this);
+            uint32 index = iFrontier.back();
+            iFrontier.pop_back();
+
+            for (uint32 child = 2 * index + 1; child <= 2 * index + 2 && child < iHeap.size(); ++child)
+            {
+                iFrontier.push_back(child);
+                std::push_heap(iFrontier.begin(), iFrontier.end(), *this);
+            }
+            return iHeap[index];
+        }
+
+        // frontier ordering, equal threat is resolved by heap slot to stay deterministic
+        bool operator()(uint32 lhs, uint32 rhs) const
+        {
+            float lhsThreat = iHeap[lhs]->getThreat();
+            float rhsThreat = iHeap[rhs]->getThreat();
+            return lhsThreat < rhsThreat || (lhsThreat == rhsThreat && lhs > rhs);
+        }
+
+    private:
+        ThreatHeap const& iHeap;
+        std::vector<uint32>& iFrontier;
+};
+
 //============================================================
 // return the next best victim
 // could be the current victim
 
 HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, HostileReference* pCurrentVictim)
 {
-    HostileReference* pCurrentRef = NULL;
-    bool found = false;
     bool onlySecondChoiceTargetsFound = false;
     bool checkedCurrentVictim = false;
 
-    ThreatList::const_iterator lastRef = iThreatList.end();
-    --lastRef;
+    ThreatHeapWalker walker(iThreatHeap, iHeapWalk);
 
-    for (ThreatList::const_iterator iter = iThreatList.begin(); iter != iThreatList.end() && !found;)
+    while (HostileReference* pCurrentRef = walker.next())
     {
-        pCurrentRef = (*iter);
-
         Unit* pTarget = pCurrentRef->getTarget();
         MANGOS_ASSERT(pTarget);                             // if the ref has status online the target must be there!
 
@@ -345,15 +487,11 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
         //     This prevents dropping valid targets due to 1.1 or 1.3 threat rule vs invalid current target
         if (!onlySecondChoiceTargetsFound && pAttacker->IsSecondChoiceTarget(pTarget, pCurrentRef == pCurrentVictim))
         {
-            if (iter != lastRef)
-            {
-                ++iter;
-            }
-            else
+            if (walker.done())
             {
                 // if we reached to this point, everyone in the threatlist is a second choice target. In such a situation the target with the highest threat should be attacked.
                 onlySecondChoiceTargetsFound = true;
-                iter = iThreatList.begin();
+                walker.restart();
             }
 
             // current victim is a second choice target, so don't compare threat with it below
@@ -373,8 +511,7 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
                 // normal case: pCurrentRef is still valid and most hated
                 if (pCurrentVictim == pCurrentRef)
                 {
-                    found = true;
-                    break;
+                    return pCurrentRef;
                 }
 
                 // we found a valid target, but only compare its threat if the currect victim is also a valid target
@@ -386,42 +523,32 @@ HostileReference* ThreatContainer::selectNextVictim(Creature* pAttacker, Hostile
                     if (pAttacker->IsSecondChoiceTarget(pCurrentTarget, true))
                     {
                         // CurrentVictim is invalid, so return CurrentRef
-                        found = true;
-                        break;
+                        return pCurrentRef;
                     }
                     checkedCurrentVictim = true;
                 }
 
-                // list sorted and and we check current target, then this is best case
+                // walked in threat order and and we check current target, then this is best case
                 if (pCurrentRef->getThreat() <= 1.1f * pCurrentVictim->getThreat())
                 {
-                    pCurrentRef = pCurrentVictim;
-                    found = true;
-                    break;
+                    return pCurrentVictim;
                 }
 
                 if (pCurrentRef->getThreat() > 1.3f * pCurrentVictim->getThreat() ||
                     (pCurrentRef->getThreat() > 1.1f * pCurrentVictim->getThreat() && pAttacker->CanReachWithMeleeAttack(pTarget)))
                 {
                     // implement 110% threat rule for targets in melee range
-                    found = true;                           // and 130% rule for targets in ranged distances
-                    break;                                  // for selecting alive targets
-                }
+                    return pCurrentRef;                     // and 130% rule for targets in ranged distances
+                }                                           // for selecting alive targets
             }
             else                                            // select any
             {
-                found = true;
-                break;
+                return pCurrentRef;
             }
         }
-        ++iter;
-    }
-    if (!found)
-    {
-        pCurrentRef = NULL;
     }
 
-    return pCurrentRef;
+    return NULL;
 }
 
 //============================================================
@@ -534,7 +661,6 @@ void ThreatManager::modifyThreatPercent(Unit* pVictim, int32 pPercent)
 
 Unit* ThreatManager::getHostileTarget()
 {
-    iThreatContainer.update();
     HostileReference* nextVictim = iThreatContainer.selectNextVictim((Creature*) getOwner(), getCurrentVictim());
     setCurrentVictim(nextVictim);
     return getCurrentVictim() != NULL ? getCurrentVictim()->getTarget() : NULL;
@@ -624,10 +750,14 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
     switch (threatRefStatusChangeEvent->getType())
     {
         case UEV_THREAT_REF_THREAT_CHANGE:
-            if ((getCurrentVictim() == hostileReference && threatRefStatusChangeEvent->getFValue() < 0.0f) ||
-                (getCurrentVictim() != hostileReference && threatRefStatusChangeEvent->getFValue() > 0.0f))
+            // the order in the threat list might have changed
+            if (hostileReference->isOnline())
             {
-                setDirty(true);                              // the order in the threat list might have changed
+                iThreatContainer.updateReference(hostileReference);
+            }
+            else
+            {
+                iThreatOfflineContainer.updateReference(hostileReference);
             }
             break;
         case UEV_THREAT_REF_ONLINE_STATUS:
@@ -649,9 +779,10 @@ void ThreatManager::processThreatEvent(ThreatRefStatusChangeEvent* threatRefStat
                 {
                     setDirty(true);
                 }
+                // both containers use the heap index of the reference, leave the offline one first
+                iThreatOfflineContainer.remove(hostileReference);
                 iThreatContainer.addReference(hostileReference);
                 iUpdateNeed = true;
-                iThreatOfflineContainer.remove(hostileReference);
             }
             break;
         case UEV_THREAT_REF_REMOVE_FROM_LIST:
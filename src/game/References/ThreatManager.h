@@ -32,6 +32,8 @@
 #include "Timer.h"
 #include "ObjectGuid.h"
 #include <list>
+#include <vector>
+#include <unordered_map>
 
 //==============================================================
 
@@ -125,6 +127,8 @@ class HostileReference : public Reference<Unit, ThreatManager>
         // Tell our refFrom (source) object, that the link is cut (Target destroyed)
         void sourceObjectDestroyLink() override;
     private:
+        friend class ThreatContainer;
+
         // Inform the source, that the status of that reference was changed
         void fireStatusChanged(ThreatRefStatusChangeEvent& pThreatRefStatusChangeEvent);
 
@@ -135,26 +139,39 @@ class HostileReference : public Reference<Unit, ThreatManager>
         ObjectGuid iUnitGuid;
         bool iOnline;
         bool iAccessible;
+        uint32 iHeapIndex;                                  // slot in the threat heap of the container holding the reference
 };
 
 //==============================================================
 class ThreatManager;
 
 typedef std::list<HostileReference*> ThreatList;
+typedef std::vector<HostileReference*> ThreatHeap;
 
+// The references are kept in a max heap on their threat, so a threat change costs O(log n)
+// and the most hated reference is found in O(1). The list handed out to scripts is only
+// sorted when it is read after a change.
 class ThreatContainer
 {
     private:
-        ThreatList iThreatList;
-        bool iDirty;
+        mutable ThreatList iThreatList;
+        mutable bool iDirty;
+        ThreatHeap iThreatHeap;
+        std::unordered_map<ObjectGuid, HostileReference*> iThreatIndex;
+        std::vector<uint32> iHeapWalk;                      // reused by selectNextVictim
     protected:
         friend class ThreatManager;
 
-        void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
-        void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+        void remove(HostileReference* pRef);
+        void addReference(HostileReference* pHostileReference);
         void clearReferences();
-        // Sort the list if necessary
-        void update();
+        // Restore the heap order after the threat of the reference changed
+        void updateReference(HostileReference* pRef);
+    private:
+        bool contains(HostileReference* pRef) const { return pRef->iHeapIndex < iThreatHeap.size() && iThreatHeap[pRef->iHeapIndex] == pRef; }
+        void siftUp(uint32 pIndex);
+        void siftDown(uint32 pIndex);
+        void placeAt(HostileReference* pRef, uint32 pIndex) { iThreatHeap[pIndex] = pRef; pRef->iHeapIndex = pIndex; }
     public:
         ThreatContainer() { iDirty = false; }
         ~ThreatContainer() { clearReferences(); }
@@ -169,13 +186,14 @@ class ThreatContainer
 
         bool isDirty() const { return iDirty; }
 
-        bool empty() const { return(iThreatList.empty()); }
+        bool empty() const { return(iThreatHeap.empty()); }
 
-        HostileReference* getMostHated() { return iThreatList.empty() ? NULL : iThreatList.front(); }
+        HostileReference* getMostHated() { return iThreatHeap.empty() ? NULL : iThreatHeap.front(); }
 
         HostileReference* getReferenceByTarget(Unit* pVictim);
 
-        ThreatList const& getThreatList() const { return iThreatList; }
+        // Sorted by threat, most hated first
+        ThreatList const& getThreatList() const;
 };
 
 //=================================================
@@ -0,0 +1,262 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "OpcodeProfiler.h"
+#include "Log.h"
+#include "Util.h"
+
+INSTANTIATE_SINGLETON_1(OpcodeProfiler);
+
+static char const* packetProcessingNames[MAX_PACKET_PROCESSING] =
+{
+    "InPlace",
+    "ThreadUnsafe",
+    "ThreadSafe",
+    "SessionSafe"
+};
+
+static inline uint32 GetBucketIndex(uint64 time)
+{
+    uint32 index = 0;
+    while (time && index < OPCODE_PROFILE_BUCKETS - 1)
+    {
+        time >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+void OpcodeProfileStats::Add(uint64 time)
+{
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalTime.fetch_add(time, std::memory_order_relaxed);
+    buckets[GetBucketIndex(time)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64 max = maxTime.load(std::memory_order_relaxed);
+    while (time > max && !maxTime.compare_exchange_weak(max, time, std::memory_order_relaxed))
+    {
+    }
+}
+
+void OpcodeProfileStats::Reset()
+{
+    count.store(0, std::memory_order_relaxed);
+    totalTime.store(0, std::memory_order_relaxed);
+    maxTime.store(0, std::memory_order_relaxed);
+    for (uint32 i = 0; i < OPCODE_PROFILE_BUCKETS; ++i)
+    {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+OpcodeProfileSnapshot OpcodeProfileStats::GetSnapshot() const
+{
+    OpcodeProfileSnapshot snapshot;
+    snapshot.opcode = 0;
+    snapshot.totalTime = totalTime.load(std::memory_order_relaxed);
+    snapshot.maxTime = maxTime.load(std::memory_order_relaxed);
+    snapshot.p50 = 0;
+    snapshot.p99 = 0;
+
+    // the counters are updated independently, so take the count from the histogram itself
+    uint64 histogram[OPCODE_PROFILE_BUCKETS];
+    snapshot.count = 0;
+    for (uint32 i = 0; i < OPCODE_PROFILE_BUCKETS; ++i)
+    {
+        histogram[i] = buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += histogram[i];
+    }
+
+    uint64 p50Rank = (snapshot.count * 50 + 99) / 100;
+    uint64 p99Rank = (snapshot.count * 99 + 99) / 100;
+    uint64 seen = 0;
+    bool p50Found = false;
+    for (uint32 i = 0; i < OPCODE_PROFILE_BUCKETS && seen < p99Rank; ++i)
+    {
+        seen += histogram[i];
+
+        // no call took longer than the max time, which is exact and can be below the bucket bound
+        uint64 bound = std::min((uint64(1) << i) - 1, snapshot.maxTime);
+        if (!p50Found && seen >= p50Rank)
+        {
+            snapshot.p50 = bound;
+            p50Found = true;
+        }
+        if (seen >= p99Rank)
+        {
+            snapshot.p99 = bound;
+        }
+    }
+
+    return snapshot;
+}
+
+OpcodeProfiler::OpcodeProfiler() : m_enabled(false)
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        m_opcodes[i].store(NULL, std::memory_order_relaxed);
+    }
+}
+
+OpcodeProfiler::~OpcodeProfiler()
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        delete m_opcodes[i].load(std::memory_order_relaxed);
+    }
+}
+
+void OpcodeProfiler::AddHandlerTime(uint16 opcode, PacketProcessing packetProcessing, Clock::time_point start)
+{
+    uint64 time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    if (packetProcessing < MAX_PACKET_PROCESSING)
+    {
+        m_classes[packetProcessing].Add(time);
+    }
+
+    if (opcode >= NUM_MSG_TYPES)
+    {
+        return;
+    }
+
+    OpcodeProfileStats* stats = m_opcodes[opcode].load(std::memory_order_acquire);
+    if (!stats)
+    {
+        // the opcode can be handled by several threads at once, the first one to publish its stats wins
+        OpcodeProfileStats* newStats = new OpcodeProfileStats();
+        if (m_opcodes[opcode].compare_exchange_strong(stats, newStats, std::memory_order_acq_rel))
+        {
+            stats = newStats;
+        }
+        else
+        {
+            delete newStats;
+        }
+    }
+
+    stats->Add(time);
+}
+
+void OpcodeProfiler::Reset()
+{
+    for (uint32 i = 0; i < MAX_PACKET_PROCESSING; ++i)
+    {
+        m_classes[i].Reset();
+    }
+
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        if (OpcodeProfileStats* stats = m_opcodes[i].load(std::memory_order_acquire))
+        {
+            stats->Reset();
+        }
+    }
+}
+
+void OpcodeProfiler::GetOpcodeSnapshots(std::vector<OpcodeProfileSnapshot>& snapshots) const
+{
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        OpcodeProfileStats const* stats = m_opcodes[i].load(std::memory_order_acquire);
+        if (!stats)
+        {
+            continue;
+        }
+
+        OpcodeProfileSnapshot snapshot = stats->GetSnapshot();
+        if (!snapshot.count)
+        {
+            continue;
+        }
+
+        snapshot.opcode = uint16(i);
+        snapshots.push_back(snapshot);
+    }
+
+    std::sort(snapshots.begin(), snapshots.end(), [](OpcodeProfileSnapshot const& a, OpcodeProfileSnapshot const& b)
+    {
+        return a.totalTime > b.totalTime;
+    });
+}
+
+OpcodeProfileSnapshot OpcodeProfiler::GetClassSnapshot(PacketProcessing packetProcessing) const
+{
+    return m_classes[packetProcessing].GetSnapshot();
+}
+
+void OpcodeProfiler::BuildReport(std::vector<std::string>& lines, uint32 limit) const
+{
+    char buf[256];
+
+    snprintf(buf, sizeof(buf), "Opcode profiling: %s, times in us, p50/p99 are histogram bucket bounds", IsEnabled() ? "on" : "off");
+    lines.push_back(buf);
+
+    for (uint32 i = 0; i < MAX_PACKET_PROCESSING; ++i)
+    {
+        OpcodeProfileSnapshot snapshot = GetClassSnapshot(PacketProcessing(i));
+        snprintf(buf, sizeof(buf), "%s: calls " UI64FMTD ", total " UI64FMTD ", avg " UI64FMTD ", max " UI64FMTD ", p50 " UI64FMTD ", p99 " UI64FMTD,
+                 packetProcessingNames[i], snapshot.count, snapshot.totalTime, snapshot.GetAverageTime(), snapshot.maxTime, snapshot.p50, snapshot.p99);
+        lines.push_back(buf);
+    }
+
+    std::vector<OpcodeProfileSnapshot> snapshots;
+    GetOpcodeSnapshots(snapshots);
+
+    for (std::vector<OpcodeProfileSnapshot>::const_iterator itr = snapshots.begin(); itr != snapshots.end() && limit; ++itr, --limit)
+    {
+        OpcodeHandler const& opHandle = opcodeTable[itr->opcode];
+        char const* processingName = opHandle.packetProcessing < MAX_PACKET_PROCESSING ? packetProcessingNames[opHandle.packetProcessing] : "?";
+        snprintf(buf, sizeof(buf), "%s (0x%.4X, %s): calls " UI64FMTD ", total " UI64FMTD ", avg " UI64FMTD ", max " UI64FMTD ", p50 " UI64FMTD ", p99 " UI64FMTD,
+                 opHandle.name, uint32(itr->opcode), processingName, itr->count, itr->totalTime, itr->GetAverageTime(), itr->maxTime, itr->p50, itr->p99);
+        lines.push_back(buf);
+    }
+}
+
+void OpcodeProfiler::DumpToFile() const
+{
+    if (m_dumpFile.empty())
+    {
+        return;
+    }
+
+    FILE* file = fopen(m_dumpFile.c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("OpcodeProfiler: can't open %s for writing", m_dumpFile.c_str());
+        return;
+    }
+
+    std::vector<std::string> lines;
+    BuildReport(lines, NUM_MSG_TYPES);
+
+    fprintf(file, "%s\n", TimeToTimestampStr(time(NULL)).c_str());
+    for (std::vector<std::string>::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+    {
+        fprintf(file, "%s\n", itr->c_str());
+    }
+
+    fclose(file);
+}
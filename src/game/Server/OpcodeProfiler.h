@@ -0,0 +1,116 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_OPCODEPROFILER_H
+#define MANGOS_OPCODEPROFILER_H
+
+#include "Common.h"
+#include "Opcodes.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <chrono>
+
+// Bucket i of the histogram counts the handler calls that took less than 2^i microseconds,
+// the last one also counts all slower calls
+#define OPCODE_PROFILE_BUCKETS 32
+
+#define MAX_PACKET_PROCESSING (PROCESS_SESSIONSAFE + 1)
+
+/// Aggregated values of \ref OpcodeProfileStats, times in microseconds
+struct OpcodeProfileSnapshot
+{
+    uint16 opcode;
+    uint64 count;
+    uint64 totalTime;
+    uint64 maxTime;
+    uint64 p50;                                             // upper bound of the bucket holding the median
+    uint64 p99;
+
+    uint64 GetAverageTime() const { return count ? totalTime / count : 0; }
+};
+
+/// Call count, time and latency histogram of the handler calls of one opcode or packet processing class
+struct OpcodeProfileStats
+{
+    OpcodeProfileStats() { Reset(); }
+
+    void Add(uint64 time);
+    void Reset();
+    OpcodeProfileSnapshot GetSnapshot() const;
+
+    std::atomic<uint64> count;
+    std::atomic<uint64> totalTime;
+    std::atomic<uint64> maxTime;
+    std::atomic<uint64> buckets[OPCODE_PROFILE_BUCKETS];
+};
+
+/**
+ * @brief Measures the time spent in the packet handlers, see \ref WorldSession::ExecuteOpcode
+ *
+ * The handlers run in the world thread, the session update threads and the map update
+ * threads, so all counters are atomics updated with relaxed ordering. The stats of an
+ * opcode are allocated on its first measured call. When profiling is disabled, the
+ * only cost per packet is one check of the enabled flag.
+ */
+class OpcodeProfiler
+{
+    public:
+
+        typedef std::chrono::steady_clock Clock;
+
+        OpcodeProfiler();
+        ~OpcodeProfiler();
+
+        bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+        void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+
+        /// File the report is written to by \ref DumpToFile, overwritten on each dump
+        void SetDumpFile(std::string const& fileName) { m_dumpFile = fileName; }
+
+        void AddHandlerTime(uint16 opcode, PacketProcessing packetProcessing, Clock::time_point start);
+
+        void Reset();
+
+        /// Appends the snapshots of the opcodes handled since the last reset, ordered by total time
+        void GetOpcodeSnapshots(std::vector<OpcodeProfileSnapshot>& snapshots) const;
+        OpcodeProfileSnapshot GetClassSnapshot(PacketProcessing packetProcessing) const;
+
+        /// Human readable report, one line per packet processing class followed by at most limit opcodes
+        void BuildReport(std::vector<std::string>& lines, uint32 limit) const;
+
+        void DumpToFile() const;
+
+    private:
+
+        std::atomic<bool> m_enabled;
+        std::string m_dumpFile;
+
+        OpcodeProfileStats m_classes[MAX_PACKET_PROCESSING];
+        std::atomic<OpcodeProfileStats*> m_opcodes[NUM_MSG_TYPES];
+};
+
+#define sOpcodeProfiler MaNGOS::Singleton<OpcodeProfiler>::Instance()
+
+#endif
@@ -575,7 +575,7 @@ enum OpcodesList
     SMSG_PLAY_SPELL_VISUAL                                = 0x55A5, // 4.3.4 15595
     CMSG_ZONEUPDATE                                       = 0x4F37, // 4.3.4 15595
     SMSG_PARTYKILLLOG                                     = 0x4937, // 4.3.4 15595
-    SMSG_COMPRESSED_UPDATE_OBJECT                         = 0x11F7,
+    SMSG_COMPRESSED_UPDATE_OBJECT                         = 0x11F7, // not verified for 4.3.4, see Compression.Threshold
     SMSG_EXPLORATION_EXPERIENCE                           = 0x6716, // 4.3.4 15595
     CMSG_GM_SET_SECURITY_GROUP                            = 0x11FA,
     CMSG_GM_NUKE                                          = 0x11FB,
@@ -1472,14 +1472,17 @@ enum SessionStatus
 /**
  * This determines how a \ref WorldPacket is handled by MaNGOS. This can be either in the
  * same function as we received it in, this is unusual, or it can be in:
- * - \ref World::UpdateSessions if it's not thread safe
+ * - \ref World::UpdateSessions if it's not thread safe, one session after the other
+ * - \ref World::UpdateSessions if it only touches its own session, concurrently with the
+ *   same packets of other sessions when SessionUpdateThreads is set
  * - \ref Map::Update if it is thread safe
  */
 enum PacketProcessing
 {
     PROCESS_INPLACE = 0,   ///< process packet whenever we receive it - mostly for non-handled or non-implemented packets
     PROCESS_THREADUNSAFE,  ///< packet is not thread-safe - process it in \ref World::UpdateSessions
-    PROCESS_THREADSAFE     ///< packet is thread-safe - process it in \ref Map::Update
+    PROCESS_THREADSAFE,    ///< packet is thread-safe - process it in \ref Map::Update
+    PROCESS_SESSIONSAFE    ///< packet handler reads static data and other players, but only changes its own session and player - process it in \ref World::UpdateSessions, concurrently for all sessions
 };
 
 class WorldPacket;
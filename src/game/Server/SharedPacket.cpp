@@ -0,0 +1,63 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "SharedPacket.h"
+#include "WorldPacket.h"
+
+#include <ace/Message_Block.h>
+#include <ace/Lock_Adapter_T.h>
+#include <ace/Thread_Mutex.h>
+
+/// The payloads are released on the network threads, so their reference count needs a lock.
+static ACE_Lock_Adapter<ACE_Thread_Mutex> s_SharedPayloadLock;
+
+SharedPacket::SharedPacket(WorldPacket const& packet) : m_packet(packet), m_payload(NULL)
+{
+    // the payload is frozen from here on
+    const_cast<WorldPacket&>(packet).FlushBits();
+
+    if (packet.size() < SHARED_PACKET_MIN_PAYLOAD)
+    {
+        return;
+    }
+
+    ACE_NEW(m_payload, ACE_Message_Block(packet.size(), ACE_Message_Block::MB_DATA, NULL, NULL, NULL, &s_SharedPayloadLock));
+    m_payload->copy((const char*)packet.contents(), packet.size());
+}
+
+SharedPacket::SharedPacket(SharedPacket const& other) : m_packet(other.m_packet), m_payload(NULL)
+{
+    if (other.m_payload)
+    {
+        m_payload = other.m_payload->duplicate();
+    }
+}
+
+SharedPacket::~SharedPacket()
+{
+    if (m_payload)
+    {
+        m_payload->release();
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/** \addtogroup u2w User to World Communication
+ * @{
+ * \file SharedPacket.h
+ */
+
+#ifndef MANGOS_H_SHAREDPACKET
+#define MANGOS_H_SHAREDPACKET
+
+#include "Common.h"
+
+class ACE_Message_Block;
+class WorldPacket;
+
+/// Payloads below this size are copied into each socket, that is cheaper than sharing them.
+#define SHARED_PACKET_MIN_PAYLOAD 512
+
+/**
+ * A packet sent the same way to many sessions.
+ *
+ * The payload is copied once into a reference counted block, and every
+ * WorldSocket queues a reference to that block behind its own encrypted
+ * header instead of copying the payload. The block is released once the
+ * last socket has sent it.
+ *
+ * The WorldPacket must outlive this object and must not change while it is
+ * being sent, hooks and logging still see it.
+ */
+class SharedPacket
+{
+    public:
+
+        explicit SharedPacket(WorldPacket const& packet);
+        SharedPacket(SharedPacket const& other);
+        ~SharedPacket();
+
+        WorldPacket const& GetPacket() const { return m_packet; }
+
+        /// Shared payload, NULL when the packet is small enough to be copied.
+        ACE_Message_Block const* GetPayload() const { return m_payload; }
+
+    private:
+
+        SharedPacket& operator=(SharedPacket const&);
+
+        WorldPacket const& m_packet;
+        ACE_Message_Block* m_payload;
+};
+
+#endif  /* MANGOS_H_SHAREDPACKET */
+
+/// @}
@@ -32,6 +32,8 @@
 #include "Log.h"
 #include "Opcodes.h"
 #include "WorldPacket.h"
+#include "SharedPacket.h"
+#include "OpcodeProfiler.h"
 #include "WorldSession.h"
 #include "Player.h"
 #include "ObjectMgr.h"
@@ -59,8 +61,8 @@
 // select opcodes appropriate for processing in Map::Update context for current session state
 static bool MapSessionFilterHelper(WorldSession* session, OpcodeHandler const& opHandle)
 {
-    // we do not process thread-unsafe packets
-    if (opHandle.packetProcessing == PROCESS_THREADUNSAFE)
+    // we do not process thread-unsafe packets, nor the session-safe ones which are processed in World::UpdateSessions()
+    if (opHandle.packetProcessing == PROCESS_THREADUNSAFE || opHandle.packetProcessing == PROCESS_SESSIONSAFE)
     {
         return false;
     }
@@ -104,6 +106,12 @@ bool WorldSessionFilter::Process(WorldPacket* packet)
     return !MapSessionFilterHelper(m_pSession, opHandle);
 }
 
+// only the session-safe packets at the head of the queue, the first other packet stops the concurrent update
+bool SessionSafeFilter::Process(WorldPacket* packet)
+{
+    return opcodeTable[packet->GetOpcode()].packetProcessing == PROCESS_SESSIONSAFE;
+}
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8 expansion, time_t mute_time, LocaleConstant locale) :
     m_muteTime(mute_time), _player(NULL), m_Socket(sock), _security(sec), _accountId(id), m_expansion(expansion), _logoutTime(0),
@@ -162,6 +170,51 @@ char const* WorldSession::GetPlayerName() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    WorldSocket* socket = AcquireSocket();
+
+    if (CanSendPacket(packet, socket) && socket->SendPacket(*packet) == -1)
+    {
+        socket->CloseSocket();
+    }
+
+    if (socket)
+    {
+        socket->RemoveReference();
+    }
+}
+
+/// Send a packet built once for many sessions, see SharedPacket
+void WorldSession::SendPacket(SharedPacket const& packet)
+{
+    WorldSocket* socket = AcquireSocket();
+
+    if (CanSendPacket(&packet.GetPacket(), socket) && socket->SendPacket(packet) == -1)
+    {
+        socket->CloseSocket();
+    }
+
+    if (socket)
+    {
+        socket->RemoveReference();
+    }
+}
+
+/// Get a reference on the socket, packets can be sent from the map threads while Update drops it
+WorldSocket* WorldSession::AcquireSocket()
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_socketLock, NULL);
+
+    if (m_Socket)
+    {
+        m_Socket->AddReference();
+    }
+
+    return m_Socket;
+}
+
+/// Hand the packet to the bots and check it can go to the socket
+bool WorldSession::CanSendPacket(WorldPacket const* packet, WorldSocket* socket)
 {
     if (GetPlayer()) {
        if (GetPlayer()->GetPlayerbotAI())
@@ -174,34 +227,36 @@ void WorldSession::SendPacket(WorldPacket const* packet)
        }
     }
 
-    if (!m_Socket)
+    if (!socket)
     {
-        return;
+        return false;
     }
 
     if (opcodeTable[packet->GetOpcode()].status == STATUS_UNHANDLED)
     {
         sLog.outError("SESSION: tried to send an unhandled opcode 0x%.4X", packet->GetOpcode());
-        return;
+        return false;
     }
 
     const_cast<WorldPacket*>(packet)->FlushBits();
 
 #ifdef MANGOS_DEBUG
 
-    // Code for network use statistic
-    static uint64 sendPacketCount = 0;
-    static uint64 sendPacketBytes = 0;
+    // Code for network use statistic, packets are sent from the map threads too
+    static std::atomic<uint64> sendPacketCount(0);
+    static std::atomic<uint64> sendPacketBytes(0);
 
-    static time_t firstTime = time(NULL);
-    static time_t lastTime = firstTime;                     // next 60 secs start time
+    static const time_t firstTime = time(NULL);
+    static std::atomic<time_t> lastTime(firstTime);         // next 60 secs start time
 
-    static uint64 sendLastPacketCount = 0;
-    static uint64 sendLastPacketBytes = 0;
+    static std::atomic<uint64> sendLastPacketCount(0);
+    static std::atomic<uint64> sendLastPacketBytes(0);
 
     time_t cur_time = time(NULL);
+    time_t last_time = lastTime;
 
-    if ((cur_time - lastTime) < 60)
+    // only the thread moving lastTime on reports, the others keep counting
+    if ((cur_time - last_time) < 60 || !lastTime.compare_exchange_strong(last_time, cur_time))
     {
         sendPacketCount += 1;
         sendPacketBytes += packet->size();
@@ -211,22 +266,22 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     }
     else
     {
-        uint64 minTime = uint64(cur_time - lastTime);
-        uint64 fullTime = uint64(lastTime - firstTime);
-        DETAIL_LOG("Send all time packets count: " UI64FMTD " bytes: " UI64FMTD " avr.count/sec: %f avr.bytes/sec: %f time: %u", sendPacketCount, sendPacketBytes, float(sendPacketCount) / fullTime, float(sendPacketBytes) / fullTime, uint32(fullTime));
-        DETAIL_LOG("Send last min packets count: " UI64FMTD " bytes: " UI64FMTD " avr.count/sec: %f avr.bytes/sec: %f", sendLastPacketCount, sendLastPacketBytes, float(sendLastPacketCount) / minTime, float(sendLastPacketBytes) / minTime);
+        uint64 minTime = uint64(cur_time - last_time);
+        uint64 fullTime = uint64(last_time - firstTime);
+        uint64 packetCount = sendPacketCount;
+        uint64 packetBytes = sendPacketBytes;
+        uint64 lastPacketCount = sendLastPacketCount;
+        uint64 lastPacketBytes = sendLastPacketBytes;
+        DETAIL_LOG("Send all time packets count: " UI64FMTD " bytes: " UI64FMTD " avr.count/sec: %f avr.bytes/sec: %f time: %u", packetCount, packetBytes, float(packetCount) / fullTime, float(packetBytes) / fullTime, uint32(fullTime));
+        DETAIL_LOG("Send last min packets count: " UI64FMTD " bytes: " UI64FMTD " avr.count/sec: %f avr.bytes/sec: %f", lastPacketCount, lastPacketBytes, float(lastPacketCount) / minTime, float(lastPacketBytes) / minTime);
 
-        lastTime = cur_time;
         sendLastPacketCount = 1;
         sendLastPacketBytes = packet->wpos();               // wpos is real written size
     }
 
 #endif                                                  // !MANGOS_DEBUG
 
-    if (m_Socket->SendPacket(*packet) == -1)
-    {
-        m_Socket->CloseSocket();
-    }
+    return true;
 }
 
 /// Add an incoming packet to the queue
@@ -256,6 +311,9 @@ void WorldSession::LogUnprocessedTail(WorldPacket* packet)
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(PacketFilter& updater)
 {
+    // keep the async character DB requests of this account in order
+    SqlAsyncAffinity dbAffinity(GetAccountId());
+
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
     WorldPacket* packet = NULL;
@@ -382,8 +440,15 @@ bool WorldSession::Update(PacketFilter& updater)
     ///- Cleanup socket pointer if need
     if (m_Socket && m_Socket->IsClosed())
     {
-        m_Socket->RemoveReference();
-        m_Socket = NULL;
+        WorldSocket* socket = m_Socket;
+
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_socketLock);
+            m_Socket = NULL;
+        }
+
+        // a sender still holding a reference keeps the socket alive until it is done
+        socket->RemoveReference();
     }
 
  // WARDEN ISSUE - commented out to stop crash
@@ -413,6 +478,12 @@ bool WorldSession::Update(PacketFilter& updater)
     return true;
 }
 
+bool WorldSession::CanUpdateConcurrently()
+{
+    // bot sessions have no socket, and the bot manager of a master inspects its packets
+    return m_Socket && !(_player && _player->GetPlayerbotMgr());
+}
+
 void WorldSession::HandleBotPackets()
 {
     WorldPacket* packet;
@@ -427,6 +498,9 @@ void WorldSession::HandleBotPackets()
 /// %Log the player out
 void WorldSession::LogoutPlayer(bool Save)
 {
+    // the logout save must be done before a later login of the account reads the character
+    SqlAsyncAffinity dbAffinity(GetAccountId());
+
     // finish pending transfers before starting the logout
     while (_player && _player->IsBeingTeleportedFar())
     {
@@ -1252,7 +1326,17 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
         _player->SetCanDelayTeleport(true);
     }
 
-    (this->*opHandle.handler)(*packet);
+    if (sOpcodeProfiler.IsEnabled())
+    {
+        uint16 opcode = packet->GetOpcode();
+        OpcodeProfiler::Clock::time_point start = OpcodeProfiler::Clock::now();
+        (this->*opHandle.handler)(*packet);
+        sOpcodeProfiler.AddHandlerTime(opcode, opHandle.packetProcessing, start);
+    }
+    else
+    {
+        (this->*opHandle.handler)(*packet);
+    }
 
     if (_player)
     {
@@ -42,6 +42,7 @@
 struct ItemPrototype;
 struct AuctionEntry;
 struct AuctionHouseEntry;
+class AuctionSorter;
 struct DeclinedName;
 
 class ObjectGuid;
@@ -52,6 +53,7 @@ class Player;
 class Unit;
 class Warden;
 class WorldPacket;
+class SharedPacket;
 class WorldSocket;
 class QueryResult;
 class LoginQueryHolder;
@@ -227,6 +229,22 @@ class WorldSessionFilter : public PacketFilter
         bool Process(WorldPacket* packet) override;
 };
 
+// class used to filter only the packets that change nothing but their own session
+// in order to update the sessions concurrently in World::UpdateSessions()
+class SessionSafeFilter : public PacketFilter
+{
+    public:
+        explicit SessionSafeFilter(WorldSession* pSession) : PacketFilter(pSession) {}
+        ~SessionSafeFilter() {}
+
+        bool Process(WorldPacket* packet) override;
+        // logout changes the world, it is left to the WorldSessionFilter pass
+        bool ProcessLogout() const override
+        {
+            return false;
+        }
+};
+
 /// Player session in the World
 class WorldSession
 {
@@ -256,6 +274,7 @@ class WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const* packet);
+        void SendPacket(SharedPacket const& packet);
         void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName* declinedName);
@@ -338,6 +357,8 @@ class WorldSession
         void QueuePacket(WorldPacket* new_packet);
 
         bool Update(PacketFilter& updater);
+        /// Whether the session-safe packets of this session can be processed by a WorldSessionUpdater thread
+        bool CanUpdateConcurrently();
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -411,8 +432,8 @@ class WorldSession
         void SendAuctionRemovedNotification(AuctionEntry* auction);
         static void SendAuctionOutbiddedMail(AuctionEntry* auction);
         void SendAuctionCancelledToBidderMail(AuctionEntry* auction);
-        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
-                                   uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull);
+        void BuildListAuctionItems(std::vector<AuctionEntry*>& auctions, WorldPacket& data, AuctionSorter const& sorter, uint32 listfrom, uint32 usable,
+                                   uint32& count, uint32& totalcount, bool isFull);
 
         AuctionHouseEntry const* GetCheckedAuctionHouseForAuctioneer(ObjectGuid guid);
 
@@ -989,6 +1010,8 @@ class WorldSession
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet);
+        bool CanSendPacket(WorldPacket const* packet, WorldSocket* socket);
+        WorldSocket* AcquireSocket();
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* reason);
@@ -997,6 +1020,7 @@ class WorldSession
         uint32 m_GUIDLow;                                   // set logged or recently logout player (while m_playerRecentlyLogout set)
         Player* _player;
         WorldSocket* m_Socket;
+        ACE_Thread_Mutex m_socketLock;                      // guards m_Socket against the update packet senders
         std::string m_Address;
 
         AccountTypes _security;
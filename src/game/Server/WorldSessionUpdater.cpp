@@ -0,0 +1,87 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "WorldSessionUpdater.h"
+#include "WorldSession.h"
+
+// Below this many sessions per batch the hand over to a worker costs more than it saves
+#define MIN_SESSIONS_PER_BATCH 32
+
+WorldSessionUpdater::WorldSessionUpdater() : m_numThreads(0)
+{
+}
+
+WorldSessionUpdater::~WorldSessionUpdater()
+{
+    deactivate();
+}
+
+int WorldSessionUpdater::activate(size_t num_threads)
+{
+    if (m_executor.activate(int(num_threads)) == -1)
+    {
+        return -1;
+    }
+
+    m_numThreads = num_threads;
+    return 0;
+}
+
+int WorldSessionUpdater::deactivate()
+{
+    m_numThreads = 0;
+    return m_executor.deactivate();
+}
+
+bool WorldSessionUpdater::activated()
+{
+    return m_executor.activated();
+}
+
+void WorldSessionUpdater::UpdateSessions(std::vector<WorldSession*>& sessions)
+{
+    size_t batches = activated() ? std::min(sessions.size() / MIN_SESSIONS_PER_BATCH, m_numThreads + 1) : 0;
+
+    if (batches < 2)
+    {
+        UpdateBatch(sessions.data(), sessions.size());
+        return;
+    }
+
+    m_executor.execute_slices(batches, [&sessions, batches](size_t i)
+    {
+        const size_t begin = i * sessions.size() / batches;
+        const size_t count = (i + 1) * sessions.size() / batches - begin;
+        UpdateBatch(sessions.data() + begin, count);
+    });
+}
+
+void WorldSessionUpdater::UpdateBatch(WorldSession* const* sessions, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        SessionSafeFilter updater(sessions[i]);
+        sessions[i]->Update(updater);
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_WORLDSESSIONUPDATER_H
+#define MANGOS_WORLDSESSIONUPDATER_H
+
+#include "Common.h"
+#include "Threading/DelayExecutor.h"
+
+class WorldSession;
+
+/**
+ * @brief Worker threads processing the session-safe packets of the world sessions.
+ *
+ * Before the sessions are updated one after the other, World::UpdateSessions hands
+ * them to UpdateSessions, which processes the PROCESS_SESSIONSAFE packets at the head
+ * of their queues. The sessions are split into batches, the world thread takes the
+ * first batch and waits until the workers are done with the others. The packets left
+ * behind are then processed by the serial pass, in order.
+ *
+ * Without worker threads (SessionUpdateThreads = 0) the serial pass does everything.
+ */
+class WorldSessionUpdater
+{
+    public:
+
+        WorldSessionUpdater();
+        ~WorldSessionUpdater();
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated();
+
+        /// Process the session-safe packets of every session, returns when all are done
+        void UpdateSessions(std::vector<WorldSession*>& sessions);
+
+        /// Process the session-safe packets of a batch of sessions in the current thread
+        static void UpdateBatch(WorldSession* const* sessions, size_t count);
+
+    private:
+
+        DelayExecutor m_executor;
+        size_t m_numThreads;
+};
+
+#endif
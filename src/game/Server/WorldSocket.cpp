@@ -29,7 +29,7 @@
 #include <ace/os_include/netinet/os_tcp.h>
 #include <ace/os_include/sys/os_types.h>
 #include <ace/os_include/sys/os_socket.h>
-#include <ace/OS_NS_string.h>
+#include <ace/OS_NS_sys_socket.h>
 #include <ace/Reactor.h>
 #include <ace/Auto_Ptr.h>
 
@@ -39,6 +39,7 @@
 #include "Util.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include "SharedPacket.h"
 #include "SharedDefines.h"
 #include "ByteBuffer.h"
 #include "Opcodes.h"
@@ -52,6 +53,13 @@
 #include "LuaEngine.h"
 #endif /* ENABLE_ELUNA */
 
+// Max number of buffers given to one writev call: the two parts of the ring and queued packets
+#if ACE_IOV_MAX < 64
+#define OUT_IOV_BATCH ACE_IOV_MAX
+#else
+#define OUT_IOV_BATCH 64
+#endif
+
 #if defined( __GNUC__ )
 #pragma pack(1)
 #else
@@ -113,8 +121,9 @@ WorldSocket::WorldSocket(void) :
     m_RecvWPct(0),
     m_RecvPct(),
     m_Header(sizeof(ClientPktHeader)),
-    m_OutBuffer(0),
+    m_OutBuffer(),
     m_OutBufferSize(65536),
+    m_OutQueuedPackets(0),
     m_OutActive(false),
     m_Seed(rand32())
 {
@@ -128,11 +137,6 @@ WorldSocket::~WorldSocket(void)
 {
     delete m_RecvWPct;
 
-    if (m_OutBuffer)
-    {
-        m_OutBuffer->release();
-    }
-
     closing_ = true;
 
     peer().close();
@@ -164,6 +168,16 @@ const std::string& WorldSocket::GetRemoteAddress(void) const
 }
 
 int WorldSocket::SendPacket(const WorldPacket& pct)
+{
+    return send_packet(pct, NULL);
+}
+
+int WorldSocket::SendPacket(const SharedPacket& pct)
+{
+    return send_packet(pct.GetPacket(), pct.GetPayload());
+}
+
+int WorldSocket::send_packet(const WorldPacket& pct, const ACE_Message_Block* sharedPayload)
 {
     ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
 
@@ -188,44 +202,71 @@ int WorldSocket::SendPacket(const WorldPacket& pct)
     ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
     m_Crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
 
-    if (m_OutBuffer->space() >= pct.size() + header.getHeaderLength() && msg_queue()->is_empty())
+    if (sharedPayload)
     {
-        // Put the packet on the buffer.
-        if (m_OutBuffer->copy((char*) header.header, header.getHeaderLength()) == -1)
+        // Only the header is ours, the payload follows it in the queue, so nothing
+        // else may enter the ring until the queue is drained.
+        if (m_OutQueuedPackets != 0 || !m_OutBuffer.Write(header.header, header.getHeaderLength(), NULL, 0))
         {
-            MANGOS_ASSERT(false);
-        }
+            ACE_Message_Block* hb;
 
-        if (!pct.empty())
-        {
-            if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
-            {
-                MANGOS_ASSERT(false);
-            }
-        }
-    }
-    else
-    {
-        // Enqueue the packet.
-        ACE_Message_Block* mb;
+            ACE_NEW_RETURN(hb, ACE_Message_Block(header.getHeaderLength()), -1);
 
-        ACE_NEW_RETURN(mb, ACE_Message_Block(pct.size() + header.getHeaderLength()), -1);
+            hb->copy((char*) header.header, header.getHeaderLength());
 
-        mb->copy((char*) header.header, header.getHeaderLength());
+            if (msg_queue()->enqueue_tail(hb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
+            {
+                sLog.outError("WorldSocket::SendPacket enqueue_tail");
+                hb->release();
+                return -1;
+            }
 
-        if (!pct.empty())
-        {
-            mb->copy((const char*)pct.contents(), pct.size());
+            ++m_OutQueuedPackets;
         }
 
-        if (msg_queue()->enqueue_tail(mb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
+        // A new block over the same data, with its own read pointer.
+        ACE_Message_Block* pb = sharedPayload->duplicate();
+
+        if (msg_queue()->enqueue_tail(pb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
         {
             sLog.outError("WorldSocket::SendPacket enqueue_tail");
-            mb->release();
+            pb->release();
             return -1;
         }
+
+        ++m_OutQueuedPackets;
+
+        return 0;
     }
 
+    // Put the packet on the ring, unless older packets are still waiting in the queue.
+    if (m_OutQueuedPackets == 0 &&
+        m_OutBuffer.Write(header.header, header.getHeaderLength(), pct.empty() ? NULL : pct.contents(), pct.size()))
+    {
+        return 0;
+    }
+
+    // Enqueue the packet.
+    ACE_Message_Block* mb;
+
+    ACE_NEW_RETURN(mb, ACE_Message_Block(pct.size() + header.getHeaderLength()), -1);
+
+    mb->copy((char*) header.header, header.getHeaderLength());
+
+    if (!pct.empty())
+    {
+        mb->copy((const char*)pct.contents(), pct.size());
+    }
+
+    if (msg_queue()->enqueue_tail(mb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
+    {
+        sLog.outError("WorldSocket::SendPacket enqueue_tail");
+        mb->release();
+        return -1;
+    }
+
+    ++m_OutQueuedPackets;
+
     return 0;
 }
 
@@ -244,7 +285,7 @@ int WorldSocket::open(void* a)
     ACE_UNUSED_ARG(a);
 
     // Prevent double call to this func.
-    if (m_OutBuffer)
+    if (m_OutBuffer.IsInitialized())
     {
         return -1;
     }
@@ -260,7 +301,7 @@ int WorldSocket::open(void* a)
     }
 
     // Allocate the buffer.
-    ACE_NEW_RETURN(m_OutBuffer, ACE_Message_Block(m_OutBufferSize), -1);
+    m_OutBuffer.Initialize(m_OutBufferSize);
 
     // Store peer address.
     ACE_INET_Addr remote_addr;
@@ -368,119 +409,158 @@ int WorldSocket::handle_input(ACE_HANDLE)
 
 int WorldSocket::handle_output(ACE_HANDLE)
 {
-    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+    ACE_GUARD_RETURN(LockType, Guard, m_OutSendLock, -1);
 
     if (closing_)
     {
         return -1;
     }
 
-    const size_t send_len = m_OutBuffer->length();
+    return handle_output_pending(Guard);
+}
 
-    if (send_len == 0)
-    {
-        return handle_output_queue(Guard);
-    }
+int WorldSocket::handle_output_pending(GuardType& g)
+{
+    iovec iov[OUT_IOV_BATCH];
+    size_t iovCount = 0;
 
-#ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
-#else
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
-#endif // MSG_NOSIGNAL
+    ACE_Message_Block* blocks[OUT_IOV_BATCH];
+    size_t blockCount = 0;
 
-    if (n == 0)
+    size_t ringLen;
+    size_t total;
+
+    if (m_OutQueuedPackets == 0)
     {
-        return -1;
+        // Only the ring, the producers may keep appending to it meanwhile.
+        ringLen = m_OutBuffer.Peek(iov, iovCount);
+        total = ringLen;
     }
-    else if (n == -1)
+    else
     {
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
+        // The producers do not touch the ring while packets are queued,
+        // so all of it goes out before the queued packets.
+        ACE_GUARD_RETURN(LockType, OutGuard, m_OutBufferLock, -1);
+
+        ringLen = m_OutBuffer.Peek(iov, iovCount);
+        total = ringLen;
+
+        while (iovCount < OUT_IOV_BATCH && !msg_queue()->is_empty())
         {
-            return schedule_wakeup_output(Guard);
-        }
+            ACE_Message_Block* mblk;
 
-        return -1;
-    }
-    else if (n < (ssize_t)send_len) // now n > 0
-    {
-        m_OutBuffer->rd_ptr(static_cast<size_t>(n));
+            if (msg_queue()->dequeue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
+            {
+                sLog.outError("WorldSocket::handle_output_pending dequeue_head");
+                break;
+            }
 
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
+            blocks[blockCount++] = mblk;
 
-        return schedule_wakeup_output(Guard);
-    }
-    else // now n == send_len
-    {
-        m_OutBuffer->reset();
+            iov[iovCount].iov_base = mblk->rd_ptr();
+            iov[iovCount].iov_len = mblk->length();
+            ++iovCount;
 
-        return handle_output_queue(Guard);
+            total += mblk->length();
+        }
     }
 
-    ACE_NOTREACHED(return 0);
-}
-
-int WorldSocket::handle_output_queue(GuardType& g)
-{
-    if (msg_queue()->is_empty())
+    if (iovCount == 0)
     {
         return cancel_wakeup_output(g);
     }
 
-    ACE_Message_Block* mblk;
+#ifdef MSG_NOSIGNAL
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovCount;
+
+    ssize_t n = ACE_OS::sendmsg(get_handle(), &msg, MSG_NOSIGNAL);
+#else
+    ssize_t n = peer().sendv(iov, int(iovCount));
+#endif // MSG_NOSIGNAL
+
+    size_t sent = n > 0 ? static_cast<size_t>(n) : 0;
 
-    if (msg_queue()->dequeue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
+    const size_t ringSent = std::min(sent, ringLen);
+    m_OutBuffer.Consume(ringSent);
+    sent -= ringSent;
+
+    if (requeue_overflow(blocks, blockCount, sent) == -1)
     {
-        sLog.outError("WorldSocket::handle_output_queue dequeue_head");
         return -1;
     }
 
-    const size_t send_len = mblk->length();
-
-#ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(mblk->rd_ptr(), send_len, MSG_NOSIGNAL);
-#else
-    ssize_t n = peer().send(mblk->rd_ptr(), send_len);
-#endif // MSG_NOSIGNAL
-
     if (n == 0)
     {
-        mblk->release();
-
         return -1;
     }
     else if (n == -1)
     {
         if (errno == EWOULDBLOCK || errno == EAGAIN)
         {
-            msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero);
             return schedule_wakeup_output(g);
         }
 
-        mblk->release();
         return -1;
     }
-    else if (n < (ssize_t)send_len) // now n > 0
+
+    if (static_cast<size_t>(n) < total)
+    {
+        return schedule_wakeup_output(g);
+    }
+
+    // everything we had is sent, keep going while the producers added more
+    return (m_OutBuffer.IsEmpty() && m_OutQueuedPackets == 0) ? cancel_wakeup_output(g) : ACE_Event_Handler::WRITE_MASK;
+}
+
+int WorldSocket::requeue_overflow(ACE_Message_Block** blocks, size_t count, size_t sent)
+{
+    if (!count)
+    {
+        return 0;
+    }
+
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    size_t done = 0;
+
+    for (; done < count; ++done)
     {
-        mblk->rd_ptr(static_cast<size_t>(n));
+        const size_t len = blocks[done]->length();
 
-        if (msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero) == -1)
+        if (sent < len)
         {
-            sLog.outError("WorldSocket::handle_output_queue enqueue_head");
-            mblk->release();
-            return -1;
+            blocks[done]->rd_ptr(sent);
+            break;
         }
 
-        return schedule_wakeup_output(g);
+        sent -= len;
+        blocks[done]->release();
     }
-    else // now n == send_len
+
+    m_OutQueuedPackets -= done;
+
+    // back to the head of the queue, in their original order
+    for (size_t i = count; i > done; --i)
     {
-        mblk->release();
+        if (msg_queue()->enqueue_head(blocks[i - 1], (ACE_Time_Value*) &ACE_Time_Value::zero) == -1)
+        {
+            sLog.outError("WorldSocket::requeue_overflow enqueue_head");
+
+            for (size_t j = done; j < i; ++j)
+            {
+                blocks[j]->release();
+            }
 
-        return msg_queue()->is_empty() ? cancel_wakeup_output(g) : ACE_Event_Handler::WRITE_MASK;
+            m_OutQueuedPackets -= i - done;
+
+            return -1;
+        }
     }
 
-    ACE_NOTREACHED(return -1);
+    return 0;
 }
 
 int WorldSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
@@ -515,7 +595,7 @@ int WorldSocket::Update(void)
         return -1;
     }
 
-    if (m_OutActive || (m_OutBuffer->length() == 0 && msg_queue()->is_empty()))
+    if (m_OutActive || (m_OutBuffer.IsEmpty() && m_OutQueuedPackets == 0))
     {
         return 0;
     }
@@ -49,9 +49,11 @@
 #include "Common.h"
 #include "Auth/AuthCrypt.h"
 #include "Auth/BigNumber.h"
+#include "WorldSocketSendRing.h"
 
 class ACE_Message_Block;
 class WorldPacket;
+class SharedPacket;
 class WorldSession;
 class WorldSocket;
 
@@ -66,11 +68,16 @@ typedef ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR > WorldAcceptor;
  * Most methods return -1 on failure.
  * The class uses reference counting.
  *
- * For output the class uses one buffer (64K usually) and
- * a queue where it stores packet if there is no space left on
- * the buffer. The reason this is done, is because the server
+ * For output the class uses one preallocated ring (64K usually) and
+ * a queue where it stores packet if there is no space left in
+ * the ring. The reason this is done, is because the server
  * does really a lot of small-size writes to it, and it doesn't
- * scale well to allocate memory for every. When something is
+ * scale well to allocate memory for every. The producers only
+ * hold m_OutBufferLock while copying into the ring, the network
+ * thread sends from it without that lock, gathering everything
+ * pending (ring and queued packets) in one writev call. Broadcast packets
+ * (see SharedPacket) only put their header there, their payload is queued
+ * as a reference to a block shared by all recipients. When something is
  * written to the output buffer the socket is not immediately
  * activated for output (again for the same reason), there
  * is 10ms celling (thats why there is Update() override method).
@@ -120,6 +127,11 @@ class WorldSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket(const WorldPacket& pct);
 
+        /// Send a broadcast packet, its payload is queued by reference instead of copied.
+        /// @param pct packet to send
+        /// @return -1 of failure
+        int SendPacket(const SharedPacket& pct);
+
         /// Add reference to this object.
         long AddReference(void);
 
@@ -162,12 +174,22 @@ class WorldSocket : protected WorldHandler
         int handle_input_missing_data(void);
 
         /// Help functions to mark/unmark the socket for output.
-        /// @param g the guard is for m_OutBufferLock, the function will release it
+        /// @param g the guard is for m_OutSendLock, the function will release it
         int cancel_wakeup_output(GuardType& g);
         int schedule_wakeup_output(GuardType& g);
 
-        /// Drain the queue if its not empty.
-        int handle_output_queue(GuardType& g);
+        /// Send everything pending in the ring and the overflow queue.
+        /// @param g the guard is for m_OutSendLock
+        int handle_output_pending(GuardType& g);
+
+        /// Encrypt the header and put the packet on the ring or the overflow queue.
+        /// @param sharedPayload if not NULL queued by reference in place of the packet contents
+        /// @return -1 on failure
+        int send_packet(const WorldPacket& pct, const ACE_Message_Block* sharedPayload);
+
+        /// Put back the overflow blocks not (completely) sent by handle_output_pending().
+        /// @return -1 on failure
+        int requeue_overflow(ACE_Message_Block** blocks, size_t count, size_t sent);
 
         /// process one incoming packet.
         /// @param new_pct received packet ,note that you need to delete it.
@@ -209,15 +231,22 @@ class WorldSocket : protected WorldHandler
         /// Fragment of the received header.
         ACE_Message_Block m_Header;
 
-        /// Mutex for protecting output related data.
+        /// Mutex serializing the producers of output and protecting the overflow queue.
         LockType m_OutBufferLock;
 
-        /// Buffer used for writing output.
-        ACE_Message_Block* m_OutBuffer;
+        /// Mutex serializing the threads sending the output (reactor and Update()).
+        LockType m_OutSendLock;
+
+        /// Ring used for writing output.
+        WorldSocketSendRing m_OutBuffer;
 
         /// Size of the m_OutBuffer.
         size_t m_OutBufferSize;
 
+        /// Number of packets waiting in the overflow queue (msg_queue()),
+        /// while non zero new packets go to the queue too, to keep them in order.
+        std::atomic<size_t> m_OutQueuedPackets;
+
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
@@ -0,0 +1,163 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+/** \addtogroup u2w User to World Communication
+ * @{
+ * \file WorldSocketSendRing.h
+ */
+
+#ifndef MANGOS_H_WORLDSOCKETSENDRING
+#define MANGOS_H_WORLDSOCKETSENDRING
+
+#include <ace/os_include/sys/os_uio.h>
+
+#include "Common.h"
+
+#include <atomic>
+
+/**
+ * Preallocated byte ring holding the encoded packets of one WorldSocket.
+ *
+ * There must be only one writer and one reader at a time. The writer side
+ * is serialized by WorldSocket::m_OutBufferLock, because packet headers are
+ * encrypted with a stream cipher and so have to enter the ring in the order
+ * they were encrypted. The reader side is the network thread flushing the
+ * socket. The reader never takes the writer lock to get the pending bytes.
+ *
+ * The read and write positions only grow. Their difference is the number of
+ * bytes pending, and the position modulo the capacity is the offset in
+ * the buffer.
+ */
+class WorldSocketSendRing
+{
+    public:
+
+        WorldSocketSendRing() : m_buffer(NULL), m_capacity(0), m_readPos(0), m_writePos(0) {}
+        ~WorldSocketSendRing() { delete[] m_buffer; }
+
+        /// Allocate the buffer, must be called once before the socket is used.
+        void Initialize(size_t capacity)
+        {
+            MANGOS_ASSERT(!m_buffer && capacity > 0);
+
+            m_buffer = new uint8[capacity];
+            m_capacity = capacity;
+        }
+
+        bool IsInitialized() const { return m_buffer != NULL; }
+
+        /// Writer side, copy a header and its payload or nothing at all.
+        bool Write(const uint8* header, size_t headerLen, const uint8* data, size_t dataLen)
+        {
+            const size_t writePos = m_writePos.load(std::memory_order_relaxed);
+            const size_t pending = writePos - m_readPos.load(std::memory_order_acquire);
+
+            if (m_capacity - pending < headerLen + dataLen)
+            {
+                return false;
+            }
+
+            CopyIn(writePos, header, headerLen);
+
+            if (dataLen)
+            {
+                CopyIn(writePos + headerLen, data, dataLen);
+            }
+
+            // publish the packet to the reader only once it is complete
+            m_writePos.store(writePos + headerLen + dataLen, std::memory_order_release);
+            return true;
+        }
+
+        /// Reader side, describe the pending bytes with up to two iovecs (the buffer may wrap).
+        /// @return number of bytes described
+        size_t Peek(iovec* iov, size_t& iovCount) const
+        {
+            const size_t readPos = m_readPos.load(std::memory_order_relaxed);
+            const size_t pending = m_writePos.load(std::memory_order_acquire) - readPos;
+
+            if (!pending)
+            {
+                return 0;
+            }
+
+            const size_t offset = readPos % m_capacity;
+            const size_t first = std::min(pending, m_capacity - offset);
+
+            iov[iovCount].iov_base = (char*)(m_buffer + offset);
+            iov[iovCount].iov_len = first;
+            ++iovCount;
+
+            if (first < pending)
+            {
+                iov[iovCount].iov_base = (char*)m_buffer;
+                iov[iovCount].iov_len = pending - first;
+                ++iovCount;
+            }
+
+            return pending;
+        }
+
+        /// Reader side, drop bytes that were sent.
+        void Consume(size_t len)
+        {
+            m_readPos.store(m_readPos.load(std::memory_order_relaxed) + len, std::memory_order_release);
+        }
+
+        bool IsEmpty() const
+        {
+            return m_writePos.load(std::memory_order_acquire) == m_readPos.load(std::memory_order_acquire);
+        }
+
+    private:
+
+        WorldSocketSendRing(const WorldSocketSendRing&);
+        WorldSocketSendRing& operator=(const WorldSocketSendRing&);
+
+        void CopyIn(size_t pos, const uint8* src, size_t len)
+        {
+            const size_t offset = pos % m_capacity;
+            const size_t first = std::min(len, m_capacity - offset);
+
+            memcpy(m_buffer + offset, src, first);
+
+            if (first < len)
+            {
+                memcpy(m_buffer, src + first, len - first);
+            }
+        }
+
+        uint8* m_buffer;
+        size_t m_capacity;
+
+        /// Only written by the reader.
+        std::atomic<size_t> m_readPos;
+
+        /// Only written by the writer.
+        std::atomic<size_t> m_writePos;
+};
+
+#endif  /* MANGOS_H_WORLDSOCKETSENDRING */
+
+/// @}
@@ -715,19 +715,6 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     // always return pointer
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(auctionHouseEntry);
 
-    // Sort
-    AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
-    std::vector<AuctionEntry*> auctions;
-    auctions.reserve(aucs.size());
-
-    for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = aucs.begin(); itr != aucs.end(); ++itr)
-    {
-        auctions.push_back(itr->second);
-    }
-
-    AuctionSorter sorter(Sort, GetPlayer());
-    std::sort(auctions.begin(), auctions.end(), sorter);
-
     // DEBUG_LOG("Auctionhouse search %s list from: %u, searchedname: %s, levelmin: %u, levelmax: %u, auctionSlotID: %u, auctionMainCategory: %u, auctionSubCategory: %u, quality: %u, usable: %u",
     //  auctioneerGuid.GetString().c_str(), listfrom, searchedname.c_str(), levelmin, levelmax, auctionSlotID, auctionMainCategory, auctionSubCategory, quality, usable);
 
@@ -736,17 +723,43 @@ void WorldSession::HandleAuctionListItems(WorldPacket& recv_data)
     uint32 totalcount = 0;
     data << uint32(0);
 
-    // converting string that we try to find to lower case
-    std::wstring wsearchedname;
-    if (!Utf8toWStr(searchedname, wsearchedname))
+    std::vector<AuctionEntry*> auctions;
+
+    if (isFull)
     {
-        return;
+        AuctionHouseObject::AuctionEntryMap const& aucs = auctionHouse->GetAuctions();
+        auctions.reserve(aucs.size());
+
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = aucs.begin(); itr != aucs.end(); ++itr)
+        {
+            auctions.push_back(itr->second);
+        }
     }
+    else
+    {
+        AuctionSearchFilter filter;
 
-    wstrToLower(wsearchedname);
+        // converting string that we try to find to lower case
+        if (!Utf8toWStr(searchedname, filter.searchedName))
+        {
+            return;
+        }
 
-    BuildListAuctionItems(auctions, data, wsearchedname, listfrom, levelmin, levelmax, usable,
-                          auctionSlotID, auctionMainCategory, auctionSubCategory, quality, count, totalcount, isFull);
+        wstrToLower(filter.searchedName);
+
+        filter.levelmin = levelmin;
+        filter.levelmax = levelmax;
+        filter.inventoryType = auctionSlotID;
+        filter.itemClass = auctionMainCategory;
+        filter.itemSubClass = auctionSubCategory;
+        filter.quality = quality;
+        filter.locale = GetSessionDbLocaleIndex();
+
+        auctionHouse->SearchAuctions(filter, auctions);
+    }
+
+    AuctionSorter sorter(Sort, GetPlayer());
+    BuildListAuctionItems(auctions, data, sorter, listfrom, usable, count, totalcount, isFull);
 
     data.put<uint32>(0, count);
     data << uint32(totalcount);
@@ -26,6 +26,7 @@
 #include "ObjectMgr.h"
 #include "World.h"
 #include "SocialMgr.h"
+#include "SharedPacket.h"
 #include "Chat.h"
 
 Channel::Channel(const std::string& name, uint32 channel_id)
@@ -717,13 +718,15 @@ void Channel::Invite(Player* player, const char* targetName)
 
 void Channel::SendToAll(WorldPacket* data, ObjectGuid guid)
 {
+    SharedPacket shared(*data);
+
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
     {
         if (Player* plr = sObjectMgr.GetPlayer(i->first))
         {
             if (!guid || !plr->GetSocial()->HasIgnore(guid))
             {
-                plr->GetSession()->SendPacket(data);
+                plr->GetSession()->SendPacket(shared);
             }
         }
     }
@@ -35,6 +35,9 @@
 #include "World.h"
 #include "Policies/Singleton.h"
 #include "Util.h"
+#include "Timer.h"
+
+#include <ace/Mem_Map.h>
 
 #include <mutex>
 
@@ -72,6 +75,8 @@ GridMap::GridMap()
     m_liquidFlags = NULL;
     m_liquidEntry = NULL;
     m_liquid_map  = NULL;
+
+    m_mappedFile = NULL;
 }
 
 GridMap::~GridMap()
@@ -84,6 +89,12 @@ bool GridMap::loadData(char* filename)
     // Unload old data if exist
     unloadData();
 
+    // the pages of a mapped file are shared by all processes using it, and read on first access
+    if (mapData(filename))
+    {
+        return true;
+    }
+
     GridMapFileHeader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -132,12 +143,20 @@ bool GridMap::loadData(char* filename)
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    if (m_mappedFile)
+    {
+        delete m_mappedFile;
+        m_mappedFile = NULL;
+    }
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquid_map;
+    }
 
     m_area_map = NULL;
     m_V9 = NULL;
@@ -148,6 +167,175 @@ void GridMap::unloadData()
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
+// point an array into the mapped file, fails when it is cut or not aligned for its type
+template<typename T>
+static bool MapArray(const uint8* file, size_t fileSize, size_t& pos, size_t count, T*& array)
+{
+    if (pos + count * sizeof(T) > fileSize || (size_t(file + pos) % alignof(T)) != 0)
+    {
+        return false;
+    }
+
+    array = (T*)(file + pos);
+    pos += count * sizeof(T);
+    return true;
+}
+
+template<typename T>
+static bool ReadMappedHeader(const uint8* file, size_t fileSize, uint32 offset, T& header)
+{
+    if (size_t(offset) + sizeof(T) > fileSize)
+    {
+        return false;
+    }
+
+    memcpy(&header, file + offset, sizeof(T));
+    return true;
+}
+
+bool GridMap::mapData(const char* filename)
+{
+    ACE_Mem_Map* mapping = new ACE_Mem_Map();
+    if (mapping->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_SHARED) != 0)
+    {
+        delete mapping;
+        return false;
+    }
+
+    // the mapping stays valid without the descriptor, do not hold one per loaded grid
+    mapping->close_handle();
+
+    // unloadData drops the mapping if any section can not be used in place
+    m_mappedFile = mapping;
+
+    const uint8* file = static_cast<const uint8*>(mapping->addr());
+    const size_t fileSize = mapping->size();
+
+    GridMapFileHeader header;
+    if (!ReadMappedHeader(file, fileSize, 0, header) ||
+            header.mapMagic != *((uint32 const*)(MAP_MAGIC)) ||
+            header.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)) ||
+            !IsAcceptableClientBuild(header.buildMagic))
+    {
+        // the read below reports the bad version
+        unloadData();
+        return false;
+    }
+
+    if ((header.areaMapOffset && !mapAreaData(file, fileSize, header.areaMapOffset)) ||
+            (header.heightMapOffset && !mapHeightData(file, fileSize, header.heightMapOffset)) ||
+            (header.liquidMapOffset && !mapGridMapLiquidData(file, fileSize, header.liquidMapOffset)))
+    {
+        unloadData();
+        return false;
+    }
+
+#ifdef MADV_WILLNEED
+    // start reading the pages in the background, the grid is about to be used
+    mapping->advise(MADV_WILLNEED);
+#endif
+    return true;
+}
+
+bool GridMap::mapAreaData(const uint8* file, size_t fileSize, uint32 offset)
+{
+    GridMapAreaHeader header;
+    if (!ReadMappedHeader(file, fileSize, offset, header) || header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+    {
+        return false;
+    }
+
+    m_gridArea = header.gridArea;
+
+    size_t pos = offset + sizeof(header);
+    if (!(header.flags & MAP_AREA_NO_AREA) && !MapArray(file, fileSize, pos, 16 * 16, m_area_map))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool GridMap::mapHeightData(const uint8* file, size_t fileSize, uint32 offset)
+{
+    GridMapHeightHeader header;
+    if (!ReadMappedHeader(file, fileSize, offset, header) || header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+    {
+        return false;
+    }
+
+    m_gridHeight = header.gridHeight;
+
+    size_t pos = offset + sizeof(header);
+    if (header.flags & MAP_HEIGHT_NO_HEIGHT)
+    {
+        m_gridGetHeight = &GridMap::getHeightFromFlat;
+    }
+    else if (header.flags & MAP_HEIGHT_AS_INT16)
+    {
+        if (!MapArray(file, fileSize, pos, 129 * 129, m_uint16_V9) || !MapArray(file, fileSize, pos, 128 * 128, m_uint16_V8))
+        {
+            return false;
+        }
+
+        m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
+        m_gridGetHeight = &GridMap::getHeightFromUint16;
+    }
+    else if (header.flags & MAP_HEIGHT_AS_INT8)
+    {
+        if (!MapArray(file, fileSize, pos, 129 * 129, m_uint8_V9) || !MapArray(file, fileSize, pos, 128 * 128, m_uint8_V8))
+        {
+            return false;
+        }
+
+        m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
+        m_gridGetHeight = &GridMap::getHeightFromUint8;
+    }
+    else
+    {
+        if (!MapArray(file, fileSize, pos, 129 * 129, m_V9) || !MapArray(file, fileSize, pos, 128 * 128, m_V8))
+        {
+            return false;
+        }
+
+        m_gridGetHeight = &GridMap::getHeightFromFloat;
+    }
+
+    return true;
+}
+
+bool GridMap::mapGridMapLiquidData(const uint8* file, size_t fileSize, uint32 offset)
+{
+    GridMapLiquidHeader header;
+    if (!ReadMappedHeader(file, fileSize, offset, header) || header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+    {
+        return false;
+    }
+
+    m_liquidType    = header.liquidType;
+    m_liquid_offX   = header.offsetX;
+    m_liquid_offY   = header.offsetY;
+    m_liquid_width  = header.width;
+    m_liquid_height = header.height;
+    m_liquidLevel   = header.liquidLevel;
+
+    size_t pos = offset + sizeof(header);
+    if (!(header.flags & MAP_LIQUID_NO_TYPE))
+    {
+        if (!MapArray(file, fileSize, pos, 16 * 16, m_liquidEntry) || !MapArray(file, fileSize, pos, 16 * 16, m_liquidFlags))
+        {
+            return false;
+        }
+    }
+
+    if (!(header.flags & MAP_LIQUID_NO_HEIGHT) && !MapArray(file, fileSize, pos, m_liquid_width * m_liquid_height, m_liquid_map))
+    {
+        return false;
+    }
+
+    return true;
+}
+
 bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
 {
     GridMapAreaHeader header;
@@ -525,6 +713,91 @@ float GridMap::getHeightFromUint16(float x, float y) const
     return (float)((a * x) + (b * y) + c) * m_gridIntHeightMultiplier + m_gridHeight;
 }
 
+// Same interpolation as the getHeightFrom* functions, for a batch of points.
+// The triangle is selected without branches so the loop can be vectorized.
+template<typename T>
+static void InterpolateHeights(const T* V9, const T* V8, const float* x, const float* y, float* heights, uint32 count,
+                               float multiplier, float offset)
+{
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float fx = MAP_RESOLUTION * (32 - x[i] / SIZE_OF_GRIDS);
+        float fy = MAP_RESOLUTION * (32 - y[i] / SIZE_OF_GRIDS);
+
+        int x_int = (int)fx;
+        int y_int = (int)fy;
+        fx -= x_int;
+        fy -= y_int;
+        x_int &= (MAP_RESOLUTION - 1);
+        y_int &= (MAP_RESOLUTION - 1);
+
+        const T* V9_h1_ptr = &V9[x_int * 129 + y_int];
+        float h1 = float(V9_h1_ptr[  0]);
+        float h2 = float(V9_h1_ptr[129]);
+        float h3 = float(V9_h1_ptr[  1]);
+        float h4 = float(V9_h1_ptr[130]);
+        float h5 = 2 * float(V8[x_int * 128 + y_int]);
+
+        // triangles 1 to 4, see getHeightFromFloat
+        bool lower = fx + fy < 1;
+        bool right = fx > fy;
+        float a = lower ? (right ? h2 - h1 : h5 - h1 - h3) : (right ? h2 + h4 - h5 : h4 - h3);
+        float b = lower ? (right ? h5 - h1 - h2 : h3 - h1) : (right ? h4 - h2 : h3 + h4 - h5);
+        float c = lower ? h1 : h5 - h4;
+
+        heights[i] = (a * fx + b * fy + c) * multiplier + offset;
+    }
+}
+
+void GridMap::getHeights(const float* x, const float* y, float* heights, uint32 count) const
+{
+    if (m_gridGetHeight == &GridMap::getHeightFromUint8)
+    {
+        if (!m_uint8_V8 || !m_uint8_V9)
+        {
+            std::fill(heights, heights + count, m_gridHeight);
+            return;
+        }
+
+        InterpolateHeights(m_uint8_V9, m_uint8_V8, x, y, heights, count, m_gridIntHeightMultiplier, m_gridHeight);
+    }
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint16)
+    {
+        if (!m_uint16_V8 || !m_uint16_V9)
+        {
+            std::fill(heights, heights + count, m_gridHeight);
+            return;
+        }
+
+        InterpolateHeights(m_uint16_V9, m_uint16_V8, x, y, heights, count, m_gridIntHeightMultiplier, m_gridHeight);
+    }
+    else if (m_gridGetHeight == &GridMap::getHeightFromFloat)
+    {
+        if (!m_V8 || !m_V9)
+        {
+            std::fill(heights, heights + count, INVALID_HEIGHT_VALUE);
+            return;
+        }
+
+        InterpolateHeights(m_V9, m_V8, x, y, heights, count, 1.0f, 0.0f);
+
+        // only the float format knows about holes
+        for (uint32 i = 0; i < count; ++i)
+        {
+            int x_int = int(MAP_RESOLUTION * (32 - x[i] / SIZE_OF_GRIDS)) & (MAP_RESOLUTION - 1);
+            int y_int = int(MAP_RESOLUTION * (32 - y[i] / SIZE_OF_GRIDS)) & (MAP_RESOLUTION - 1);
+            if (isHole(x_int, y_int))
+            {
+                heights[i] = INVALID_HEIGHT_VALUE;
+            }
+        }
+    }
+    else
+    {
+        std::fill(heights, heights + count, m_gridHeight);
+    }
+}
+
 float GridMap::getLiquidLevel(float x, float y)
 {
     if (!m_liquid_map)
@@ -769,6 +1042,11 @@ TerrainInfo::~TerrainInfo()
             delete m_GridMaps[i][k];
         }
 
+    for (PrefetchedGridMaps::iterator itr = m_PrefetchedGridMaps.begin(); itr != m_PrefetchedGridMaps.end(); ++itr)
+    {
+        delete itr->second.map;
+    }
+
     VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId);
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
 }
@@ -840,9 +1118,64 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
         }
     }
 
+    // drop read ahead grids the players never reached
+    {
+        LOCK_GUARD lock(m_mutex);
+
+        for (PrefetchedGridMaps::iterator itr = m_PrefetchedGridMaps.begin(); itr != m_PrefetchedGridMaps.end();)
+        {
+            if (GetMSTimeDiffToNow(itr->second.readTime) >= uint32(i_timer.GetInterval()))
+            {
+                delete itr->second.map;
+                itr = m_PrefetchedGridMaps.erase(itr);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+    }
+
     i_timer.Reset();
 }
 
+void TerrainInfo::Prefetch(const uint32 x, const uint32 y)
+{
+    MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+    const uint32 key = x * MAX_NUMBER_OF_GRIDS + y;
+
+    {
+        LOCK_GUARD lock(m_mutex);
+
+        if (m_GridMaps[x][y] || m_PrefetchedGridMaps.find(key) != m_PrefetchedGridMaps.end())
+        {
+            return;
+        }
+    }
+
+    // the file reads run unlocked, the map thread keeps answering terrain queries meanwhile
+    PrefetchedGridMap prefetched;
+    prefetched.map = LoadGridMapFile(x, y);
+    prefetched.readTime = getMSTime();
+
+    VMAP::VMapFactory::createOrGetVMapManager()->prefetchMap((sWorld.GetDataPath() + "vmaps").c_str(), m_mapId, x, y);
+
+    if (sWorld.getConfig(CONFIG_BOOL_MMAP_ENABLED))
+    {
+        MMAP::MMapFactory::createOrGetMMapManager()->prefetchTile(m_mapId, x, y);
+    }
+
+    LOCK_GUARD lock(m_mutex);
+
+    // the grid was loaded while we were reading it
+    if (m_GridMaps[x][y] || !m_PrefetchedGridMaps.insert(PrefetchedGridMaps::value_type(key, prefetched)).second)
+    {
+        delete prefetched.map;
+    }
+}
+
 int TerrainInfo::RefGrid(const uint32& x, const uint32& y)
 {
     MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
@@ -871,9 +1204,6 @@ int TerrainInfo::UnrefGrid(const uint32& x, const uint32& y)
 float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
 {
     float mapHeight = VMAP_INVALID_HEIGHT_VALUE;            // Store Height obtained by maps
-    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;           // Store Height obtained by vmaps (in "corridor" of z (or slightly above z)
-
-    float z2 = z + 2.f;
 
     // find raw .map surface under Z coordinates (or well-defined above)
     if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(x, y))
@@ -881,6 +1211,54 @@ float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=tr
         mapHeight = gmap->getHeight(x, y);
     }
 
+    return SelectHeightStatic(x, y, z, mapHeight, useVmaps, maxSearchDist);
+}
+
+void TerrainInfo::GetHeightsStatic(uint32 count, const float* x, const float* y, const float* z, float* heights, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
+{
+    GetMapHeights(count, x, y, heights);
+
+    // the vmap part is a ray query per point
+    for (uint32 i = 0; i < count; ++i)
+    {
+        heights[i] = SelectHeightStatic(x[i], y[i], z[i], heights[i], useVmaps, maxSearchDist);
+    }
+}
+
+void TerrainInfo::GetMapHeights(uint32 count, const float* x, const float* y, float* heights) const
+{
+    uint32 first = 0;
+    while (first < count)
+    {
+        int gx = (int)(32 - x[first] / SIZE_OF_GRIDS);
+        int gy = (int)(32 - y[first] / SIZE_OF_GRIDS);
+
+        // points of a batch are usually close to each other, take all following points of the same grid
+        uint32 last = first + 1;
+        while (last < count && (int)(32 - x[last] / SIZE_OF_GRIDS) == gx && (int)(32 - y[last] / SIZE_OF_GRIDS) == gy)
+        {
+            ++last;
+        }
+
+        if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(x[first], y[first]))
+        {
+            gmap->getHeights(x + first, y + first, heights + first, last - first);
+        }
+        else
+        {
+            std::fill(heights + first, heights + last, VMAP_INVALID_HEIGHT_VALUE);
+        }
+
+        first = last;
+    }
+}
+
+float TerrainInfo::SelectHeightStatic(float x, float y, float z, float mapHeight, bool useVmaps, float maxSearchDist) const
+{
+    float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;           // Store Height obtained by vmaps (in "corridor" of z (or slightly above z)
+
+    float z2 = z + 2.f;
+
     if (useVmaps)
     {
         VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
@@ -1271,6 +1649,32 @@ float TerrainInfo::GetWaterOrGroundLevel(float x, float y, float z, float* pGrou
     return VMAP_INVALID_HEIGHT_VALUE;
 }
 
+void TerrainInfo::GetWaterOrGroundLevels(uint32 count, const float* x, const float* y, const float* z, float* levels, float* pGrounds /*= NULL*/, bool swim /*= false*/) const
+{
+    // ground levels first, for all points together
+    GetHeightsStatic(count, x, y, z, levels, true, DEFAULT_WATER_SEARCH);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (!const_cast<TerrainInfo*>(this)->GetGrid(x[i], y[i]))
+        {
+            levels[i] = VMAP_INVALID_HEIGHT_VALUE;
+            continue;
+        }
+
+        float ground_z = levels[i];
+        if (pGrounds)
+        {
+            pGrounds[i] = ground_z;
+        }
+
+        GridMapLiquidData liquid_status;
+
+        GridMapLiquidStatus res = getLiquidStatus(x[i], y[i], ground_z, MAP_ALL_LIQUIDS, &liquid_status);
+        levels[i] = res ? (swim ? liquid_status.level - 2.0f : liquid_status.level) : ground_z;
+    }
+}
+
 GridMap* TerrainInfo::GetGrid(const float x, const float y)
 {
     // half opt method
@@ -1296,21 +1700,19 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if (!m_GridMaps[x][y])
         {
-            GridMap* map = new GridMap();
+            GridMap* map = NULL;
 
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%04u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%04u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
-
-            if (!map->loadData(tmp))
+            PrefetchedGridMaps::iterator prefetched = m_PrefetchedGridMaps.find(x * MAX_NUMBER_OF_GRIDS + y);
+            if (prefetched != m_PrefetchedGridMaps.end())
+            {
+                map = prefetched->second.map;
+                m_PrefetchedGridMaps.erase(prefetched);
+            }
+            else
             {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
+                map = LoadGridMapFile(x, y);
             }
 
-            delete[] tmp;
             m_GridMaps[x][y] = map;
 
             // load VMAPs for current map/grid...
@@ -1339,6 +1741,26 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
     return  m_GridMaps[x][y];
 }
 
+GridMap* TerrainInfo::LoadGridMapFile(const uint32 x, const uint32 y) const
+{
+    GridMap* map = new GridMap();
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%04u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%04u%02u%02u.map").c_str(), m_mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error load map file: \n %s\n", tmp);
+        // ASSERT(false);
+    }
+
+    delete[] tmp;
+    return map;
+}
+
 float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= NULL*/) const
 {
     if (const_cast<TerrainInfo*>(this)->GetGrid(x, y))
@@ -44,6 +44,7 @@ class InstanceData;
 class Group;
 class BattleGround;
 class Map;
+class ACE_Mem_Map;
 
 struct GridMapFileHeader
 {
@@ -163,6 +164,14 @@ class GridMap
         uint8* m_liquidFlags;
         float* m_liquid_map;
 
+        // read-only mapping of the .map file the arrays above point into, NULL when they are allocated
+        ACE_Mem_Map* m_mappedFile;
+
+        bool mapData(const char* filename);
+        bool mapAreaData(const uint8* file, size_t fileSize, uint32 offset);
+        bool mapHeightData(const uint8* file, size_t fileSize, uint32 offset);
+        bool mapGridMapLiquidData(const uint8* file, size_t fileSize, uint32 offset);
+
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
@@ -190,6 +199,8 @@ class GridMap
 
         uint16 getArea(float x, float y);
         float getHeight(float x, float y) { return (this->*m_gridGetHeight)(x, y); }
+        // same as getHeight for count points of this grid, the height format is resolved once for the batch
+        void getHeights(const float* x, const float* y, float* heights, uint32 count) const;
         float getLiquidLevel(float x, float y);
         uint8 getTerrainType(float x, float y);
         GridMapLiquidStatus getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, GridMapLiquidData* data = 0);
@@ -235,6 +246,10 @@ class TerrainInfo : public Referencable<AtomicLong>
         float GetHeightStatic(float x, float y, float z, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         float GetWaterLevel(float x, float y, float z, float* pGround = NULL) const;
         float GetWaterOrGroundLevel(float x, float y, float z, float* pGround = NULL, bool swim = false) const;
+
+        // batch versions of the above, the .map heights of points in the same grid are interpolated together
+        void GetHeightsStatic(uint32 count, const float* x, const float* y, const float* z, float* heights, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
+        void GetWaterOrGroundLevels(uint32 count, const float* x, const float* y, const float* z, float* levels, float* pGrounds = NULL, bool swim = false) const;
         bool IsInWater(float x, float y, float z, GridMapLiquidData* data = 0) const;
         bool IsSwimmable(float x, float y, float pZ, float radius = 1.5f, GridMapLiquidData* data = NULL) const;
         bool IsUnderWater(float x, float y, float z) const;
@@ -258,6 +273,9 @@ class TerrainInfo : public Referencable<AtomicLong>
         // THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
         void CleanUpGrids(const uint32 diff);
 
+        // read the terrain of a grid ahead of its loading, called by the terrain prefetch threads
+        void Prefetch(const uint32 x, const uint32 y);
+
     protected:
         friend class Map;
         // load/unload terrain data
@@ -270,6 +288,12 @@ class TerrainInfo : public Referencable<AtomicLong>
 
         GridMap* GetGrid(const float x, const float y);
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
+        GridMap* LoadGridMapFile(const uint32 x, const uint32 y) const;
+
+        // .map heights of the points, VMAP_INVALID_HEIGHT_VALUE where there is no grid
+        void GetMapHeights(uint32 count, const float* x, const float* y, float* heights) const;
+        // final static height from the .map height of a point and its vmap height
+        float SelectHeightStatic(float x, float y, float z, float mapHeight, bool useVmaps, float maxSearchDist) const;
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
@@ -279,6 +303,16 @@ class TerrainInfo : public Referencable<AtomicLong>
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        struct PrefetchedGridMap
+        {
+            GridMap* map;
+            uint32 readTime;
+        };
+
+        // GridMap objects read by Prefetch and not loaded yet, guarded by m_mutex
+        typedef std::unordered_map<uint32, PrefetchedGridMap> PrefetchedGridMaps;
+        PrefetchedGridMaps m_PrefetchedGridMaps;
+
         // global garbage collection timer
         IntervalTimer i_timer;
 
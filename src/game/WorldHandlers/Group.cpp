@@ -25,6 +25,7 @@
 #include "Common.h"
 #include "Opcodes.h"
 #include "WorldPacket.h"
+#include "SharedPacket.h"
 #include "WorldSession.h"
 #include "Player.h"
 #include "World.h"
@@ -1345,6 +1346,8 @@ void Group::UpdatePlayerOutOfRange(Player* pPlayer)
 
 void Group::BroadcastPacket(WorldPacket* packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignore)
 {
+    SharedPacket shared(*packet);
+
     for (GroupReference* itr = GetFirstMember(); itr != NULL; itr = itr->next())
     {
         Player* pl = itr->getSource();
@@ -1355,7 +1358,7 @@ void Group::BroadcastPacket(WorldPacket* packet, bool ignorePlayersInBGRaid, int
 
         if (pl->GetSession() && (group == -1 || itr->getSubGroup() == group))
         {
-            pl->GetSession()->SendPacket(packet);
+            pl->GetSession()->SendPacket(shared);
         }
     }
 }
@@ -230,17 +230,6 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
     {
         // if item send to character at another account, then apply item delivery delay
         needItemDelay = sender_acc != rc_account;
-
-        // set owner to new receiver (to prevent delete item with sender char deleting)
-        CharacterDatabase.BeginTransaction();
-        for (MailItemMap::iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
-        {
-            Item* item = mailItemIter->second;
-            item->SaveToDB();                               // item not in inventory and can be save standalone
-            // owner in data will set at mail receive and item extracting
-            CharacterDatabase.PExecute("UPDATE `item_instance` SET `owner_guid` = '%u' WHERE `guid`='%u'", receiver_guid.GetCounter(), item->GetGUIDLow());
-        }
-        CharacterDatabase.CommitTransaction();
     }
 
     // If theres is an item, there is a one hour delivery delay.
@@ -273,6 +262,9 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
         return;
     }
 
+    // keep the mail ordered with the later requests of the receiver (taking items, deleting the mail...)
+    SqlAsyncAffinity dbAffinity(pReceiver ? pReceiver->GetSession()->GetAccountId() : pReceiverAccount);
+
     bool has_items = !m_items.empty();
 
     // generate mail template items for online player, for offline player items will generated at open
@@ -317,6 +309,10 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
     for (MailItemMap::const_iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
     {
         Item* item = mailItemIter->second;
+        // the item changes hands with the mail, in the same transaction (to prevent delete item with sender char deleting)
+        item->SaveToDB();                                   // item not in inventory and can be save standalone
+        // owner in data will set at mail receive and item extracting
+        CharacterDatabase.PExecute("UPDATE `item_instance` SET `owner_guid` = '%u' WHERE `guid`='%u'", receiver.GetPlayerGuid().GetCounter(), item->GetGUIDLow());
         CharacterDatabase.PExecute("INSERT INTO `mail_items` (`mail_id`,`item_guid`,`item_template`,`receiver`) VALUES ('%u', '%u', '%u','%u')",
                                    mailId, item->GetGUIDLow(), item->GetEntry(), receiver.GetPlayerGuid().GetCounter());
     }
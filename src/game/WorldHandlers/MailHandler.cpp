@@ -335,12 +335,8 @@ void WorldSession::HandleSendMail(WorldPacket& recv_data)
                 }
 
                 pl->MoveItemFromInventory(items[i]->GetBagSlot(), item->GetSlot(), true);
-                CharacterDatabase.BeginTransaction();
                 item->DeleteFromInventoryDB();              // deletes item from character's inventory
-                item->SaveToDB();                           // recursive and not have transaction guard into self, item not in inventory and can be save standalone
-                // owner in data will set at mail receive and item extracting
-                CharacterDatabase.PExecute("UPDATE `item_instance` SET `owner_guid` = '%u' WHERE `guid`='%u'", rc.GetCounter(), item->GetGUIDLow());
-                CharacterDatabase.CommitTransaction();
+                // item and owner are saved by SendMailTo, in the transaction of the mail
 
                 draft.AddItem(item);
             }
@@ -46,6 +46,8 @@
 #include "Calendar.h"
 #include "Chat.h"
 #include "Weather.h"
+#include "PathCache.h"
+#include "LineOfSightCache.h"
 #ifdef ENABLE_ELUNA
 #include "LuaEngine.h"
 #include "ElunaConfig.h"
@@ -55,6 +57,8 @@
 #include "playerbot/playerbot.h"
 #include "playerbot/PlayerbotAIConfig.h"
 
+thread_local MapUpdateRegion* Map::m_currentUpdateRegion = NULL;
+
 Map::~Map()
 {
 #ifdef ENABLE_ELUNA
@@ -106,6 +110,12 @@ Map::~Map()
 
     delete m_weatherSystem;
     m_weatherSystem = NULL;
+
+    delete m_pathCache;
+    m_pathCache = NULL;
+
+    delete m_losCache;
+    m_losCache = NULL;
 }
 
 void Map::LoadMapAndVMap(int gx, int gy)
@@ -127,7 +137,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(NULL),
       m_activeNonPlayersIter(m_activeNonPlayers.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(NULL), m_activeAreasTimer(0), hasRealPlayers(false)
+      i_data(NULL), m_activeAreasTimer(0), hasRealPlayers(false), m_regionUpdateActive(false), m_pathRequests(*this),
+      m_pathCache(NULL), m_losCache(NULL)
 {
 #ifdef ENABLE_ELUNA
     // lua state begins uninitialized
@@ -162,6 +173,16 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
     m_persistentState->SetUsedByMapState(this);
 
     m_weatherSystem = new WeatherSystem(this);
+
+    if (uint32 pathCacheSize = sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_CACHE_SIZE))
+    {
+        m_pathCache = new PathCache(pathCacheSize);
+    }
+
+    if (uint32 losCacheSize = sWorld.getConfig(CONFIG_UINT32_VMAP_LOS_CACHE_SIZE))
+    {
+        m_losCache = new LineOfSightCache(losCacheSize);
+    }
 #ifdef ENABLE_ELUNA
     if (Eluna* e = GetEluna())
     {
@@ -272,6 +293,8 @@ void Map::DeleteFromWorld(Player* pl)
 void
 Map::EnsureGridCreated(const GridPair& p)
 {
+    RegionGuard guard(this);
+
     if (!getNGrid(p.x_coord, p.y_coord))
     {
         setNGrid(new NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld.getConfig(CONFIG_BOOL_GRID_UNLOAD)),
@@ -327,6 +350,8 @@ Map::EnsureGridLoadedAtEnter(const Cell& cell, Player* player)
 
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    RegionGuard guard(this);
+
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -418,9 +443,22 @@ Map::Add(T* obj)
         return;
     }
 
+    Cell cell(p);
+
+    // object spawned in a grid another region may be updating right now, add it after the join
+    if (MapUpdateRegion* region = GetCurrentUpdateRegion())
+    {
+        if (!region->IsLocalGrid(cell.GridX(), cell.GridY()))
+        {
+            region->deferredActions.push_back([this, obj]() { Add(obj); });
+            return;
+        }
+    }
+
+    RegionGuard guard(this);
+
     obj->SetMap(this);
 
-    Cell cell(p);
     if (obj->IsActiveObject())
     {
         EnsureGridLoadedAtEnter(cell);
@@ -550,16 +588,19 @@ bool Map::loaded(const GridPair& p) const
 
 void Map::Update(const uint32& t_diff)
 {
-    MaNGOS::ObjectUpdater updater(t_diff);
-    // for creature
-    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
-    // for pets
-    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
-    
+    // busy continents can visit far apart cell regions concurrently, see UpdateCellsInRegions
+    bool regionUpdate = IsContinent() && sMapMgr.GetRegionUpdater();
+
     uint64 count = 0;
 
     m_dyn_tree.update(t_diff);
 
+    // units moved since the last update, line of sight results are only kept for one tick
+    if (m_losCache)
+    {
+        m_losCache->Invalidate();
+    }
+
     // GetMessager().Execute(this); Other does this????? TODO
     // m_spawnManager.Update();
 
@@ -655,25 +696,11 @@ void Map::Update(const uint32& t_diff)
         plr->UpdateAI(t_diff, !(isInActiveArea || updateAI || plr->IsInCombat()));
 
         // lets update mobs/objects in ALL visible cells around player!
-        CellArea area = Cell::CalculateCellArea(plr->GetPositionX(), plr->GetPositionY(), GetVisibilityDistance());
-
-        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        MarkCellsAround(plr, m_cellsToUpdate);
+        if (!regionUpdate)
         {
-            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-            {
-                // marked cells are those that have been visited
-                // don't visit the same cell twice
-                uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                if (!isCellMarked(cell_id))
-                {
-                    markCell(cell_id);
-                    CellPair pair(x, y);
-                    Cell cell(pair);
-                    cell.SetNoCreate();
-                    Visit(cell, grid_object_update);
-                    Visit(cell, world_object_update);
-                }
-            }
+            UpdateCells(m_cellsToUpdate, t_diff);
+            m_cellsToUpdate.clear();
         }
     }
 
@@ -695,29 +722,21 @@ void Map::Update(const uint32& t_diff)
             }
 
             // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
-
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+            MarkCellsAround(obj, m_cellsToUpdate);
+            if (!regionUpdate)
             {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-                {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
-                    }
-                }
+                UpdateCells(m_cellsToUpdate, t_diff);
+                m_cellsToUpdate.clear();
             }
         }
     }
 
+    if (!m_cellsToUpdate.empty())
+    {
+        UpdateCellsInRegions(m_cellsToUpdate, t_diff);
+        m_cellsToUpdate.clear();
+    }
+
     // Send world objects and item update field changes
     m_clientUpdateTimer += t_diff;
     if (m_clientUpdateTimer >= 333)
@@ -730,6 +749,9 @@ void Map::Update(const uint32& t_diff)
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGroundOrArena())
     {
+        // the cell regions are joined by now, grid states only change in the map thread
+        MANGOS_ASSERT(!m_regionUpdateActive);
+
         for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
         {
             NGridType* grid = i->getSource();
@@ -764,6 +786,192 @@ void Map::Update(const uint32& t_diff)
     }
 
     m_weatherSystem->UpdateWeathers(t_diff);
+
+    // build the paths asked for during this update, the units pick them up on their next update
+    m_pathRequests.Process();
+}
+
+void Map::MarkCellsAround(WorldObject const* obj, std::vector<uint32>& cells)
+{
+    CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+
+    for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+    {
+        for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+        {
+            // marked cells are those that have been visited
+            // don't visit the same cell twice
+            uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            if (!isCellMarked(cell_id))
+            {
+                markCell(cell_id);
+                cells.push_back(cell_id);
+            }
+        }
+    }
+}
+
+void Map::UpdateCells(std::vector<uint32> const& cells, uint32 diff)
+{
+    MaNGOS::ObjectUpdater updater(diff);
+    // for creature
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    // for pets
+    TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    for (std::vector<uint32>::const_iterator itr = cells.begin(); itr != cells.end(); ++itr)
+    {
+        CellPair pair(*itr % TOTAL_NUMBER_OF_CELLS_PER_MAP, *itr / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
+    }
+}
+
+void Map::BuildUpdateRegions(std::vector<uint32> const& cells, std::vector<MapUpdateRegion>& regions)
+{
+    // collect the grids owning the cells, in order of first appearance
+    std::vector<uint32> grids;
+    std::vector<uint32> cellGrid;
+    cellGrid.reserve(cells.size());
+
+    for (std::vector<uint32>::const_iterator itr = cells.begin(); itr != cells.end(); ++itr)
+    {
+        uint32 gx = (*itr % TOTAL_NUMBER_OF_CELLS_PER_MAP) / MAX_NUMBER_OF_CELLS;
+        uint32 gy = (*itr / TOTAL_NUMBER_OF_CELLS_PER_MAP) / MAX_NUMBER_OF_CELLS;
+        uint32 gridId = gx * MAX_NUMBER_OF_GRIDS + gy;
+
+        std::vector<uint32>::const_iterator found = std::find(grids.begin(), grids.end(), gridId);
+        if (found == grids.end())
+        {
+            cellGrid.push_back(grids.size());
+            grids.push_back(gridId);
+        }
+        else
+        {
+            cellGrid.push_back(found - grids.begin());
+        }
+    }
+
+    // grids closer than three grids (two empty grids in between) end up in the same region,
+    // so objects of different regions can never see, reach or walk into each other in one tick
+    std::vector<uint32> parent(grids.size());
+    for (uint32 i = 0; i < parent.size(); ++i)
+    {
+        parent[i] = i;
+    }
+
+    auto findRoot = [&parent](uint32 i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    for (uint32 i = 0; i < grids.size(); ++i)
+    {
+        for (uint32 j = i + 1; j < grids.size(); ++j)
+        {
+            int32 dx = int32(grids[i] / MAX_NUMBER_OF_GRIDS) - int32(grids[j] / MAX_NUMBER_OF_GRIDS);
+            int32 dy = int32(grids[i] % MAX_NUMBER_OF_GRIDS) - int32(grids[j] % MAX_NUMBER_OF_GRIDS);
+            if (std::abs(dx) < 3 && std::abs(dy) < 3)
+            {
+                parent[findRoot(i)] = findRoot(j);
+            }
+        }
+    }
+
+    std::vector<int32> regionOfRoot(grids.size(), -1);
+    for (uint32 i = 0; i < grids.size(); ++i)
+    {
+        uint32 root = findRoot(i);
+        if (regionOfRoot[root] < 0)
+        {
+            regionOfRoot[root] = int32(regions.size());
+            regions.push_back(MapUpdateRegion(this));
+        }
+
+        // the region may touch its own grids and the ring around them
+        MapUpdateRegion& region = regions[regionOfRoot[root]];
+        int32 gx = int32(grids[i] / MAX_NUMBER_OF_GRIDS);
+        int32 gy = int32(grids[i] % MAX_NUMBER_OF_GRIDS);
+        for (int32 x = std::max(gx - 1, 0); x <= std::min(gx + 1, MAX_NUMBER_OF_GRIDS - 1); ++x)
+        {
+            for (int32 y = std::max(gy - 1, 0); y <= std::min(gy + 1, MAX_NUMBER_OF_GRIDS - 1); ++y)
+            {
+                region.localGrids.set(x * MAX_NUMBER_OF_GRIDS + y);
+            }
+        }
+    }
+
+    for (uint32 i = 0; i < cells.size(); ++i)
+    {
+        regions[regionOfRoot[findRoot(cellGrid[i])]].cells.push_back(cells[i]);
+    }
+}
+
+void Map::UpdateCellsInRegions(std::vector<uint32> const& cells, uint32 diff)
+{
+    MapRegionUpdater* regionUpdater = sMapMgr.GetRegionUpdater();
+
+    std::vector<MapUpdateRegion> regions;
+    if (regionUpdater)
+    {
+        BuildUpdateRegions(cells, regions);
+    }
+
+    // nothing to split, a single region is cheaper to update in place
+    if (regions.size() < 2)
+    {
+        UpdateCells(cells, diff);
+        return;
+    }
+
+    // dtNavMeshQuery is not thread safe, every region builds its paths with a query slot of its own
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    for (uint32 i = 0; i < regions.size(); ++i)
+    {
+        regions[i].navMeshQuery = mmap->GetNavMeshQuery(GetId(), GetInstanceId(), i);
+    }
+
+    m_regionUpdateActive = true;
+    regionUpdater->UpdateRegions(regions, diff);
+    m_regionUpdateActive = false;
+
+    for (std::vector<MapUpdateRegion>::iterator itr = regions.begin(); itr != regions.end(); ++itr)
+    {
+        MergeUpdateRegion(*itr);
+    }
+}
+
+void Map::UpdateCellRegion(MapUpdateRegion& region, uint32 diff)
+{
+    m_currentUpdateRegion = &region;
+    UpdateCells(region.cells, diff);
+    m_currentUpdateRegion = NULL;
+}
+
+void Map::MergeUpdateRegion(MapUpdateRegion& region)
+{
+    for (std::vector<uint32>::const_iterator itr = region.removedUpdateObjects.begin(); itr != region.removedUpdateObjects.end(); ++itr)
+    {
+        i_objectsToClientUpdate[*itr] = NULL;
+    }
+
+    for (std::vector<Object*>::const_iterator itr = region.addedUpdateObjects.begin(); itr != region.addedUpdateObjects.end(); ++itr)
+    {
+        AddUpdateObject(*itr);
+    }
+
+    // changes that reach into other regions, now safe to apply from the map thread
+    for (std::vector<std::function<void()> >::const_iterator itr = region.deferredActions.begin(); itr != region.deferredActions.end(); ++itr)
+    {
+        (*itr)();
+    }
 }
 
 void Map::Remove(Player* player, bool remove)
@@ -856,6 +1064,8 @@ Map::Remove(T* obj, bool remove)
         return;
     }
 
+    RegionGuard guard(this);
+
     DEBUG_LOG("Remove object (GUID: %u TypeId:%u) from grid[%u,%u]", obj->GetGUIDLow(), obj->GetTypeId(), cell.data.Part.grid_x, cell.data.Part.grid_y);
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
     MANGOS_ASSERT(grid != NULL);
@@ -895,7 +1105,10 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
 {
     MANGOS_ASSERT(player);
 
-    CellPair old_val = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
+    const float oldX = player->GetPositionX();
+    const float oldY = player->GetPositionY();
+
+    CellPair old_val = MaNGOS::ComputeCellPair(oldX, oldY);
     CellPair new_val = MaNGOS::ComputeCellPair(x, y);
 
     Cell old_cell(old_val);
@@ -921,6 +1134,8 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
 
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         player->GetViewPoint().Event_GridChanged(&(*newGrid)(new_cell.CellX(), new_cell.CellY()));
+
+        PrefetchTerrainAhead(oldX, oldY, x, y);
     }
 
     player->OnRelocated();
@@ -933,6 +1148,52 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
     }
 }
 
+void Map::PrefetchTerrainAhead(float oldX, float oldY, float x, float y)
+{
+    // instances are short lived and small, only continents are worth reading ahead
+    if (!IsContinent())
+    {
+        return;
+    }
+
+    TerrainPrefetcher* prefetcher = sMapMgr.GetTerrainPrefetcher();
+    if (!prefetcher)
+    {
+        return;
+    }
+
+    const float dx = x - oldX;
+    const float dy = y - oldY;
+    const float dist = sqrt(dx * dx + dy * dy);
+
+    // teleports and zero length moves have no useful direction
+    if (dist < 0.1f || dist > SIZE_OF_GRIDS)
+    {
+        return;
+    }
+
+    const int curX = int(32 - x / SIZE_OF_GRIDS);
+    const int curY = int(32 - y / SIZE_OF_GRIDS);
+
+    // half a grid steps up to one and a half grids ahead, so diagonal moves catch the corner grids
+    for (int step = 1; step <= 3; ++step)
+    {
+        const float ahead = step * SIZE_OF_GRIDS / 2;
+        const float aheadX = x + dx / dist * ahead;
+        const float aheadY = y + dy / dist * ahead;
+
+        const int gx = int(32 - aheadX / SIZE_OF_GRIDS);
+        const int gy = int(32 - aheadY / SIZE_OF_GRIDS);
+
+        if (gx < 0 || gy < 0 || gx >= MAX_NUMBER_OF_GRIDS || gy >= MAX_NUMBER_OF_GRIDS || (gx == curX && gy == curY))
+        {
+            continue;
+        }
+
+        prefetcher->Prefetch(m_TerrainData, gx, gy);
+    }
+}
+
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang)
 {
     MANGOS_ASSERT(CheckGridIntegrity(creature, false));
@@ -940,6 +1201,26 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
     Cell old_cell = creature->GetCurrentCell();
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
 
+    // moving into a grid of another region (far teleport, respawn relocation) waits for the merge phase
+    if (MapUpdateRegion* region = GetCurrentUpdateRegion())
+    {
+        float respX, respY, respZ;
+        creature->GetRespawnCoord(respX, respY, respZ);
+        Cell resp_cell(MaNGOS::ComputeCellPair(respX, respY));
+
+        if (!region->IsLocalGrid(new_cell.GridX(), new_cell.GridY()) || !region->IsLocalGrid(resp_cell.GridX(), resp_cell.GridY()))
+        {
+            region->deferredActions.push_back([this, creature, x, y, z, ang]()
+            {
+                if (creature->IsInWorld() && creature->GetMap() == this)
+                {
+                    CreatureRelocation(creature, x, y, z, ang);
+                }
+            });
+            return;
+        }
+    }
+
     // do move or do move to respawn or remove creature if previous all fail
     if (CreatureCellRelocation(creature, new_cell))
     {
@@ -1248,6 +1529,8 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 {
     MANGOS_ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
+    RegionGuard guard(this);
+
 #ifdef ENABLE_ELUNA
     if (Eluna* e = GetEluna())
     {
@@ -1393,6 +1676,8 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    RegionGuard guard(this);
+
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
@@ -1423,6 +1708,8 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    RegionGuard guard(this);
+
     // Map::Update for active object in proccess
     if (m_activeNonPlayersIter != m_activeNonPlayers.end())
     {
@@ -2059,6 +2346,8 @@ bool Map::ScriptsStart(DBScriptType type, uint32 id, Object* source, Object* tar
     ObjectGuid targetGuid = target ? target->GetObjectGuid() : ObjectGuid();
     ObjectGuid ownerGuid  = source->isType(TYPEMASK_ITEM) ? ((Item*)source)->GetOwnerGuid() : ObjectGuid();
 
+    RegionGuard guard(this);
+
     if (execParams)                                         // Check if the execution should be uniquely
     {
         for (ScriptScheduleMap::const_iterator searchItr = m_scriptSchedule.begin(); searchItr != m_scriptSchedule.end(); ++searchItr)
@@ -2089,6 +2378,8 @@ bool Map::ScriptsStart(DBScriptType type, uint32 id, Object* source, Object* tar
 
 void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target)
 {
+    RegionGuard guard(this);
+
     // NOTE: script record _must_ exist until command executed
 
     // prepare static data
@@ -2169,6 +2460,7 @@ Player* Map::GetPlayer(ObjectGuid guid)
  */
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    RegionGuard guard(this);
     return m_objectsStore.find<Creature>(guid, (Creature*)NULL);
 }
 
@@ -2179,6 +2471,7 @@ Creature* Map::GetCreature(ObjectGuid guid)
  */
 Pet* Map::GetPet(ObjectGuid guid)
 {
+    RegionGuard guard(this);
     return m_objectsStore.find<Pet>(guid, (Pet*)NULL);
 }
 
@@ -2220,6 +2513,7 @@ Creature* Map::GetAnyTypeCreature(ObjectGuid guid)
  */
 GameObject* Map::GetGameObject(ObjectGuid guid)
 {
+    RegionGuard guard(this);
     return m_objectsStore.find<GameObject>(guid, (GameObject*)NULL);
 }
 
@@ -2230,6 +2524,7 @@ GameObject* Map::GetGameObject(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    RegionGuard guard(this);
     return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)NULL);
 }
 
@@ -2282,24 +2577,26 @@ void Map::SendObjectUpdates()
 {
     UpdateDataMapType update_players;
 
-    while (!i_objectsToClientUpdate.empty())
+    // objects marked while building are appended and handled in the same pass
+    for (size_t i = 0; i < i_objectsToClientUpdate.size(); ++i)
     {
-        Object* obj = *i_objectsToClientUpdate.begin();
-        i_objectsToClientUpdate.erase(i_objectsToClientUpdate.begin());
-        obj->BuildUpdateData(update_players);
+        if (Object* obj = i_objectsToClientUpdate[i])
+        {
+            i_objectsToClientUpdate[i] = NULL;
+            obj->BuildUpdateData(update_players);
+        }
     }
 
-    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
-    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
-    {
-        iter->second.BuildPacket(&packet);
-        iter->first->GetSession()->SendPacket(&packet);
-        packet.clear();                                     // clean the string
-    }
+    // keeps the capacity, so the list does not allocate again next time
+    i_objectsToClientUpdate.clear();
+
+    sMapMgr.GetUpdatePacketSender().SendUpdates(update_players);
 }
 
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
+    RegionGuard guard(this);
+
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
     switch (guidhigh)
     {
@@ -2429,8 +2726,74 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+    if (!m_losCache)
+    {
+        return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+               && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+    }
+
+    LineOfSightCacheKey key(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+    bool result;
+    if (m_losCache->Find(key, result))
+    {
+        return result;
+    }
+
+    uint32 generation = m_losCache->GetGeneration();
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+    m_losCache->Store(key, generation, result);
+    return result;
+}
+
+/**
+ * Check the line of sight from one point to many points, the static tree is traversed once for a bunch of rays
+ */
+void Map::IsInLineOfSight(float srcX, float srcY, float srcZ, uint32 count, const float* destX, const float* destY, const float* destZ, uint32 phasemask, bool* results) const
+{
+    uint32 generation = m_losCache ? m_losCache->GetGeneration() : 0;
+
+    // only the points missing from the cache are tested
+    std::vector<uint32> index;
+    std::vector<float> x, y, z;
+    index.reserve(count);
+    x.reserve(count);
+    y.reserve(count);
+    z.reserve(count);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (m_losCache && m_losCache->Find(LineOfSightCacheKey(srcX, srcY, srcZ, destX[i], destY[i], destZ[i], phasemask), results[i]))
+        {
+            continue;
+        }
+
+        index.push_back(i);
+        x.push_back(destX[i]);
+        y.push_back(destY[i]);
+        z.push_back(destZ[i]);
+    }
+
+    if (index.empty())
+    {
+        return;
+    }
+
+    bool* inLos = new bool[index.size()];
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, uint32(index.size()), &x[0], &y[0], &z[0], inLos);
+
+    for (size_t i = 0; i < index.size(); ++i)
+    {
+        bool result = inLos[i] && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, x[i], y[i], z[i], phasemask);
+        results[index[i]] = result;
+
+        if (m_losCache)
+        {
+            m_losCache->Store(LineOfSightCacheKey(srcX, srcY, srcZ, x[i], y[i], z[i], phasemask), generation, result);
+        }
+    }
+
+    delete[] inLos;
 }
 
 /**
@@ -2535,14 +2898,33 @@ float Map::GetHeight(uint32 phasemask, float x, float y, float z) const
     return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight, phasemask));
 }
 
+void Map::GetHeights(uint32 phasemask, uint32 count, const float* x, const float* y, const float* z, float* heights) const
+{
+    m_TerrainData->GetHeightsStatic(count, x, y, z, heights);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float dynSearchHeight = 2.0f + (z[i] < heights[i] ? heights[i] : z[i]);
+        heights[i] = std::max<float>(heights[i], m_dyn_tree.getHeight(x[i], y[i], dynSearchHeight, dynSearchHeight - heights[i], phasemask));
+    }
+}
+
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
+    RegionGuard guard(this);
+
     m_dyn_tree.insert(mdl);
+
+    InvalidateLineOfSightCache();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
+    RegionGuard guard(this);
+
     m_dyn_tree.remove(mdl);
+
+    InvalidateLineOfSightCache();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
@@ -2550,6 +2932,14 @@ bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
     return m_dyn_tree.contains(mdl);
 }
 
+void Map::InvalidateLineOfSightCache()
+{
+    if (m_losCache)
+    {
+        m_losCache->Invalidate();
+    }
+}
+
 // This will generate a random point to all directions in water for the provided point in radius range.
 bool Map::GetRandomPointUnderWater(uint32 phaseMask, float& x, float& y, float& z, float radius, GridMapLiquidData& liquid_status)
 {
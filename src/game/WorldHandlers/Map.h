@@ -30,6 +30,7 @@
 #include "Policies/ThreadingModel.h"
 #include <ace/RW_Thread_Mutex.h>
 #include <ace/Thread_Mutex.h>
+#include <ace/Recursive_Thread_Mutex.h>
 
 #include "DBCStructure.h"
 #include "GridDefines.h"
@@ -44,12 +45,14 @@
 #include "ScriptMgr.h"
 #include "CreatureLinkingMgr.h"
 #include "DynamicTree.h"
+#include "PathRequestQueue.h"
 #ifdef ENABLE_ELUNA
 #include "LuaValue.h"
 #endif /* ENABLE_ELUNA */
 
 #include <bitset>
 #include <list>
+#include <functional>
 
 struct CreatureInfo;
 class Creature;
@@ -69,6 +72,9 @@ class BattleGround;
 class GridMap;
 class GameObjectModel;
 class WeatherSystem;
+class PathCache;
+class LineOfSightCache;
+class Map;
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
@@ -105,6 +111,50 @@ enum LevelRequirementVsMode
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+// Time spent in Map::Update, collected by MapUpdater for every map update
+struct MapUpdateTimeStats
+{
+    MapUpdateTimeStats() : lastTime(0), maxTime(0), totalTime(0), updateCount(0) {}
+
+    void AddUpdateTime(uint32 diff)
+    {
+        lastTime = diff;
+        if (diff > maxTime)
+        {
+            maxTime = diff;
+        }
+        totalTime += diff;
+        ++updateCount;
+    }
+
+    uint32 GetAverageTime() const { return updateCount ? uint32(totalTime / updateCount) : 0; }
+
+    uint32 lastTime;                                        // duration of the last update, in ms
+    uint32 maxTime;                                         // longest update since the map was created, in ms
+    uint64 totalTime;
+    uint32 updateCount;
+};
+
+// Active cells of a continent that are at least two grids away from the cells of every other
+// region, so their ObjectUpdater visits can run concurrently. Everything an update does outside
+// of the region (and its one grid border) is deferred and replayed by the map after the join.
+struct MapUpdateRegion
+{
+    explicit MapUpdateRegion(Map* _map) : map(_map), navMeshQuery(NULL) {}
+
+    bool IsLocalGrid(uint32 x, uint32 y) const { return localGrids.test(x * MAX_NUMBER_OF_GRIDS + y); }
+
+    Map* map;
+    std::vector<uint32> cells;                              // cell ids visited by this region
+    std::bitset<MAX_NUMBER_OF_GRIDS* MAX_NUMBER_OF_GRIDS> localGrids; // grids of the region and their neighbours
+    dtNavMeshQuery const* navMeshQuery;                     // used by PathFinder::calculate in this region, NULL without mmaps
+
+    // merge phase data, replayed in the map thread in this order
+    std::vector<uint32> removedUpdateObjects;               // slots in Map::i_objectsToClientUpdate
+    std::vector<Object*> addedUpdateObjects;
+    std::vector<std::function<void()> > deferredActions;
+};
+
 class Map : public GridRefManager<NGridType>
 {
         friend class MapReference;
@@ -271,20 +321,60 @@ class Map : public GridRefManager<NGridType>
 
         void AddUpdateObject(Object* obj)
         {
-            i_objectsToClientUpdate.insert(obj);
+            if (MapUpdateRegion* region = GetCurrentUpdateRegion())
+            {
+                region->addedUpdateObjects.push_back(obj);
+                return;
+            }
+
+            if (IsInClientUpdateList(obj))
+            {
+                return;
+            }
+
+            obj->SetClientUpdateListIndex(uint32(i_objectsToClientUpdate.size()));
+            i_objectsToClientUpdate.push_back(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
-            i_objectsToClientUpdate.erase(obj);
+            if (MapUpdateRegion* region = GetCurrentUpdateRegion())
+            {
+                region->addedUpdateObjects.erase(std::remove(region->addedUpdateObjects.begin(), region->addedUpdateObjects.end(), obj), region->addedUpdateObjects.end());
+                if (IsInClientUpdateList(obj))
+                {
+                    region->removedUpdateObjects.push_back(obj->GetClientUpdateListIndex());
+                }
+                return;
+            }
+
+            // leave a hole, the list is only compacted when the updates are sent
+            if (IsInClientUpdateList(obj))
+            {
+                i_objectsToClientUpdate[obj->GetClientUpdateListIndex()] = NULL;
+            }
         }
 
+        // Cell region updates (see MapUpdateRegionThreads), called by MapRegionUpdater workers
+        void UpdateCellRegion(MapUpdateRegion& region, uint32 diff);
+        // region updated by the calling thread for this map, NULL outside of the concurrent phase
+        MapUpdateRegion* GetCurrentUpdateRegion() const { return m_currentUpdateRegion && m_currentUpdateRegion->map == this ? m_currentUpdateRegion : NULL; }
+
         // DynObjects currently
         uint32 GenerateLocalLowGuid(HighGuid guidhigh);
 
         // get corresponding TerrainData object for this particular map
         const TerrainInfo* GetTerrain() const { return m_TerrainData; }
 
+        // paths of the movement generators, built at the end of the map update (see MapUpdatePathThreads)
+        PathRequestQueue& GetPathRequests() { return m_pathRequests; }
+
+        // recently built paths, NULL when disabled (see mmap.pathCacheSize)
+        PathCache* GetPathCache() const { return m_pathCache; }
+
+        // line of sight results of the current update, NULL when disabled (see vmap.losCacheSize)
+        LineOfSightCache* GetLineOfSightCache() const { return m_losCache; }
+
         void CreateInstanceData(bool load);
         InstanceData* GetInstanceData() const { return i_data; }
         virtual uint32 GetScriptId() const { return sScriptMgr.GetBoundScriptId(SCRIPTED_MAP, GetId()); }
@@ -295,14 +385,18 @@ class Map : public GridRefManager<NGridType>
 
         // Dynamic VMaps
         float GetHeight(uint32 phasemask, float x, float y, float z) const;
+        void GetHeights(uint32 phasemask, uint32 count, const float* x, const float* y, const float* z, float* heights) const;
         bool GetHeightInRange(uint32 phasemask, float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const;
+        void IsInLineOfSight(float x1, float y1, float z1, uint32 count, const float* x2, const float* y2, const float* z2, uint32 phasemask, bool* results) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, uint32 phasemask, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // a model in the dynamic tree was enabled or disabled (doors opening, phase change)
+        void InvalidateLineOfSightCache();
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -317,6 +411,10 @@ class Map : public GridRefManager<NGridType>
 
         // WeatherSystem
         WeatherSystem* GetWeatherSystem() const { return m_weatherSystem; }
+
+        // Update timing, written only by the thread currently updating this map
+        MapUpdateTimeStats& GetUpdateTimeStats() { return m_updateTimeStats; }
+        MapUpdateTimeStats const& GetUpdateTimeStats() const { return m_updateTimeStats; }
         /** Set the weather in a zone on this map
          * @param zoneId set the weather for which zone
          * @param type What weather to set
@@ -349,6 +447,9 @@ class Map : public GridRefManager<NGridType>
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedAtEnter(Cell const&, Player* player = NULL);
 
+        // queue the terrain reads of the grids ahead of a player moving from old to new position
+        void PrefetchTerrainAhead(float oldX, float oldY, float x, float y);
+
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
         template<class T> void AddType(T* obj);
@@ -368,7 +469,42 @@ class Map : public GridRefManager<NGridType>
         void ScriptsProcess();
 
         void SendObjectUpdates();
-        std::set<Object*> i_objectsToClientUpdate;
+        bool IsInClientUpdateList(Object* obj) const
+        {
+            return obj->GetClientUpdateListIndex() < i_objectsToClientUpdate.size() && i_objectsToClientUpdate[obj->GetClientUpdateListIndex()] == obj;
+        }
+        std::vector<Object*> i_objectsToClientUpdate;       // objects with changes to send, removed ones are set to NULL
+
+        void MarkCellsAround(WorldObject const* obj, std::vector<uint32>& cells);
+        void UpdateCells(std::vector<uint32> const& cells, uint32 diff);
+        void UpdateCellsInRegions(std::vector<uint32> const& cells, uint32 diff);
+        void BuildUpdateRegions(std::vector<uint32> const& cells, std::vector<MapUpdateRegion>& regions);
+        void MergeUpdateRegion(MapUpdateRegion& region);
+
+        // Serializes changes of map wide containers while cell regions are updated concurrently,
+        // does nothing when the map is updated by a single thread
+        class RegionGuard
+        {
+            public:
+                explicit RegionGuard(Map const* map) : m_lock(map->m_regionUpdateActive ? &map->m_regionLock : NULL)
+                {
+                    if (m_lock)
+                    {
+                        m_lock->acquire();
+                    }
+                }
+
+                ~RegionGuard()
+                {
+                    if (m_lock)
+                    {
+                        m_lock->release();
+                    }
+                }
+
+            private:
+                ACE_Recursive_Thread_Mutex* m_lock;
+        };
 
     protected:
         MapEntry const* i_mapEntry;
@@ -429,12 +565,24 @@ class Map : public GridRefManager<NGridType>
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
 
+        MapUpdateTimeStats m_updateTimeStats;
+
+        // cell region update state
+        std::vector<uint32> m_cellsToUpdate;
+        bool m_regionUpdateActive;
+        mutable ACE_Recursive_Thread_Mutex m_regionLock;
+        static thread_local MapUpdateRegion* m_currentUpdateRegion;
+
         // spawning
         // SpawnManager m_spawnManager;
         std::vector<uint32> m_activeZones;
         uint32 m_activeAreasTimer;
         bool hasRealPlayers;
 
+        PathRequestQueue m_pathRequests;
+        PathCache* m_pathCache;
+        LineOfSightCache* m_losCache;
+
 #ifdef ENABLE_ELUNA
         Eluna* eluna;
 #endif /* ENABLE_ELUNA */
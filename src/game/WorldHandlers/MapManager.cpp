@@ -43,7 +43,7 @@ INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, ACE_Recursive_Thread_Mutex);
 
 MapManager::MapManager()
-    : i_GridStateErrorCount(0), i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_GridStateErrorCount(0), i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)), i_numUpdateThreads(1)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -60,6 +60,31 @@ MapManager::~MapManager()
         delete *i;
     }
 
+    if (m_updater.activated())
+    {
+        m_updater.deactivate();
+    }
+
+    if (m_regionUpdater.activated())
+    {
+        m_regionUpdater.deactivate();
+    }
+
+    if (m_updatePacketSender.activated())
+    {
+        m_updatePacketSender.deactivate();
+    }
+
+    if (m_pathRequestUpdater.activated())
+    {
+        m_pathRequestUpdater.deactivate();
+    }
+
+    if (m_terrainPrefetcher.activated())
+    {
+        m_terrainPrefetcher.deactivate();
+    }
+
     DeleteStateMachine();
 }
 
@@ -67,6 +92,10 @@ void
 MapManager::Initialize()
 {
     int num_threads(sWorld.getConfig(CONFIG_UINT32_NUMTHREADS));
+    int num_region_threads(sWorld.getConfig(CONFIG_UINT32_NUMTHREADS_MAP_REGIONS));
+    int num_packet_threads(sWorld.getConfig(CONFIG_UINT32_NUMTHREADS_UPDATE_PACKETS));
+    int num_path_threads(sWorld.getConfig(CONFIG_UINT32_NUMTHREADS_PATHFINDING));
+    int num_prefetch_threads(sWorld.getConfig(CONFIG_UINT32_NUMTHREADS_TERRAIN_PREFETCH));
 
 #ifdef ENABLE_ELUNA
     if (sElunaConfig->IsElunaEnabled() && sElunaConfig->IsElunaCompatibilityMode() && num_threads > 1)
@@ -75,9 +104,85 @@ MapManager::Initialize()
         sLog.outError("Map update threads set to %i, when Eluna in compatibility mode only allows 1, changing to 1", num_threads);
         num_threads = 1;
     }
+
+    if (sElunaConfig->IsElunaEnabled() && num_region_threads > 0)
+    {
+        // Regions of one map would call into the same Lua state concurrently
+        sLog.outError("Map update region threads set to %i, when Eluna is enabled regions are not allowed, changing to 0", num_region_threads);
+        num_region_threads = 0;
+    }
+
+    if (sElunaConfig->IsElunaEnabled() && num_packet_threads > 0)
+    {
+        // OnPacketSend hooks would be called from the packet threads
+        sLog.outError("Map update packet threads set to %i, when Eluna is enabled they are not allowed, changing to 0", num_packet_threads);
+        num_packet_threads = 0;
+    }
 #endif /* ENABLE_ELUNA */
 
     InitStateMachine();
+
+    // a single update thread gains nothing over updating the maps in the world thread
+    if (num_threads > 1)
+    {
+        if (m_updater.activate(num_threads) == -1)
+        {
+            sLog.outError("MapManager: failed to start %i map update threads, maps will be updated in the world thread", num_threads);
+        }
+        else
+        {
+            i_numUpdateThreads = num_threads;
+            sLog.outString("MapManager: using %i map update threads", num_threads);
+        }
+    }
+
+    if (num_region_threads > 0)
+    {
+        if (m_regionUpdater.activate(num_region_threads) == -1)
+        {
+            sLog.outError("MapManager: failed to start %i map region update threads, continents will not be split into regions", num_region_threads);
+        }
+        else
+        {
+            sLog.outString("MapManager: using %i map region update threads", num_region_threads);
+        }
+    }
+
+    if (num_packet_threads > 0)
+    {
+        if (m_updatePacketSender.activate(num_packet_threads) == -1)
+        {
+            sLog.outError("MapManager: failed to start %i update packet threads, update packets will be sent by the map threads", num_packet_threads);
+        }
+        else
+        {
+            sLog.outString("MapManager: using %i update packet threads", num_packet_threads);
+        }
+    }
+
+    if (num_path_threads > 0)
+    {
+        if (m_pathRequestUpdater.activate(num_path_threads) == -1)
+        {
+            sLog.outError("MapManager: failed to start %i path threads, paths will be built by the map threads", num_path_threads);
+        }
+        else
+        {
+            sLog.outString("MapManager: using %i path threads", num_path_threads);
+        }
+    }
+
+    if (num_prefetch_threads > 0)
+    {
+        if (m_terrainPrefetcher.activate(num_prefetch_threads) == -1)
+        {
+            sLog.outError("MapManager: failed to start %i terrain prefetch threads, grids will be read when they are loaded", num_prefetch_threads);
+        }
+        else
+        {
+            sLog.outString("MapManager: using %i terrain prefetch threads", num_prefetch_threads);
+        }
+    }
 }
 
 void MapManager::InitStateMachine()
@@ -98,9 +203,9 @@ void MapManager::DeleteStateMachine()
 
 void MapManager::UpdateGridState(grid_state_t state, Map& map, NGridType& ngrid, GridInfo& ginfo, const uint32& x, const uint32& y, const uint32& t_diff)
 {
-    // TODO: The grid state array itself is static and therefore 100% safe, however, the data
-    // the state classes in it accesses is not, since grids are shared across maps (for example
-    // in instances), so some sort of locking will be necessary later.
+    // The grid state array itself is static and therefore 100% safe. The states change the
+    // NGrid of the map only, the terrain behind it is shared by the instances of a map id,
+    // which MapUpdater never updates concurrently (see MapManager::Update).
 
     si_GridStates[state]->Update(map, ngrid, ginfo, x, y, t_diff);
 }
@@ -206,11 +311,30 @@ void MapManager::Update(uint32 diff)
         return;
     }
 
+    // i_maps is ordered by map id, the instances of an id are updated by the same thread
+    std::vector<Map*> sameTerrain;
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
     {
-        iter->second->Update((uint32)i_timer.GetCurrent());
+        if (!sameTerrain.empty() && sameTerrain.front()->GetId() != iter->first.nMapId)
+        {
+            m_updater.schedule_update(sameTerrain, (uint32)i_timer.GetCurrent());
+            sameTerrain.clear();
+        }
+
+        sameTerrain.push_back(iter->second);
+    }
+
+    if (!sameTerrain.empty())
+    {
+        m_updater.schedule_update(sameTerrain, (uint32)i_timer.GetCurrent());
     }
 
+    // all maps must be done before transports move between them or maps get unloaded
+    m_updater.wait();
+
+    // terrains only referenced by finished prefetch requests can go now
+    m_terrainPrefetcher.Update();
+
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
         WorldObject::UpdateHelper helper((*iter));
@@ -266,6 +390,27 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    if (m_updater.activated())
+    {
+        m_updater.deactivate();
+    }
+
+    if (m_regionUpdater.activated())
+    {
+        m_regionUpdater.deactivate();
+    }
+
+    if (m_updatePacketSender.activated())
+    {
+        m_updatePacketSender.deactivate();
+    }
+
+    // the queued reads hold references on the terrains deleted below
+    if (m_terrainPrefetcher.activated())
+    {
+        m_terrainPrefetcher.deactivate();
+    }
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
     {
         iter->second->UnloadAll(true);
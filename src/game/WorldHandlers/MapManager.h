@@ -31,6 +31,11 @@
 #include "ace/Recursive_Thread_Mutex.h"
 #include "Map.h"
 #include "GridStates.h"
+#include "MapUpdater.h"
+#include "MapRegionUpdater.h"
+#include "UpdatePacketSender.h"
+#include "PathRequestQueue.h"
+#include "TerrainPrefetcher.h"
 
 class Transport;
 class BattleGround;
@@ -142,6 +147,19 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
+        uint32 GetNumMapUpdateThreads() const { return i_numUpdateThreads; }
+
+        // NULL when continents are not split into concurrently updated regions
+        MapRegionUpdater* GetRegionUpdater() { return m_regionUpdater.activated() ? &m_regionUpdater : NULL; }
+
+        // builds and sends the object update packets of the maps, in the calling thread when not activated
+        UpdatePacketSender& GetUpdatePacketSender() { return m_updatePacketSender; }
+
+        // NULL when the queued paths are built by the map threads alone
+        PathRequestUpdater* GetPathRequestUpdater() { return m_pathRequestUpdater.activated() ? &m_pathRequestUpdater : NULL; }
+
+        // NULL when grids are only read from disk when they are loaded
+        TerrainPrefetcher* GetTerrainPrefetcher() { return m_terrainPrefetcher.activated() ? &m_terrainPrefetcher : NULL; }
 
 
         // get list of all maps
@@ -183,6 +201,13 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
         IntervalTimer i_timer;
+
+        MapUpdater m_updater;
+        uint32 i_numUpdateThreads;
+        MapRegionUpdater m_regionUpdater;
+        UpdatePacketSender m_updatePacketSender;
+        PathRequestUpdater m_pathRequestUpdater;
+        TerrainPrefetcher m_terrainPrefetcher;
 };
 
 template<typename Do>
@@ -137,11 +137,15 @@ void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
 {
     if (t > sWorld.GetGameTime())
     {
+        std::lock_guard<std::mutex> guard(m_respawnTimesLock);
         m_creatureRespawnTimes[loguid] = t;
     }
     else
     {
-        m_creatureRespawnTimes.erase(loguid);
+        {
+            std::lock_guard<std::mutex> guard(m_respawnTimesLock);
+            m_creatureRespawnTimes.erase(loguid);
+        }
         UnloadIfEmpty();
     }
 }
@@ -150,11 +154,15 @@ void MapPersistentState::SetGORespawnTime(uint32 loguid, time_t t)
 {
     if (t > sWorld.GetGameTime())
     {
+        std::lock_guard<std::mutex> guard(m_respawnTimesLock);
         m_goRespawnTimes[loguid] = t;
     }
     else
     {
-        m_goRespawnTimes.erase(loguid);
+        {
+            std::lock_guard<std::mutex> guard(m_respawnTimesLock);
+            m_goRespawnTimes.erase(loguid);
+        }
         UnloadIfEmpty();
     }
 }
@@ -99,12 +99,14 @@ class MapPersistentState
 
         time_t GetCreatureRespawnTime(uint32 loguid) const
         {
+            std::lock_guard<std::mutex> guard(m_respawnTimesLock);
             RespawnTimes::const_iterator itr = m_creatureRespawnTimes.find(loguid);
             return itr != m_creatureRespawnTimes.end() ? itr->second : 0;
         }
         void SaveCreatureRespawnTime(uint32 loguid, time_t t);
         time_t GetGORespawnTime(uint32 loguid) const
         {
+            std::lock_guard<std::mutex> guard(m_respawnTimesLock);
             RespawnTimes::const_iterator itr = m_goRespawnTimes.find(loguid);
             return itr != m_goRespawnTimes.end() ? itr->second : 0;
         }
@@ -145,6 +147,7 @@ class MapPersistentState
         // persistent data
         RespawnTimes m_creatureRespawnTimes;                // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
+        mutable std::mutex m_respawnTimesLock;              // creatures of different cell regions may die or respawn at the same time
         MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
 };
 
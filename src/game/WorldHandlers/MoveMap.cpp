@@ -30,8 +30,13 @@
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
 
+#include <ace/Guard_T.h>
+
 namespace MMAP
 {
+    // prefetched tiles not loaded by then were read for a grid the player never reached
+    static const uint32 PREFETCH_EXPIRE_TIME = 60 * IN_MILLISECONDS;
+
     // ######################## MMapFactory ########################
     // our global singelton copy
     MMapManager* g_MMapManager = NULL;
@@ -153,14 +158,34 @@ namespace MMAP
             delete i->second;
         }
 
+        for (PrefetchedTileSet::iterator i = prefetchedTiles.begin(); i != prefetchedTiles.end(); ++i)
+        {
+            dtFree(i->second.data);
+        }
+
         // by now we should not have maps loaded
         // if we had, tiles in MMapData->mmapLoadedTiles, their actual data is lost!
     }
 
+    MMapData* MMapManager::findMapData(uint32 mapId)
+    {
+        // the data is only deleted by unloadMap(mapId), once no map of this id is left
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mapsLock, NULL);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        return itr != loadedMMaps.end() ? itr->second : NULL;
+    }
+
+    uint32 MMapManager::getLoadedMapsCount()
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mapsLock, 0);
+        return loadedMMaps.size();
+    }
+
     bool MMapManager::loadMapData(uint32 mapId)
     {
         // we already have this map loaded?
-        if (loadedMMaps.find(mapId) != loadedMMaps.end())
+        if (findMapData(mapId))
         {
             return true;
         }
@@ -200,10 +225,14 @@ namespace MMAP
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMapData: Loaded %03i.mmap", mapId);
 
         // store inside our map list
-        MMapData* mmap_data = new MMapData(mesh);
+        MMapData* mmap_data = new MMapData(mesh, ++lastTileGeneration);
         mmap_data->mmapLoadedTiles.clear();
 
-        loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mapsLock, false);
+        if (!loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data)).second)
+        {
+            delete mmap_data;
+        }
         return true;
     }
 
@@ -221,8 +250,10 @@ namespace MMAP
         }
 
         // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
-        MANGOS_ASSERT(mmap->navMesh);
+        MMapData* mmap = findMapData(mapId);
+        MANGOS_ASSERT(mmap && mmap->navMesh);
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, tilesGuard, mmap->tilesLock, false);
 
         // check if we already have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
@@ -232,6 +263,47 @@ namespace MMAP
             return false;
         }
 
+        unsigned char* data = NULL;
+        uint32 size = 0;
+
+        // the tile may have been read ahead by the terrain prefetch threads
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_prefetchLock, false);
+
+            PrefetchedTileSet::iterator prefetched = prefetchedTiles.find(uint64(mapId) << 32 | packedGridPos);
+            if (prefetched != prefetchedTiles.end())
+            {
+                data = prefetched->second.data;
+                size = prefetched->second.size;
+                prefetchedTiles.erase(prefetched);
+            }
+        }
+
+        if (!data && !readTile(mapId, x, y, data, size))
+        {
+            return false;
+        }
+
+        dtMeshHeader* header = (dtMeshHeader*)data;
+        dtTileRef tileRef = 0;
+
+        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
+        if (mmap->navMesh->addTile(data, size, DT_TILE_FREE_DATA, 0, &tileRef) != DT_SUCCESS)
+        {
+            sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
+            dtFree(data);
+            return false;
+        }
+
+        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        mmap->tileGeneration = ++lastTileGeneration;
+        ++loadedTiles;
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
+        return true;
+    }
+
+    bool MMapManager::readTile(uint32 mapId, int32 x, int32 y, unsigned char*& data, uint32& size)
+    {
         // load this tile :: mmaps/MMMXXYY.mmtile
         uint32 pathLen = sWorld.GetDataPath().length() + strlen("mmaps/%03i%02i%02i.mmtile") + 1;
         char* fileName = new char[pathLen];
@@ -265,7 +337,7 @@ namespace MMAP
             return false;
         }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
+        data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
         MANGOS_ASSERT(data);
 
         size_t result = fread(data, fileHeader.size, 1, file);
@@ -273,39 +345,88 @@ namespace MMAP
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
             fclose(file);
+            dtFree(data);
+            data = NULL;
             return false;
         }
 
         fclose(file);
 
-        dtMeshHeader* header = (dtMeshHeader*)data;
-        dtTileRef tileRef = 0;
+        size = fileHeader.size;
+        return true;
+    }
+
+    void MMapManager::prefetchTile(uint32 mapId, int32 x, int32 y)
+    {
+        uint64 key = uint64(mapId) << 32 | packTileID(x, y);
 
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        if (mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef) != DT_SUCCESS)
         {
-            sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
-            return false;
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_prefetchLock);
+
+            for (PrefetchedTileSet::iterator i = prefetchedTiles.begin(); i != prefetchedTiles.end();)
+            {
+                if (GetMSTimeDiffToNow(i->second.readTime) > PREFETCH_EXPIRE_TIME)
+                {
+                    dtFree(i->second.data);
+                    i = prefetchedTiles.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            if (prefetchedTiles.find(key) != prefetchedTiles.end())
+            {
+                return;
+            }
         }
 
-        mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
-        ++loadedTiles;
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
-        return true;
+        PrefetchedTile tile;
+        if (!readTile(mapId, x, y, tile.data, tile.size))
+        {
+            return;
+        }
+        tile.readTime = getMSTime();
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_prefetchLock);
+
+        if (!prefetchedTiles.insert(PrefetchedTileSet::value_type(key, tile)).second)
+        {
+            dtFree(tile.data);
+        }
+    }
+
+    void MMapManager::dropPrefetchedTiles(uint32 mapId)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_prefetchLock);
+
+        for (PrefetchedTileSet::iterator i = prefetchedTiles.begin(); i != prefetchedTiles.end();)
+        {
+            if (uint32(i->first >> 32) == mapId)
+            {
+                dtFree(i->second.data);
+                i = prefetchedTiles.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
     }
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
         // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = findMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map. %03u%02i%02i.mmtile", mapId, x, y);
             return false;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, tilesGuard, mmap->tilesLock, false);
 
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
@@ -330,6 +451,7 @@ namespace MMAP
         else
         {
             mmap->mmapLoadedTiles.erase(packedGridPos);
+            mmap->tileGeneration = ++lastTileGeneration;
             --loadedTiles;
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
@@ -340,15 +462,25 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        dropPrefetchedTiles(mapId);
+
+        MMapData* mmap = NULL;
         {
-            // file may not exist, therefore not loaded
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map %03u", mapId);
-            return false;
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mapsLock, false);
+
+            MMapDataSet::iterator itr = loadedMMaps.find(mapId);
+            if (itr == loadedMMaps.end())
+            {
+                // file may not exist, therefore not loaded
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map %03u", mapId);
+                return false;
+            }
+
+            mmap = itr->second;
+            loadedMMaps.erase(itr);
         }
 
         // unload all tiles from given map
-        MMapData* mmap = loadedMMaps[mapId];
         for (MMapTileSet::iterator i = mmap->mmapLoadedTiles.begin(); i != mmap->mmapLoadedTiles.end(); ++i)
         {
             uint32 x = (i->first >> 16);
@@ -365,7 +497,6 @@ namespace MMAP
         }
 
         delete mmap;
-        loadedMMaps.erase(mapId);
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded %03i.mmap", mapId);
 
         return true;
@@ -374,24 +505,38 @@ namespace MMAP
     bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
     {
         // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = findMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
             return false;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_queriesLock, false);
+
+        bool found = false;
+        for (NavMeshQuerySet::iterator itr = mmap->navMeshQueries.begin(); itr != mmap->navMeshQueries.end();)
+        {
+            // all slots of the instance
+            if (uint32(itr->first) == instanceId)
+            {
+                dtFreeNavMeshQuery(itr->second);
+                itr = mmap->navMeshQueries.erase(itr);
+                found = true;
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+
+        if (!found)
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
             return false;
         }
 
-        dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-        dtFreeNavMeshQuery(query);
-        mmap->navMeshQueries.erase(instanceId);
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
         return true;
@@ -399,23 +544,37 @@ namespace MMAP
 
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = findMapData(mapId);
+        return mmap ? mmap->navMesh : NULL;
+    }
+
+    uint32 MMapManager::GetTileGeneration(uint32 mapId)
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mapsLock, 0);
+
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
         {
-            return NULL;
+            return 0;
         }
 
-        return loadedMMaps[mapId]->navMesh;
+        return itr->second->tileGeneration;
     }
 
-    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
+    dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId, uint32 slot /*= 0*/)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = findMapData(mapId);
+        if (!mmap)
         {
             return NULL;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+        uint64 queryKey = (uint64(slot) << 32) | instanceId;
+
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_queriesLock, NULL);
+
+        NavMeshQuerySet::const_iterator itr = mmap->navMeshQueries.find(queryKey);
+        if (itr == mmap->navMeshQueries.end())
         {
             // allocate mesh query
             dtNavMeshQuery* query = dtAllocNavMeshQuery();
@@ -427,10 +586,10 @@ namespace MMAP
                 return NULL;
             }
 
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u slot %u", mapId, instanceId, slot);
+            itr = mmap->navMeshQueries.insert(NavMeshQuerySet::value_type(queryKey, query)).first;
         }
 
-        return mmap->navMeshQueries[instanceId];
+        return itr->second;
     }
 }
@@ -27,6 +27,10 @@
 
 #include "Define.h"
 
+#include <ace/Thread_Mutex.h>
+
+#include <atomic>
+
 #include "../../dep/recastnavigation/Detour/Include/DetourAlloc.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMesh.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMeshQuery.h"
@@ -48,12 +52,12 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_map<uint64, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh, uint32 generation) : navMesh(mesh), tileGeneration(generation) {}
         ~MMapData()
         {
             for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
@@ -70,38 +74,66 @@ namespace MMAP
         dtNavMesh* navMesh;
 
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
-        MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        // path threads building paths of the same instance get one more query each (slot > 0)
+        NavMeshQuerySet navMeshQueries;     // [slot, instanceId] to query
+        MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile], guarded by tilesLock
+        std::atomic<uint32> tileGeneration; // changes whenever a tile is loaded or unloaded, read by the path threads
+        ACE_Thread_Mutex tilesLock;         // dtNavMesh::addTile and removeTile are not thread safe
     };
 
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
 
+    // tile file read ahead of its grid, handed to the navmesh by loadMap
+    struct PrefetchedTile
+    {
+        unsigned char* data;
+        uint32 size;
+        uint32 readTime;
+    };
+
+    typedef std::unordered_map<uint64, PrefetchedTile> PrefetchedTileSet;
+
     // singelton class
     // holds all all access to mmap loading unloading and meshes
     class MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0) {}
+            MMapManager() : loadedTiles(0), lastTileGeneration(0) {}
             ~MMapManager();
 
             bool loadMap(uint32 mapId, int32 x, int32 y);
+            // read the tile file for a later loadMap, may be called from any thread
+            void prefetchTile(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
-            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // the returned [dtNavMeshQuery const*] is NOT threadsafe, use one slot per thread
+            dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId, uint32 slot = 0);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            // never the same value twice for a map, even across reloads; 0 if the map is not loaded
+            uint32 GetTileGeneration(uint32 mapId);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
-            uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+            uint32 getLoadedMapsCount();
         private:
             bool loadMapData(uint32 mapId);
+            MMapData* findMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
+            bool readTile(uint32 mapId, int32 x, int32 y, unsigned char*& data, uint32& size);
+            void dropPrefetchedTiles(uint32 mapId);
 
             MMapDataSet loadedMMaps;
-            uint32 loadedTiles;
+            std::atomic<uint32> loadedTiles;
+            std::atomic<uint32> lastTileGeneration;   // maps load their tiles concurrently
+
+            ACE_Thread_Mutex m_mapsLock;     // loadedMMaps, maps of different ids are updated concurrently
+            ACE_Thread_Mutex m_queriesLock;  // instances of the same map ask for their queries concurrently
+
+            PrefetchedTileSet prefetchedTiles;  // [mapId, packed tile] to data not yet in a navmesh
+            ACE_Thread_Mutex m_prefetchLock;
     };
 
     // static class
@@ -857,6 +857,8 @@ void Spell::FillTargetMap()
             }
         }
 
+        PrefetchLineOfSight(tmpUnitLists[effToIndex[i]]);
+
         for (UnitList::iterator itr = tmpUnitLists[effToIndex[i]].begin(); itr != tmpUnitLists[effToIndex[i]].end();)
         {
             if (!CheckTarget(*itr, SpellEffectIndex(i)))
@@ -9522,6 +9524,33 @@ void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPu
     Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
 }
 
+/**
+ * Test the line of sight from the casting object to all targets in one batch
+ *
+ * The results go to the map line of sight cache, so the checks of CheckTarget on the
+ * same targets do not traverse the vmap tree again. Nothing is done without the cache.
+ *
+ * @param targetUnitMap        Targets of an effect, usually an AoE pack
+ */
+void Spell::PrefetchLineOfSight(UnitList const& targetUnitMap) const
+{
+    if (targetUnitMap.size() < 2 || m_spellInfo->HasAttribute(SPELL_ATTR_EX2_IGNORE_LOS))
+    {
+        return;
+    }
+
+    WorldObject* caster = GetCastingObject();
+    if (!caster || !caster->GetMap()->GetLineOfSightCache())
+    {
+        return;
+    }
+
+    std::vector<WorldObject const*> targets(targetUnitMap.begin(), targetUnitMap.end());
+    bool* inLos = new bool[targets.size()];
+    caster->IsWithinLOSInMap(uint32(targets.size()), &targets[0], inLos);
+    delete[] inLos;
+}
+
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, Unit* center, float radius, bool raid, bool withPets, bool withcaster)
 {
     Player* pMember = member->GetCharmerOrOwnerPlayerOrPlayerItself();
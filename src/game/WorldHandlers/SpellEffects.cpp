@@ -6358,23 +6358,23 @@ void Spell::EffectSummonType(SpellEffectEntry const* effect)
 
     // Set summon positions
     float radius = GetSpellRadius(sSpellRadiusStore.LookupEntry(effect->GetRadiusIndex()));
-    CreatureSummonPositions::iterator itr = summonPositions.begin();
-    for (++itr; itr != summonPositions.end(); ++itr)        // In case of multiple summons around position for not-fist positions
+    if (summonPositions.size() > 1)                         // In case of multiple summons around position for not-fist positions
     {
-        if (m_targets.m_targetMask & TARGET_FLAG_DEST_LOCATION || radius > 1.0f)
-        {
-            realCaster->GetRandomPoint(summonPositions[0].x, summonPositions[0].y, summonPositions[0].z, radius, itr->x, itr->y, itr->z);
-            if (realCaster->GetMap()->GetHitPosition(summonPositions[0].x, summonPositions[0].y, summonPositions[0].z, itr->x, itr->y, itr->z, m_caster->GetPhaseMask(), -0.5f))
-            {
-                realCaster->UpdateAllowedPositionZ(itr->x, itr->y, itr->z);
-            }
-        }
-        else                                                // Get a point near the caster
+        // the ground heights of all random points are looked up together
+        uint32 count = summonPositions.size() - 1;
+        std::vector<float> randX(count), randY(count), randZ(count);
+        realCaster->GetRandomPoints(summonPositions[0].x, summonPositions[0].y, summonPositions[0].z, radius, count, &randX[0], &randY[0], &randZ[0]);
+
+        for (uint32 i = 0; i < count; ++i)
         {
-            realCaster->GetRandomPoint(summonPositions[0].x, summonPositions[0].y, summonPositions[0].z, radius, itr->x, itr->y, itr->z);
-            if (realCaster->GetMap()->GetHitPosition(summonPositions[0].x, summonPositions[0].y, summonPositions[0].z, itr->x, itr->y, itr->z, m_caster->GetPhaseMask(), -0.5f))
+            CreaturePosition& pos = summonPositions[i + 1];
+            pos.x = randX[i];
+            pos.y = randY[i];
+            pos.z = randZ[i];
+
+            if (realCaster->GetMap()->GetHitPosition(summonPositions[0].x, summonPositions[0].y, summonPositions[0].z, pos.x, pos.y, pos.z, m_caster->GetPhaseMask(), -0.5f))
             {
-                realCaster->UpdateAllowedPositionZ(itr->x, itr->y, itr->z);
+                realCaster->UpdateAllowedPositionZ(pos.x, pos.y, pos.z);
             }
         }
     }
@@ -6515,7 +6515,7 @@ void Spell::EffectSummonType(SpellEffectEntry const* effect)
         return;                                             // No further handling required
     }
 
-    for (itr = summonPositions.begin(); itr != summonPositions.end(); ++itr)
+    for (CreatureSummonPositions::iterator itr = summonPositions.begin(); itr != summonPositions.end(); ++itr)
     {
         MANGOS_ASSERT(itr->creature || itr != summonPositions.begin());
         if (!itr->creature)
@@ -0,0 +1,251 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#include "StartupLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+#include "Timer.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+#include <algorithm>
+
+class StartupLoadRequest : public ACE_Method_Request
+{
+    public:
+
+        StartupLoadRequest(StartupLoader& loader, uint32 id) : m_loader(loader), m_id(id)
+        {
+        }
+
+        virtual int call() override
+        {
+            m_loader.Load(m_id);
+            return 0;
+        }
+
+    private:
+
+        StartupLoader& m_loader;
+        uint32 m_id;
+};
+
+// Prepares the worker threads for database access
+class StartupThreadHook : public ACE_Method_Request
+{
+    public:
+
+        explicit StartupThreadHook(bool start) : m_start(start)
+        {
+        }
+
+        virtual int call() override
+        {
+            if (m_start)
+            {
+                WorldDatabase.ThreadStart();
+            }
+            else
+            {
+                WorldDatabase.ThreadEnd();
+            }
+
+            return 0;
+        }
+
+    private:
+
+        bool m_start;
+};
+
+StartupLoader::StartupLoader(char const* groupName)
+    : m_groupName(groupName), m_mutex(), m_condition(m_mutex), m_remaining(0)
+{
+}
+
+uint32 StartupLoader::Add(char const* name, LoadFunction const& function, std::initializer_list<uint32> dependsOn)
+{
+    uint32 id = uint32(m_loaders.size());
+
+    LoaderInfo info;
+    info.name = name;
+    info.function = function;
+    info.pendingDependencies = 0;
+    info.loadTime = 0;
+
+    for (std::initializer_list<uint32>::const_iterator itr = dependsOn.begin(); itr != dependsOn.end(); ++itr)
+    {
+        // only earlier loaders, so the declaration order is a valid sequential order
+        MANGOS_ASSERT(*itr < id);
+
+        m_loaders[*itr].dependents.push_back(id);
+        ++info.pendingDependencies;
+    }
+
+    m_loaders.push_back(info);
+    return id;
+}
+
+void StartupLoader::Run(uint32 numThreads)
+{
+    uint32 startTime = getMSTime();
+
+    if (numThreads > 1 && m_loaders.size() > 1)
+    {
+        RunParallel(numThreads);
+    }
+    else
+    {
+        RunSequential();
+    }
+
+    PrintReport(GetMSTimeDiffToNow(startTime));
+}
+
+void StartupLoader::RunSequential()
+{
+    for (size_t i = 0; i < m_loaders.size(); ++i)
+    {
+        LoadOne(m_loaders[i]);
+    }
+}
+
+void StartupLoader::RunParallel(uint32 numThreads)
+{
+    numThreads = std::min(numThreads, uint32(m_loaders.size()));
+
+    if (m_executor.activate(int(numThreads), new StartupThreadHook(true), new StartupThreadHook(false)) == -1)
+    {
+        sLog.outError("StartupLoader: could not start %u threads, loading %s sequentially", numThreads, m_groupName);
+        RunSequential();
+        return;
+    }
+
+    m_remaining = m_loaders.size();
+
+    // collect the roots first, the workers update the counters of the others
+    std::vector<uint32> roots;
+    for (size_t i = 0; i < m_loaders.size(); ++i)
+    {
+        if (m_loaders[i].pendingDependencies == 0)
+        {
+            roots.push_back(uint32(i));
+        }
+    }
+
+    for (size_t i = 0; i < roots.size(); ++i)
+    {
+        Schedule(roots[i]);
+    }
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+        while (m_remaining > 0)
+        {
+            m_condition.wait();
+        }
+    }
+
+    m_executor.deactivate();
+}
+
+void StartupLoader::Schedule(uint32 id)
+{
+    if (m_executor.execute(new StartupLoadRequest(*this, id)) == -1)
+    {
+        // could not queue it, load it here instead of waiting forever
+        Load(id);
+    }
+}
+
+void StartupLoader::Load(uint32 id)
+{
+    LoadOne(m_loaders[id]);
+
+    std::vector<uint32> ready;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+        std::vector<uint32> const& dependents = m_loaders[id].dependents;
+        for (size_t i = 0; i < dependents.size(); ++i)
+        {
+            if (--m_loaders[dependents[i]].pendingDependencies == 0)
+            {
+                ready.push_back(dependents[i]);
+            }
+        }
+
+        if (--m_remaining == 0)
+        {
+            m_condition.broadcast();
+        }
+    }
+
+    for (size_t i = 0; i < ready.size(); ++i)
+    {
+        Schedule(ready[i]);
+    }
+}
+
+void StartupLoader::LoadOne(LoaderInfo& loader)
+{
+    sLog.outString("Loading %s...", loader.name);
+
+    uint32 startTime = getMSTime();
+
+    loader.function();
+
+    loader.loadTime = GetMSTimeDiffToNow(startTime);
+}
+
+void StartupLoader::PrintReport(uint32 totalTime) const
+{
+    std::vector<LoaderInfo const*> sorted;
+    uint32 loadTime = 0;
+
+    for (size_t i = 0; i < m_loaders.size(); ++i)
+    {
+        sorted.push_back(&m_loaders[i]);
+        loadTime += m_loaders[i].loadTime;
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](LoaderInfo const* a, LoaderInfo const* b)
+    {
+        return a->loadTime > b->loadTime;
+    });
+
+    sLog.outString();
+    sLog.outString(">>> %s loaded in %u ms (%u ms in %zu loaders)", m_groupName, totalTime, loadTime, m_loaders.size());
+
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        sLog.outString("    %6u ms  %s", sorted[i]->loadTime, sorted[i]->name);
+    }
+
+    sLog.outString();
+}
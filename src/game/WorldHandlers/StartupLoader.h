@@ -0,0 +1,97 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+
+#ifndef MANGOS_STARTUPLOADER_H
+#define MANGOS_STARTUPLOADER_H
+
+#include "Common.h"
+#include "Threading/DelayExecutor.h"
+
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+#include <functional>
+#include <initializer_list>
+
+/**
+ * @brief Runs a group of startup loaders, independent ones concurrently.
+ *
+ * Loaders are declared in an order that is valid for sequential loading, each
+ * one listing the ids of the earlier loaders it needs. With worker threads a
+ * loader is started as soon as all its dependencies are done, without worker
+ * threads they are run one after the other in declaration order. Either way a
+ * timing report of the group is printed at the end.
+ *
+ * Loaders running concurrently must not write to shared containers, and use
+ * the database only through synchronous queries (the query connection pool
+ * is shared by all threads).
+ */
+class StartupLoader
+{
+    public:
+
+        typedef std::function<void()> LoadFunction;
+
+        explicit StartupLoader(char const* groupName);
+
+        /// Declare a loader, returns the id other loaders use to depend on it
+        uint32 Add(char const* name, LoadFunction const& function, std::initializer_list<uint32> dependsOn = {});
+
+        /// Run all loaders and print the timing report, returns when everything is loaded
+        void Run(uint32 numThreads);
+
+    private:
+
+        friend class StartupLoadRequest;
+
+        struct LoaderInfo
+        {
+            char const* name;
+            LoadFunction function;
+            std::vector<uint32> dependents;
+            uint32 pendingDependencies;
+            uint32 loadTime;
+        };
+
+        void RunSequential();
+        void RunParallel(uint32 numThreads);
+        void Schedule(uint32 id);
+
+        /// Called by the worker threads, runs one loader and schedules the ones waiting for it
+        void Load(uint32 id);
+        void LoadOne(LoaderInfo& loader);
+
+        void PrintReport(uint32 totalTime) const;
+
+        char const* m_groupName;
+        std::vector<LoaderInfo> m_loaders;
+
+        DelayExecutor m_executor;
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+        size_t m_remaining;
+};
+
+#endif
@@ -47,16 +47,81 @@ void UpdateData::AddOutOfRangeGUID(ObjectGuid const& guid)
     m_outOfRangeGUIDs.insert(guid);
 }
 
+std::atomic<uint32> UpdateData::s_compressionLevel(1);
+std::atomic<uint32> UpdateData::s_compressionThreshold(0);
+std::atomic<uint64> UpdateData::s_compressedPackets(0);
+std::atomic<uint64> UpdateData::s_compressedBytesIn(0);
+std::atomic<uint64> UpdateData::s_compressedBytesOut(0);
+
+// deflate stream of the current thread, reset for each packet instead of allocated again
+struct UpdateDataDeflateStream
+{
+    UpdateDataDeflateStream() : level(0) {}
+    ~UpdateDataDeflateStream()
+    {
+        if (level)
+        {
+            deflateEnd(&stream);
+        }
+    }
+
+    z_stream stream;
+    uint32 level;                                           // 0 - not initialized
+};
+
+static thread_local UpdateDataDeflateStream t_deflateStream;
+
+void UpdateData::UpdateCompression(uint32 averageWorldDiff)
+{
+    uint32 threshold = sWorld.getConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD);
+    uint32 level = sWorld.getConfig(CONFIG_UINT32_COMPRESSION);
+    uint32 interval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE);
+
+    if (threshold && averageWorldDiff > 2 * interval)
+    {
+        // no headroom left, only the biggest bursts and at the cheapest level
+        threshold *= 4;
+        level = Z_BEST_SPEED;
+    }
+    else if (threshold && averageWorldDiff > interval)
+    {
+        threshold *= 2;
+        level = (level + Z_BEST_SPEED) / 2;
+    }
+
+    s_compressionThreshold = threshold;
+    s_compressionLevel = level;
+}
+
 void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
 {
-    z_stream c_stream;
+    z_stream& c_stream = t_deflateStream.stream;
+    uint32 level = s_compressionLevel;
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+    int z_res;
+    if (t_deflateStream.level == level)
+    {
+        z_res = deflateReset(&c_stream);
+    }
+    else
+    {
+        if (t_deflateStream.level)
+        {
+            deflateEnd(&c_stream);
+            t_deflateStream.level = 0;
+        }
+
+        c_stream.zalloc = (alloc_func)0;
+        c_stream.zfree = (free_func)0;
+        c_stream.opaque = (voidpf)0;
+
+        z_res = deflateInit(&c_stream, level);
+        if (z_res == Z_OK)
+        {
+            t_deflateStream.level = level;
+        }
+    }
 
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
@@ -69,21 +134,7 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
     c_stream.next_in = (Bytef*)src;
     c_stream.avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    if (c_stream.avail_in != 0)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
-        *dst_size = 0;
-        return;
-    }
-
+    // dst is sized with compressBound, so everything fits in one call
     z_res = deflate(&c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
@@ -92,14 +143,6 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
     *dst_size = c_stream.total_out;
 }
 
@@ -127,25 +170,33 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
 
     size_t pSize = buf.wpos();                              // use real used data size
 
-    //if (pSize > 100)                                        // compress large packets
-    //{
-    //    uint32 destsize = compressBound(pSize);
-    //    packet->resize(destsize + sizeof(uint32));
+    uint32 threshold = s_compressionThreshold;
+    if (threshold && pSize >= threshold)                    // compress large packets
+    {
+        uint32 destsize = compressBound(pSize);
+        packet->resize(destsize + sizeof(uint32));
+
+        packet->put<uint32>(0, pSize);
+        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
 
-    //    packet->put<uint32>(0, pSize);
-    //    Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
-    //    if (destsize == 0)
-    //        return false;
+        // keep the packet as it is if compression failed or did not pay off
+        if (destsize && destsize + sizeof(uint32) < pSize)
+        {
+            packet->resize(destsize + sizeof(uint32));
+            packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
 
-    //    packet->resize(destsize + sizeof(uint32));
-    //    packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
-    //}
-    //else                                                    // send small packets without compression
-    {
-        packet->append(buf);
-        packet->SetOpcode(SMSG_UPDATE_OBJECT);
+            ++s_compressedPackets;
+            s_compressedBytesIn += pSize;
+            s_compressedBytesOut += destsize + sizeof(uint32);
+            return true;
+        }
+
+        packet->clear();
     }
 
+    packet->append(buf);
+    packet->SetOpcode(SMSG_UPDATE_OBJECT);
+
     return true;
 }
 
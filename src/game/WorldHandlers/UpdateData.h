@@ -28,6 +28,8 @@
 #include "ByteBuffer.h"
 #include "ObjectGuid.h"
 
+#include <atomic>
+
 class WorldPacket;
 
 enum ObjectUpdateType
@@ -75,6 +77,13 @@ class UpdateData
 
         void SetMapId(uint16 mapId) { m_map = mapId; }
 
+        /// Pick the compression threshold and level from the configuration and the world load, called each world tick
+        static void UpdateCompression(uint32 averageWorldDiff);
+
+        static uint64 GetCompressedPackets() { return s_compressedPackets; }
+        static uint64 GetCompressedBytesIn() { return s_compressedBytesIn; }
+        static uint64 GetCompressedBytesOut() { return s_compressedBytesOut; }
+
     protected:
         uint16 m_map;
         uint32 m_blockCount;
@@ -82,5 +91,13 @@ class UpdateData
         ByteBuffer m_data;
 
         void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+
+        static std::atomic<uint32> s_compressionLevel;
+        static std::atomic<uint32> s_compressionThreshold;  // 0 - compression disabled
+
+        // totals of the packets sent compressed, for the bytes saved
+        static std::atomic<uint64> s_compressedPackets;
+        static std::atomic<uint64> s_compressedBytesIn;
+        static std::atomic<uint64> s_compressedBytesOut;
 };
 #endif
@@ -28,6 +28,7 @@
 
 #include "World.h"
 #include "Database/DatabaseEnv.h"
+#include "Database/SQLStorage.h"
 #include "Config/Config.h"
 #include "Platform/Define.h"
 #include "SystemConfig.h"
@@ -53,6 +54,8 @@
 #include "LootMgr.h"
 #include "ItemEnchantmentMgr.h"
 #include "MapManager.h"
+#include "WorldSessionUpdater.h"
+#include "OpcodeProfiler.h"
 #include "ScriptMgr.h"
 #include "CreatureAIRegistry.h"
 #include "Policies/Singleton.h"
@@ -81,6 +84,8 @@
 #include "CommandMgr.h"
 #include "GitRevision.h"
 #include "UpdateTime.h"
+#include "UpdateData.h"
+#include "StartupLoader.h"
 #include "GameTime.h"
 
 #ifdef ENABLE_ELUNA
@@ -118,7 +123,7 @@ float  World::m_relocation_lower_limit_sq     = 10.f * 10.f;
 uint32 World::m_relocation_ai_notify_delay    = 1000u;
 
 /// World constructor
-World::World(): mail_timer(0), mail_timer_expires(0), m_NextMonthlyQuestReset(0)
+World::World(): mail_timer(0), mail_timer_expires(0), m_NextMonthlyQuestReset(0), m_sessionUpdater(NULL)
 {
     m_playerLimit = 0;
     m_allowMovement = true;
@@ -185,6 +190,8 @@ World::~World()
         delete session;
     }
 
+    delete m_sessionUpdater;
+
     VMAP::VMapFactory::clear();
     MMAP::MMapFactory::clear();
 }
@@ -579,6 +586,7 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    setConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD, "Compression.Threshold", 0);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
@@ -621,7 +629,13 @@ void World::LoadConfigSettings(bool reload)
         sMapMgr.SetGridCleanUpDelay(getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN));
     }
 
-    setConfig(CONFIG_UINT32_NUMTHREADS, "MapUpdateThreads", 2);
+    setConfig(CONFIG_UINT32_NUMTHREADS, "MapUpdateThreads", 0);
+    setConfig(CONFIG_UINT32_NUMTHREADS_MAP_REGIONS, "MapUpdateRegionThreads", 0);
+    setConfig(CONFIG_UINT32_NUMTHREADS_UPDATE_PACKETS, "MapUpdatePacketThreads", 0);
+    setConfig(CONFIG_UINT32_NUMTHREADS_PATHFINDING, "MapUpdatePathThreads", 0);
+    setConfig(CONFIG_UINT32_NUMTHREADS_STARTUP, "StartupLoaderThreads", 0);
+    setConfig(CONFIG_UINT32_NUMTHREADS_TERRAIN_PREFETCH, "TerrainPrefetchThreads", 0);
+    setConfig(CONFIG_UINT32_NUMTHREADS_SESSIONS, "SessionUpdateThreads", 0);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
@@ -744,6 +758,29 @@ void World::LoadConfigSettings(bool reload)
         m_timers[WUPDATE_UPTIME].Reset();
     }
 
+    setConfig(CONFIG_BOOL_OPCODE_PROFILING, "OpcodeProfiling.Enable", false);
+    setConfig(CONFIG_UINT32_OPCODE_PROFILING_DUMP_INTERVAL, "OpcodeProfiling.DumpInterval", 5);
+    if (reload)
+    {
+        m_timers[WUPDATE_OPCODE_STATS].SetInterval(getConfig(CONFIG_UINT32_OPCODE_PROFILING_DUMP_INTERVAL) * MINUTE * IN_MILLISECONDS);
+        m_timers[WUPDATE_OPCODE_STATS].Reset();
+    }
+
+    sOpcodeProfiler.SetEnabled(getConfig(CONFIG_BOOL_OPCODE_PROFILING));
+
+    std::string opcodeDumpFile = sConfig.GetStringDefault("OpcodeProfiling.DumpFile", "world-opcodes.log");
+    if (!opcodeDumpFile.empty())
+    {
+        // same directory as the other log files
+        std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
+        if (!logsDir.empty() && logsDir.at(logsDir.length() - 1) != '/' && logsDir.at(logsDir.length() - 1) != '\\')
+        {
+            logsDir.append("/");
+        }
+        opcodeDumpFile = logsDir + opcodeDumpFile;
+    }
+    sOpcodeProfiler.SetDumpFile(opcodeDumpFile);
+
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -1022,7 +1059,11 @@ void World::LoadConfigSettings(bool reload)
         sLog.outString("Using DataDir %s", m_dataPath.c_str());
     }
 
+    // used by the world table loads following this, so a reload only affects later table reloads
+    SQLStorageBase::SetSnapshotDir(sConfig.GetStringDefault("SnapshotDir", ""));
+
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfig(CONFIG_UINT32_VMAP_LOS_CACHE_SIZE, "vmap.losCacheSize", 1024);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds", "");
@@ -1042,6 +1083,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds", "");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
+    setConfig(CONFIG_UINT32_MMAP_PATH_CACHE_SIZE, "mmap.pathCacheSize", 256);
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
 
 #ifdef ENABLE_ELUNA
@@ -1377,30 +1419,50 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player level dependent mail rewards...");
     sObjectMgr.LoadMailLevelRewards();
 
-    sLog.outString("Loading Loot Tables...");
-    LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
-
-    sLog.outString("Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
+    ///- Loot tables, skill tables and achievements only read the templates loaded above
+    uint32 startupThreads = getConfig(CONFIG_UINT32_NUMTHREADS_STARTUP);
+    if (startupThreads > 1)
+    {
+        // locale indexes are shared by all locale loaders, create them before they run concurrently
+        sObjectMgr.InitLocaleIndexes();
+    }
 
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
+    {
+        StartupLoader loader("Loot, skill and achievement tables");
 
-    sLog.outString();
-    sLog.outString("Loading Achievements...");
-    sAchievementMgr.LoadAchievementReferenceList();
-    sAchievementMgr.LoadAchievementCriteriaList();
-    sAchievementMgr.LoadAchievementCriteriaRequirements();
-    sAchievementMgr.LoadRewards();
-    sAchievementMgr.LoadRewardLocales();
-    sAchievementMgr.LoadCompletedAchievements();
-    sLog.outString(">>> Achievements loaded");
-    sLog.outString();
+        uint32 lootLoaders[] =
+        {
+            loader.Add("Creature Loot Tables", &LoadLootTemplates_Creature),
+            loader.Add("Fishing Loot Tables", &LoadLootTemplates_Fishing),
+            loader.Add("Gameobject Loot Tables", &LoadLootTemplates_Gameobject),
+            loader.Add("Item Loot Tables", &LoadLootTemplates_Item),
+            loader.Add("Mail Loot Tables", &LoadLootTemplates_Mail),
+            loader.Add("Milling Loot Tables", &LoadLootTemplates_Milling),
+            loader.Add("Pickpocketing Loot Tables", &LoadLootTemplates_Pickpocketing),
+            loader.Add("Skinning Loot Tables", &LoadLootTemplates_Skinning),
+            loader.Add("Disenchant Loot Tables", &LoadLootTemplates_Disenchant),
+            loader.Add("Prospecting Loot Tables", &LoadLootTemplates_Prospecting),
+            loader.Add("Spell Loot Tables", &LoadLootTemplates_Spell),
+        };
+
+        // checks the references of all other loot tables
+        loader.Add("Reference Loot Tables", &LoadLootTemplates_Reference,
+                   { lootLoaders[0], lootLoaders[1], lootLoaders[2], lootLoaders[3], lootLoaders[4], lootLoaders[5],
+                     lootLoaders[6], lootLoaders[7], lootLoaders[8], lootLoaders[9], lootLoaders[10] });
+
+        loader.Add("Skill Discovery Table", &LoadSkillDiscoveryTable);
+        loader.Add("Skill Extra Item Table", &LoadSkillExtraItemTable);
+        loader.Add("Skill Fishing base level requirements", []() { sObjectMgr.LoadFishingBaseSkillLevel(); });
+
+        uint32 achievementReferences = loader.Add("Achievement References", []() { sAchievementMgr.LoadAchievementReferenceList(); });
+        uint32 achievementCriteria = loader.Add("Achievement Criteria", []() { sAchievementMgr.LoadAchievementCriteriaList(); }, { achievementReferences });
+        uint32 achievementRequirements = loader.Add("Achievement Criteria Requirements", []() { sAchievementMgr.LoadAchievementCriteriaRequirements(); }, { achievementCriteria });
+        uint32 achievementRewards = loader.Add("Achievement Rewards", []() { sAchievementMgr.LoadRewards(); }, { achievementRequirements });
+        uint32 achievementRewardLocales = loader.Add("Achievement Reward Locales", []() { sAchievementMgr.LoadRewardLocales(); }, { achievementRewards });
+        loader.Add("Completed Achievements", []() { sAchievementMgr.LoadCompletedAchievements(); }, { achievementRewardLocales });
+
+        loader.Run(startupThreads);
+    }
 
     sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
     sObjectMgr.LoadInstanceEncounters();
@@ -1424,19 +1486,22 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Waypoints...");
     sWaypointMgr.Load();
 
-    ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    //sCommandMgr.LoadCommandHelpLocale();                  TODO: Need to figure out why this crashes
-    sLog.outString(">>> Localization strings loaded");
-    sLog.outString();
+    ///- Loading localization data, must be after the templates they translate, each loader fills its own locale map
+    {
+        StartupLoader loader("Localization strings");
+
+        loader.Add("Creature Locales", []() { sObjectMgr.LoadCreatureLocales(); });
+        loader.Add("GameObject Locales", []() { sObjectMgr.LoadGameObjectLocales(); });
+        loader.Add("Item Locales", []() { sObjectMgr.LoadItemLocales(); });
+        loader.Add("Quest Locales", []() { sObjectMgr.LoadQuestLocales(); });
+        loader.Add("NPC Text Locales", []() { sObjectMgr.LoadGossipTextLocales(); });
+        loader.Add("Page Text Locales", []() { sObjectMgr.LoadPageTextLocales(); });
+        loader.Add("Gossip Menu Option Locales", []() { sObjectMgr.LoadGossipMenuItemsLocales(); });
+        loader.Add("Points Of Interest Locales", []() { sObjectMgr.LoadPointOfInterestLocales(); });
+        //sCommandMgr.LoadCommandHelpLocale();                  TODO: Need to figure out why this crashes
+
+        loader.Run(startupThreads);
+    }
 
     ///- Load dynamic data tables from the database
     sLog.outString("Loading Auctions...");
@@ -1573,6 +1638,9 @@ void World::SetInitialWorldSettings()
     // for Dungeon Finder
     m_timers[WUPDATE_LFGMGR].SetInterval(30 * IN_MILLISECONDS); // every 30 sec
 
+    // for the opcode profile dump, 0 disables it
+    m_timers[WUPDATE_OPCODE_STATS].SetInterval(getConfig(CONFIG_UINT32_OPCODE_PROFILING_DUMP_INTERVAL) * MINUTE * IN_MILLISECONDS);
+
     // for AutoBroadcast
     sLog.outString("Starting AutoBroadcast System");
     if (m_broadcastEnable)
@@ -1607,6 +1675,8 @@ void World::SetInitialWorldSettings()
     sMapMgr.Initialize();
     sLog.outString();
 
+    InitSessionUpdater();
+
     ///- Initialize Battlegrounds
     sLog.outString("Starting BattleGround System");
     sBattleGroundMgr.CreateInitialBattleGrounds();
@@ -1872,6 +1942,7 @@ void World::Update(uint32 diff)
     _UpdateGameTime();
     GameTime::UpdateGameTimers();
     sWorldUpdateTime.UpdateWithDiff(diff);
+    UpdateData::UpdateCompression(sWorldUpdateTime.GetAverageUpdateTime());
 
     ///-Update mass mailer tasks if any
     sMassMailMgr.Update();
@@ -1919,6 +1990,16 @@ void World::Update(uint32 diff)
         LoginDatabase.PExecute("UPDATE `uptime` SET `uptime` = %u, `maxplayers` = %u WHERE `realmid` = %u AND `starttime` = " UI64FMTD, tmpDiff, maxClientsNum, realmID, uint64(m_startTime));
     }
 
+    /// <li> Write the opcode profile
+    if (getConfig(CONFIG_UINT32_OPCODE_PROFILING_DUMP_INTERVAL) && m_timers[WUPDATE_OPCODE_STATS].Passed())
+    {
+        m_timers[WUPDATE_OPCODE_STATS].Reset();
+        if (sOpcodeProfiler.IsEnabled())
+        {
+            sOpcodeProfiler.DumpToFile();
+        }
+    }
+
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
     sMapMgr.Update(diff);
@@ -2377,6 +2458,36 @@ void World::ShutdownCancel()
 #endif /* ENABLE_ELUNA */
 }
 
+void World::InitSessionUpdater()
+{
+    int num_threads(getConfig(CONFIG_UINT32_NUMTHREADS_SESSIONS));
+
+#ifdef ENABLE_ELUNA
+    if (sElunaConfig->IsElunaEnabled() && num_threads > 0)
+    {
+        // OnPacketReceive hooks would be called from the session threads
+        sLog.outError("Session update threads set to %i, when Eluna is enabled they are not allowed, changing to 0", num_threads);
+        num_threads = 0;
+    }
+#endif /* ENABLE_ELUNA */
+
+    if (num_threads <= 0)
+    {
+        return;
+    }
+
+    m_sessionUpdater = new WorldSessionUpdater;
+    if (m_sessionUpdater->activate(num_threads) == -1)
+    {
+        sLog.outError("World: failed to start %i session update threads, all packets will be processed in the world thread", num_threads);
+        delete m_sessionUpdater;
+        m_sessionUpdater = NULL;
+        return;
+    }
+
+    sLog.outString("World: %i session update threads started", num_threads);
+}
+
 void World::UpdateSessions(uint32 /*diff*/)
 {
     ///- Add new sessions
@@ -2388,6 +2499,23 @@ void World::UpdateSessions(uint32 /*diff*/)
         m_sessionAddQueue.clear();
     }
 
+    ///- Process the packets which only change their own session concurrently
+    if (m_sessionUpdater)
+    {
+        std::vector<WorldSession*> sessions;
+        sessions.reserve(m_sessions.size());
+
+        for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+        {
+            if (itr->second->CanUpdateConcurrently())
+            {
+                sessions.push_back(itr->second);
+            }
+        }
+
+        m_sessionUpdater->UpdateSessions(sessions);
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(), next; itr != m_sessions.end(); itr = next)
     {
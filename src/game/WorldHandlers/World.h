@@ -46,6 +46,7 @@ class Object;
 class ObjectGuid;
 class WorldPacket;
 class WorldSession;
+class WorldSessionUpdater;
 class Player;
 class Weather;
 class SqlResultQueue;
@@ -82,15 +83,16 @@ enum ShutdownExitCode
 /// Timers for different object refresh rates
 enum WorldTimers
 {
-    WUPDATE_AUCTIONS    = 0,
-    WUPDATE_UPTIME      = 1,
-    WUPDATE_CORPSES     = 2,
-    WUPDATE_EVENTS      = 3,
-    WUPDATE_DELETECHARS = 4,
-    WUPDATE_AHBOT       = 5,
-    WUPDATE_LFGMGR      = 6,
-    WUPDATE_WEATHERS    = 7,
-    WUPDATE_COUNT       = 8
+    WUPDATE_AUCTIONS     = 0,
+    WUPDATE_UPTIME       = 1,
+    WUPDATE_CORPSES      = 2,
+    WUPDATE_EVENTS       = 3,
+    WUPDATE_DELETECHARS  = 4,
+    WUPDATE_AHBOT        = 5,
+    WUPDATE_LFGMGR       = 6,
+    WUPDATE_WEATHERS     = 7,
+    WUPDATE_OPCODE_STATS = 8,
+    WUPDATE_COUNT        = 9
 };
 
 /// Configuration elements
@@ -110,6 +112,7 @@ enum eConfigUInt64Values
 enum eConfigUInt32Values
 {
     CONFIG_UINT32_COMPRESSION = 0,
+    CONFIG_UINT32_COMPRESSION_THRESHOLD,
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
@@ -219,6 +222,14 @@ enum eConfigUInt32Values
     CONFIG_UINT32_CHARDELETE_METHOD,
     CONFIG_UINT32_CHARDELETE_MIN_LEVEL,
     CONFIG_UINT32_NUMTHREADS,
+    CONFIG_UINT32_NUMTHREADS_MAP_REGIONS,
+    CONFIG_UINT32_NUMTHREADS_UPDATE_PACKETS,
+    CONFIG_UINT32_NUMTHREADS_PATHFINDING,
+    CONFIG_UINT32_NUMTHREADS_STARTUP,
+    CONFIG_UINT32_NUMTHREADS_TERRAIN_PREFETCH,
+    CONFIG_UINT32_NUMTHREADS_SESSIONS,
+    CONFIG_UINT32_MMAP_PATH_CACHE_SIZE,
+    CONFIG_UINT32_VMAP_LOS_CACHE_SIZE,
     CONFIG_UINT32_GUID_RESERVE_SIZE_CREATURE,
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_MIN_LEVEL_FOR_RAID,
@@ -226,6 +237,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_RANDOM_BG_RESET_HOUR,
     CONFIG_UINT32_MAX_WHOLIST_RETURNS,
     CONFIG_UINT32_LOG_WHISPERS,
+    CONFIG_UINT32_OPCODE_PROFILING_DUMP_INTERVAL,
 
     // Warden
     CONFIG_UINT32_WARDEN_CLIENT_RESPONSE_DELAY,
@@ -390,6 +402,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_OUTDOORPVP_NA_ENABLED,
     CONFIG_BOOL_OUTDOORPVP_GH_ENABLED,
     CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,
+    CONFIG_BOOL_OPCODE_PROFILING,
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
@@ -805,6 +818,10 @@ class World
         std::mutex m_sessionAddQueueLock;
         std::deque<WorldSession *> m_sessionAddQueue;
 
+        // threads processing the session-safe packets
+        void InitSessionUpdater();
+        WorldSessionUpdater* m_sessionUpdater;
+
         // used versions
         std::string m_DBVersion;
         std::string m_CreatureEventAIVersion;
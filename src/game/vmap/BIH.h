@@ -38,6 +38,7 @@
 #include <cmath>
 
 #define MAX_STACK_SIZE 64
+#define MAX_PACKET_SIZE 8
 
 #ifdef _MSC_VER
 #define isnan(x) _isnan(x)
@@ -362,6 +363,204 @@ public:
         }
     }
 
+    /**
+     * @brief Intersects a packet of rays with the BIH in one traversal.
+     *
+     * Every node is visited once for all rays still crossing it, which pays off
+     * for coherent rays, e.g. one caster testing the line of sight to a pack.
+     * Rays are not visited front to back, so only stopAtFirst queries (any hit)
+     * are cheaper than single ray traversals.
+     *
+     * @tparam RayCallback Callback type for intersection, called with the ray index first.
+     * @param rays The rays to intersect.
+     * @param count Number of rays, at most MAX_PACKET_SIZE.
+     * @param intersectCallback The callback to handle intersections.
+     * @param maxDist Maximum distance for intersection of each ray.
+     * @param stopAtFirst Whether a ray stops at its first intersection.
+     */
+    template<typename RayCallback>
+    void IntersectRays(const Ray* rays, uint32 count, RayCallback& intersectCallback, float* maxDist, bool stopAtFirst = false) const
+    {
+        PacketStackNode stack[MAX_STACK_SIZE];
+        uint32 sign[MAX_PACKET_SIZE][3];
+        float intervalMin[MAX_PACKET_SIZE];
+        float intervalMax[MAX_PACKET_SIZE];
+        uint32 mask = 0;
+        uint32 finished = 0;
+
+        for (uint32 r = 0; r < count; ++r)
+        {
+            Vector3 const& org = rays[r].origin();
+            Vector3 const& invDir = rays[r].invDirection();
+            float tMin = 0.f;
+            float tMax = maxDist[r];
+
+            for (int i = 0; i < 3; ++i)
+            {
+                sign[r][i] = floatToRawIntBits(rays[r].direction()[i]) >> 31;
+
+                if (G3D::fuzzyNe(rays[r].direction()[i], 0.0f))
+                {
+                    float t1 = (bounds.low()[i] - org[i]) * invDir[i];
+                    float t2 = (bounds.high()[i] - org[i]) * invDir[i];
+                    if (t1 > t2)
+                    {
+                        std::swap(t1, t2);
+                    }
+                    tMin = std::max(tMin, t1);
+                    tMax = std::min(tMax, t2);
+                }
+            }
+
+            intervalMin[r] = tMin;
+            intervalMax[r] = tMax;
+            if (tMin <= tMax)
+            {
+                mask |= 1 << r;
+            }
+        }
+
+        int stackPos = 0;
+        int node = 0;
+
+        while (true)
+        {
+            while (mask)
+            {
+                uint32 tn = tree[node];
+                uint32 axis = (tn & (3 << 30)) >> 30;
+                bool BVH2 = tn & (1 << 29);
+                int offset = tn & ~(7 << 29);
+
+                if (!BVH2 && axis == 3)
+                {
+                    // leaf - test the objects for every ray crossing it
+                    for (uint32 r = 0; r < count; ++r)
+                    {
+                        if (!(mask & (1 << r)))
+                        {
+                            continue;
+                        }
+
+                        for (int n = tree[node + 1], o = offset; n > 0; --n, ++o)
+                        {
+                            if (intersectCallback(r, rays[r], objects[o], maxDist[r], stopAtFirst) && stopAtFirst)
+                            {
+                                finished |= 1 << r;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (finished == (1u << count) - 1)
+                    {
+                        return;
+                    }
+                    break;
+                }
+
+                if (axis > 2)
+                {
+                    return;  // should not happen
+                }
+
+                float lo = intBitsToFloat(tree[node + 1]);
+                float hi = intBitsToFloat(tree[node + 2]);
+
+                if (BVH2)
+                {
+                    // single child bounded on both sides
+                    for (uint32 r = 0; r < count; ++r)
+                    {
+                        if (mask & (1 << r))
+                        {
+                            float o = rays[r].origin()[axis];
+                            float d = rays[r].invDirection()[axis];
+                            clipInterval(false, sign[r][axis], (lo - o) * d, intervalMin[r], intervalMax[r]);
+                            clipInterval(true, sign[r][axis], (hi - o) * d, intervalMin[r], intervalMax[r]);
+                            if (intervalMin[r] > intervalMax[r])
+                            {
+                                mask &= ~(1 << r);
+                            }
+                        }
+                    }
+                    node = offset;
+                    continue;
+                }
+
+                // "normal" interior node, left child ends at lo and right child starts at hi
+                PacketStackNode& right = stack[stackPos];
+                right.node = offset + 3;
+                right.mask = 0;
+
+                for (uint32 r = 0; r < count; ++r)
+                {
+                    if (!(mask & (1 << r)))
+                    {
+                        continue;
+                    }
+
+                    float o = rays[r].origin()[axis];
+                    float d = rays[r].invDirection()[axis];
+
+                    right.tnear[r] = intervalMin[r];
+                    right.tfar[r] = intervalMax[r];
+                    clipInterval(false, sign[r][axis], (hi - o) * d, right.tnear[r], right.tfar[r]);
+                    if (right.tnear[r] <= right.tfar[r])
+                    {
+                        right.mask |= 1 << r;
+                    }
+
+                    clipInterval(true, sign[r][axis], (lo - o) * d, intervalMin[r], intervalMax[r]);
+                    if (intervalMin[r] > intervalMax[r])
+                    {
+                        mask &= ~(1 << r);
+                    }
+                }
+
+                if (!mask)
+                {
+                    // only the right child is crossed
+                    mask = right.mask;
+                    node = right.node;
+                    std::copy(right.tnear, right.tnear + count, intervalMin);
+                    std::copy(right.tfar, right.tfar + count, intervalMax);
+                    continue;
+                }
+
+                if (right.mask)
+                {
+                    ++stackPos;
+                }
+                node = offset;
+            } // traversal loop
+
+            do
+            {
+                // stack is empty?
+                if (stackPos == 0)
+                {
+                    return;
+                }
+                // move back up the stack, dropping rays already done or shortened
+                --stackPos;
+                mask = stack[stackPos].mask & ~finished;
+                for (uint32 r = 0; r < count; ++r)
+                {
+                    if ((mask & (1 << r)) && maxDist[r] < stack[stackPos].tnear[r])
+                    {
+                        mask &= ~(1 << r);
+                    }
+                }
+            }
+            while (!mask);
+
+            node = stack[stackPos].node;
+            std::copy(stack[stackPos].tnear, stack[stackPos].tnear + count, intervalMin);
+            std::copy(stack[stackPos].tfar, stack[stackPos].tfar + count, intervalMax);
+        }
+    }
+
     /**
      * @brief Intersects a point with the BIH.
      *
@@ -508,6 +707,39 @@ protected:
         float tfar; /**< Far distance. */
     };
 
+    /**
+     * @brief Structure for stack nodes during packet traversal.
+     */
+    struct PacketStackNode
+    {
+        uint32 node; /**< Node index. */
+        uint32 mask; /**< Rays crossing the node. */
+        float tnear[MAX_PACKET_SIZE]; /**< Near distance of each ray. */
+        float tfar[MAX_PACKET_SIZE]; /**< Far distance of each ray. */
+    };
+
+    /**
+     * @brief Clips a ray interval to the half space on one side of an axis aligned plane.
+     *
+     * @param below Whether the half space lies below the plane.
+     * @param negative Sign bit of the ray direction along the plane's axis.
+     * @param t Ray distance to the plane.
+     * @param tMin Near distance, updated.
+     * @param tMax Far distance, updated.
+     */
+    static void clipInterval(bool below, uint32 negative, float t, float& tMin, float& tMax)
+    {
+        // NaN (ray origin in the plane with zero direction) keeps the interval as it is
+        if (below != (negative != 0))
+        {
+            tMax = (t < tMax) ? t : tMax;
+        }
+        else
+        {
+            tMin = (t > tMin) ? t : tMin;
+        }
+    }
+
     /**
      * @brief Class for build statistics.
      */
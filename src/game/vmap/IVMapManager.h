@@ -85,6 +85,16 @@ namespace VMAP
              */
             virtual VMAPLoadResult loadMap(const char* pBasePath, unsigned int pMapId, int x, int y) = 0;
 
+            /**
+             * @brief read the models of a tile ahead of loadMap, so loadMap does not wait for the disk
+             *
+             * @param pBasePath
+             * @param pMapId
+             * @param x
+             * @param y
+             */
+            virtual void prefetchMap(const char* pBasePath, unsigned int pMapId, int x, int y) = 0;
+
             /**
              * @brief
              *
@@ -124,6 +134,20 @@ namespace VMAP
              * @return bool
              */
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+             * @brief batch version of isInLineOfSight, from one point to count points
+             *
+             * @param pMapId
+             * @param x1
+             * @param y1
+             * @param z1
+             * @param count
+             * @param x2
+             * @param y2
+             * @param z2
+             * @param results
+             */
+            virtual void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, uint32 count, const float* x2, const float* y2, const float* z2, bool* results) = 0;
             /**
              * @brief
              *
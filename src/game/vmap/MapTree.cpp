@@ -77,6 +77,47 @@ namespace VMAP
         bool hit; /**< Flag indicating if an intersection occurred. */
     };
 
+    /**
+     * @brief Callback class for ray packet intersection with models.
+     */
+    class MapRayPacketCallback
+    {
+    public:
+        MapRayPacketCallback(ModelInstance* val) : prims(val), hitMask(0) {}
+
+        /**
+         * @brief Operator to handle intersection of one ray of the packet.
+         *
+         * @param rayIndex The index of the ray in the packet.
+         * @param ray The ray to intersect.
+         * @param entry The entry index.
+         * @param distance The distance to intersection.
+         * @param pStopAtFirstHit Whether to stop at the first hit.
+         * @return true if intersection occurs, false otherwise.
+         */
+        bool operator()(uint32 rayIndex, const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit = true)
+        {
+            bool result = prims[entry].IntersectRay(ray, distance, pStopAtFirstHit);
+            if (result)
+            {
+                hitMask |= 1 << rayIndex;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Checks if a ray of the packet hit something.
+         *
+         * @param rayIndex The index of the ray in the packet.
+         * @return true if an intersection occurred, false otherwise.
+         */
+        bool didHit(uint32 rayIndex) const { return hitMask & (1 << rayIndex); }
+
+    protected:
+        ModelInstance* prims; /**< Pointer to model instances. */
+        uint32 hitMask; /**< Rays that hit something. */
+    };
+
     /**
      * @brief Callback class for area information.
      */
@@ -256,6 +297,57 @@ namespace VMAP
         return true;
     }
 
+    /**
+     * @brief Checks the line of sight from one position to many, rays are traversed in packets.
+     *
+     * @param pos1 The starting position.
+     * @param count The number of end positions.
+     * @param pos2 The end positions.
+     * @param pResults Receives the line of sight to each end position.
+     */
+    void StaticMapTree::isInLineOfSight(const Vector3& pos1, uint32 count, const Vector3* pos2, bool* pResults) const
+    {
+        G3D::Ray rays[MAX_PACKET_SIZE];
+        float maxDist[MAX_PACKET_SIZE];
+        uint32 index[MAX_PACKET_SIZE];
+        uint32 packed = 0;
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float dist = (pos2[i] - pos1).magnitude();
+            // same limits as the single ray check
+            if (dist == std::numeric_limits<float>::max() ||
+                dist == std::numeric_limits<float>::infinity())
+            {
+                pResults[i] = false;
+                continue;
+            }
+
+            pResults[i] = true;
+            if (dist >= 1e-10f)
+            {
+                rays[packed] = G3D::Ray::fromOriginAndDirection(pos1, (pos2[i] - pos1) / dist);
+                maxDist[packed] = dist;
+                index[packed] = i;
+                ++packed;
+            }
+
+            if (packed == MAX_PACKET_SIZE || (packed && i + 1 == count))
+            {
+                MapRayPacketCallback intersectionCallBack(iTreeValues);
+                iTree.IntersectRays(rays, packed, intersectionCallBack, maxDist, true);
+                for (uint32 r = 0; r < packed; ++r)
+                {
+                    if (intersectionCallBack.didHit(r))
+                    {
+                        pResults[index[r]] = false;
+                    }
+                }
+                packed = 0;
+            }
+        }
+    }
+
     /**
      * @brief Checks if an object is hit when moving from pos1 to pos2.
      *
@@ -381,6 +473,55 @@ namespace VMAP
         return success;
     }
 
+    /**
+     * @brief Reads the names of the models spawned on a tile, without loading anything.
+     *
+     * @param vmapPath The path to the VMAP files.
+     * @param mapID The map ID.
+     * @param tileX The tile X coordinate.
+     * @param tileY The tile Y coordinate.
+     * @param basePath Receives the path the model files are in.
+     * @param modelNames Receives the model names.
+     * @return true if the tile file was read, false otherwise (or for maps without tiles).
+     */
+    bool StaticMapTree::getTileModelNames(const std::string& vmapPath, uint32 mapID, uint32 tileX, uint32 tileY, std::string& basePath, std::vector<std::string>& modelNames)
+    {
+        basePath = vmapPath;
+        if (basePath.length() > 0 && (basePath[basePath.length() - 1] != '/' || basePath[basePath.length() - 1] != '\\'))
+        {
+            basePath.append("/");
+        }
+
+        std::string tilefile = basePath + getTileFileName(mapID, tileX, tileY);
+        FILE* tf = fopen(tilefile.c_str(), "rb");
+        if (!tf)
+        {
+            return false;
+        }
+
+        bool result = true;
+        char chunk[8];
+        uint32 numSpawns = 0;
+        if (!readChunk(tf, chunk, VMAP_MAGIC, 8) || fread(&numSpawns, sizeof(uint32), 1, tf) != 1)
+        {
+            result = false;
+        }
+
+        for (uint32 i = 0; i < numSpawns && result; ++i)
+        {
+            ModelSpawn spawn;
+            uint32 referencedVal;
+            result = ModelSpawn::ReadFromFile(tf, spawn) && fread(&referencedVal, sizeof(uint32), 1, tf) == 1;
+            if (result)
+            {
+                modelNames.push_back(spawn.name);
+            }
+        }
+
+        fclose(tf);
+        return result;
+    }
+
     /**
      * @brief Initializes the map.
      *
@@ -127,6 +127,18 @@ namespace VMAP
          * @return bool True if the map can be loaded, false otherwise.
          */
         static bool CanLoadMap(const std::string& basePath, uint32 mapID, uint32 tileX, uint32 tileY);
+        /**
+         * @brief Reads the names of the models spawned on a tile, without loading anything.
+         *
+         * @param vmapPath The path to the VMAP files.
+         * @param mapID The map ID.
+         * @param tileX The tile X coordinate.
+         * @param tileY The tile Y coordinate.
+         * @param basePath Receives the path the model files are in.
+         * @param modelNames Receives the model names.
+         * @return bool True if the tile file was read, false otherwise (or for maps without tiles).
+         */
+        static bool getTileModelNames(const std::string& vmapPath, uint32 mapID, uint32 tileX, uint32 tileY, std::string& basePath, std::vector<std::string>& modelNames);
 
         /**
          * @brief Constructor for StaticMapTree.
@@ -148,6 +160,15 @@ namespace VMAP
          * @return bool True if there is a line of sight, false otherwise.
          */
         bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2) const;
+        /**
+         * @brief Checks the line of sight from one position to many in one tree traversal per packet of rays.
+         *
+         * @param pos1 The starting position.
+         * @param count The number of end positions.
+         * @param pos2 The end positions.
+         * @param pResults Receives the line of sight to each end position.
+         */
+        void isInLineOfSight(const G3D::Vector3& pos1, uint32 count, const G3D::Vector3* pos2, bool* pResults) const;
         /**
          * @brief Checks if an object is hit when moving from pos1 to pos2.
          *
@@ -31,6 +31,9 @@
 #include "ModelInstance.h"
 #include "WorldModel.h"
 #include "VMapDefinitions.h"
+#include "Timer.h"
+
+#include <ace/Guard_T.h>
 
 using G3D::Vector3;
 
@@ -57,6 +60,10 @@ namespace VMAP
         {
             delete i->second.getModel();
         }
+        for (PrefetchedModelMap::iterator i = iPrefetchedModels.begin(); i != iPrefetchedModels.end(); ++i)
+        {
+            delete i->second.model;
+        }
     }
 
     /**
@@ -118,6 +125,95 @@ namespace VMAP
         return result;
     }
 
+    /**
+     * @brief Reads the model files of a map tile ahead of loadMap.
+     *
+     * The models are kept aside until a tile acquires them, models no tile asked
+     * for within a minute are dropped.
+     *
+     * @param pBasePath The base path to the map files.
+     * @param pMapId The map ID.
+     * @param x The x-coordinate of the tile.
+     * @param y The y-coordinate of the tile.
+     */
+    void VMapManager2::prefetchMap(const char* pBasePath, unsigned int pMapId, int x, int y)
+    {
+        if (!isMapLoadingEnabled())
+        {
+            return;
+        }
+
+        std::string basePath;
+        std::vector<std::string> modelNames;
+        if (!StaticMapTree::getTileModelNames(pBasePath, pMapId, x, y, basePath, modelNames))
+        {
+            return;
+        }
+
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, iModelLock);
+
+            for (PrefetchedModelMap::iterator i = iPrefetchedModels.begin(); i != iPrefetchedModels.end();)
+            {
+                if (GetMSTimeDiffToNow(i->second.readTime) > 60 * IN_MILLISECONDS)
+                {
+                    delete i->second.model;
+                    i = iPrefetchedModels.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        for (std::vector<std::string>::const_iterator name = modelNames.begin(); name != modelNames.end(); ++name)
+        {
+            {
+                ACE_GUARD(ACE_Thread_Mutex, guard, iModelLock);
+
+                if (iLoadedModelFiles.count(*name) || iPrefetchedModels.count(*name))
+                {
+                    continue;
+                }
+            }
+
+            // the expensive part, done without holding the lock
+            WorldModel* worldmodel = new WorldModel();
+            if (!worldmodel->readFile(basePath + *name + ".vmo"))
+            {
+                delete worldmodel;
+                continue;
+            }
+
+            ACE_GUARD(ACE_Thread_Mutex, guard, iModelLock);
+
+            if (iLoadedModelFiles.count(*name) || iPrefetchedModels.count(*name))
+            {
+                delete worldmodel;
+                continue;
+            }
+
+            PrefetchedModel& prefetched = iPrefetchedModels[*name];
+            prefetched.model = worldmodel;
+            prefetched.readTime = getMSTime();
+        }
+    }
+
+    /**
+     * @brief Finds the tree of a map.
+     *
+     * @param pMapId The map ID.
+     * @return StaticMapTree* The tree, or NULL if the map is not loaded.
+     */
+    StaticMapTree* VMapManager2::findTree(unsigned int pMapId) const
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iTreeLock, NULL);
+
+        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        return instanceTree != iInstanceMapTrees.end() ? instanceTree->second : NULL;
+    }
+
     /**
      * @brief Internal method to load a map tile.
      *
@@ -129,18 +225,20 @@ namespace VMAP
      */
     bool VMapManager2::_loadMap(unsigned int pMapId, const std::string& basePath, uint32 tileX, uint32 tileY)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree == iInstanceMapTrees.end())
+        StaticMapTree* instanceTree = findTree(pMapId);
+        if (!instanceTree)
         {
             std::string mapFileName = getMapFileName(pMapId);
-            StaticMapTree* newTree = new StaticMapTree(pMapId, basePath);
-            if (!newTree->InitMap(mapFileName, this))
+            instanceTree = new StaticMapTree(pMapId, basePath);
+            if (!instanceTree->InitMap(mapFileName, this))
             {
                 return false;
             }
-            instanceTree = iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, newTree)).first;
+
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iTreeLock, false);
+            iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, instanceTree));
         }
-        return instanceTree->second->LoadMapTile(tileX, tileY, this);
+        return instanceTree->LoadMapTile(tileX, tileY, this);
     }
 
     /**
@@ -150,14 +248,17 @@ namespace VMAP
      */
     void VMapManager2::unloadMap(unsigned int pMapId)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        StaticMapTree* instanceTree = findTree(pMapId);
+        if (instanceTree)
         {
-            instanceTree->second->UnloadMap(this);
-            if (instanceTree->second->numLoadedTiles() == 0)
+            instanceTree->UnloadMap(this);
+            if (instanceTree->numLoadedTiles() == 0)
             {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
+                {
+                    ACE_GUARD(ACE_Thread_Mutex, guard, iTreeLock);
+                    iInstanceMapTrees.erase(pMapId);
+                }
+                delete instanceTree;
             }
         }
     }
@@ -171,14 +272,17 @@ namespace VMAP
      */
     void VMapManager2::unloadMap(unsigned int pMapId, int x, int y)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        StaticMapTree* instanceTree = findTree(pMapId);
+        if (instanceTree)
         {
-            instanceTree->second->UnloadMapTile(x, y, this);
-            if (instanceTree->second->numLoadedTiles() == 0)
+            instanceTree->UnloadMapTile(x, y, this);
+            if (instanceTree->numLoadedTiles() == 0)
             {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
+                {
+                    ACE_GUARD(ACE_Thread_Mutex, guard, iTreeLock);
+                    iInstanceMapTrees.erase(pMapId);
+                }
+                delete instanceTree;
             }
         }
     }
@@ -203,19 +307,57 @@ namespace VMAP
         }
 
         bool result = true;
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        if (StaticMapTree* instanceTree = findTree(pMapId))
         {
             Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
             Vector3 pos2 = convertPositionToInternalRep(x2, y2, z2);
             if (pos1 != pos2)
             {
-                result = instanceTree->second->isInLineOfSight(pos1, pos2);
+                result = instanceTree->isInLineOfSight(pos1, pos2);
             }
         }
         return result;
     }
 
+    /**
+     * @brief Checks the line of sight from one point to many points.
+     *
+     * @param pMapId The map ID.
+     * @param x1 The x-coordinate of the first point.
+     * @param y1 The y-coordinate of the first point.
+     * @param z1 The z-coordinate of the first point.
+     * @param count The number of second points.
+     * @param x2 The x-coordinates of the second points.
+     * @param y2 The y-coordinates of the second points.
+     * @param z2 The z-coordinates of the second points.
+     * @param results Receives the line of sight to each second point.
+     */
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, uint32 count, const float* x2, const float* y2, const float* z2, bool* results)
+    {
+        std::fill(results, results + count, true);
+
+        if (!count || !isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(pMapId, VMAP_DISABLE_LOS))
+        {
+            return;
+        }
+
+        StaticMapTree* instanceTree = findTree(pMapId);
+        if (!instanceTree)
+        {
+            return;
+        }
+
+        // equal positions give a zero length ray, which the tree reports as in sight
+        Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
+        std::vector<Vector3> pos2(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            pos2[i] = convertPositionToInternalRep(x2[i], y2[i], z2[i]);
+        }
+
+        instanceTree->isInLineOfSight(pos1, count, &pos2[0], results);
+    }
+
     /**
      * @brief Gets the hit position of an object in the line of sight.
      *
@@ -240,13 +382,12 @@ namespace VMAP
         rz = z2;
         if (isLineOfSightCalcEnabled() && !IsVMAPDisabledForPtr(pMapId, VMAP_DISABLE_LOS))
         {
-            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            if (StaticMapTree* instanceTree = findTree(pMapId))
             {
                 Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
                 Vector3 pos2 = convertPositionToInternalRep(x2, y2, z2);
                 Vector3 resultPos;
-                result = instanceTree->second->getObjectHitPos(pos1, pos2, resultPos, pModifyDist);
+                result = instanceTree->getObjectHitPos(pos1, pos2, resultPos, pModifyDist);
                 resultPos = convertPositionToInternalRep(resultPos.x, resultPos.y, resultPos.z);
                 rx = resultPos.x;
                 ry = resultPos.y;
@@ -271,11 +412,10 @@ namespace VMAP
         float height = VMAP_INVALID_HEIGHT_VALUE;           // no height
         if (isHeightCalcEnabled() && !IsVMAPDisabledForPtr(pMapId, VMAP_DISABLE_HEIGHT))
         {
-            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            if (StaticMapTree* instanceTree = findTree(pMapId))
             {
                 Vector3 pos = convertPositionToInternalRep(x, y, z);
-                height = instanceTree->second->getHeight(pos, maxSearchDist);
+                height = instanceTree->getHeight(pos, maxSearchDist);
                 if (!(height < G3D::inf()))
                 {
                     height = VMAP_INVALID_HEIGHT_VALUE;     // no height
@@ -303,11 +443,10 @@ namespace VMAP
         bool result = false;
         if (!IsVMAPDisabledForPtr(pMapId, VMAP_DISABLE_AREAFLAG))
         {
-            InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            if (StaticMapTree* instanceTree = findTree(pMapId))
             {
                 Vector3 pos = convertPositionToInternalRep(x, y, z);
-                result = instanceTree->second->getAreaInfo(pos, flags, adtId, rootId, groupId);
+                result = instanceTree->getAreaInfo(pos, flags, adtId, rootId, groupId);
                 // z is not touched by convertPositionToMangosRep(), so just copy
                 z = pos.z;
             }
@@ -332,12 +471,11 @@ namespace VMAP
     {
         if (!IsVMAPDisabledForPtr(pMapId, VMAP_DISABLE_LIQUIDSTATUS))
         {
-            InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            if (StaticMapTree* instanceTree = findTree(pMapId))
             {
                 LocationInfo info;
                 Vector3 pos = convertPositionToInternalRep(x, y, z);
-                if (instanceTree->second->GetLocationInfo(pos, info))
+                if (instanceTree->GetLocationInfo(pos, info))
                 {
                     floor = info.ground_Z;
                     type = info.hitModel->GetLiquidType();
@@ -357,15 +495,29 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename)
     {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, iModelLock, NULL);
+
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
-            WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
+            WorldModel* worldmodel;
+
+            // read ahead by prefetchMap?
+            PrefetchedModelMap::iterator prefetched = iPrefetchedModels.find(filename);
+            if (prefetched != iPrefetchedModels.end())
             {
-                ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return NULL;
+                worldmodel = prefetched->second.model;
+                iPrefetchedModels.erase(prefetched);
+            }
+            else
+            {
+                worldmodel = new WorldModel();
+                if (!worldmodel->readFile(basepath + filename + ".vmo"))
+                {
+                    ERROR_LOG("VMapManager2: could not load '%s%s.vmo'!", basepath.c_str(), filename.c_str());
+                    delete worldmodel;
+                    return NULL;
+                }
             }
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
             model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
@@ -382,6 +534,8 @@ namespace VMAP
      */
     void VMapManager2::releaseModelInstance(const std::string& filename)
     {
+        ACE_GUARD(ACE_Thread_Mutex, guard, iModelLock);
+
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
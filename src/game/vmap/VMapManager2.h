@@ -29,6 +29,8 @@
 #include "Platform/Define.h"
 #include <G3D/Vector3.h>
 
+#include <ace/Thread_Mutex.h>
+
 #include <unordered_map>
 
 //===========================================================
@@ -96,6 +98,20 @@ namespace VMAP
      */
     typedef std::unordered_map<std::string, ManagedModel> ModelFileMap;
 
+    /**
+     * @brief Model file read ahead of the tile using it, with the time it was read.
+     */
+    struct PrefetchedModel
+    {
+        WorldModel* model;
+        uint32 readTime;
+    };
+
+    /**
+     * @brief Map of model files read ahead, not referenced by any tile yet.
+     */
+    typedef std::unordered_map<std::string, PrefetchedModel> PrefetchedModelMap;
+
     /**
      * @brief Enumeration for disabling various VMAP features.
      */
@@ -116,6 +132,19 @@ namespace VMAP
         // Tree to check collision
         ModelFileMap iLoadedModelFiles; /**< Map of loaded model files. */
         InstanceTreeMap iInstanceMapTrees; /**< Map of instance trees. */
+        PrefetchedModelMap iPrefetchedModels; /**< Map of model files read ahead by prefetchMap. */
+        ACE_Thread_Mutex iModelLock; /**< Guards the model file maps, prefetchMap runs on other threads. */
+        mutable ACE_Thread_Mutex iTreeLock; /**< Guards iInstanceMapTrees, maps of different ids are updated concurrently. */
+
+        /**
+         * @brief Finds the tree of a map.
+         *
+         * The tree itself is only changed by the thread updating the maps of its id.
+         *
+         * @param pMapId The map ID.
+         * @return StaticMapTree* The tree, or NULL if the map is not loaded.
+         */
+        StaticMapTree* findTree(unsigned int pMapId) const;
 
         /**
          * @brief Internal method to load a map tile.
@@ -166,6 +195,16 @@ namespace VMAP
          */
         VMAPLoadResult loadMap(const char* pBasePath, unsigned int pMapId, int x, int y) override;
 
+        /**
+         * @brief Reads the model files of a map tile ahead of loadMap, may be called from any thread.
+         *
+         * @param pBasePath The base path to the map files.
+         * @param pMapId The map ID.
+         * @param x The x-coordinate of the tile.
+         * @param y The y-coordinate of the tile.
+         */
+        void prefetchMap(const char* pBasePath, unsigned int pMapId, int x, int y) override;
+
         /**
          * @brief Unloads a specific map tile.
          *
@@ -194,6 +233,20 @@ namespace VMAP
          * @return bool True if there is a line of sight, false otherwise.
          */
         bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) override;
+        /**
+         * @brief Checks the line of sight from one point to many points.
+         *
+         * @param pMapId The map ID.
+         * @param x1 The x-coordinate of the first point.
+         * @param y1 The y-coordinate of the first point.
+         * @param z1 The z-coordinate of the first point.
+         * @param count The number of second points.
+         * @param x2 The x-coordinates of the second points.
+         * @param y2 The y-coordinates of the second points.
+         * @param z2 The z-coordinates of the second points.
+         * @param results Receives the line of sight to each second point.
+         */
+        void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, uint32 count, const float* x2, const float* y2, const float* z2, bool* results) override;
         /**
          * @brief Gets the hit position of an object in the line of sight.
          *
@@ -124,6 +124,7 @@ static bool start_db()
 
     dbstring = sConfig.GetStringDefault("CharacterDatabaseInfo", "");
     nConnections = sConfig.GetIntDefault("CharacterDatabaseConnections", 1);
+    int nAsyncConnections = sConfig.GetIntDefault("CharacterDatabaseAsyncConnections", 1);
     if (dbstring.empty())
     {
         sLog.outError("Character Database not specified in configuration file");
@@ -132,10 +133,9 @@ static bool start_db()
         WorldDatabase.HaltDelayThread();
         return false;
     }
-    sLog.outString("Character Database total connections: %i", nConnections + 1);
 
     ///- Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), nConnections, nAsyncConnections))
     {
         sLog.outError("Can not connect to Character database %s", dbstring.c_str());
 
@@ -144,6 +144,9 @@ static bool start_db()
         return false;
     }
 
+    // the connection counts are clamped by Initialize
+    sLog.outString("Character Database total connections: %u", CharacterDatabase.GetQueryConnectionCount() + CharacterDatabase.GetAsyncConnectionCount());
+
     ///- Check the Character database version
     if (!CharacterDatabase.CheckDatabaseVersion(DATABASE_CHARACTER))
     {
@@ -29,127 +29,120 @@
 #include "DBCFileLoader.h"
 #include "DB2FileLoader.h"
 
+#include <ace/Mem_Map.h>
+
+#define DB2_HEADER_SIZE 48                                  // WDBC header fields, table hash, build and 5 WDB2 fields
+
 DB2FileLoader::DB2FileLoader()
 {
+    mappedFile = NULL;
+    fileBuffer = NULL;
+    mappingReleased = false;
     data = NULL;
+    stringTable = NULL;
     fieldsOffset = NULL;
 }
 
-bool DB2FileLoader::Load(const char *filename, const char *fmt)
+// header fields are not aligned in the file read into memory
+static uint32 ReadHeaderField(unsigned char const* file, uint32 index)
 {
-    uint32 header = 48;
-    if(data)
-    {
-        delete [] data;
-        data=NULL;
-    }
-
-    FILE * f = fopen(filename, "rb");
-    if(!f)return false;
-
-    if(fread(&header, 4, 1, f) != 1)                        // Signature
-    {
-        fclose(f);
-        return false;
-    }
-
-    EndianConvert(header);
-
-    if(header != 0x32424457)
-    {
-        fclose(f);
-        return false;                                       //'WDB2'
-    }
-
-    if(fread(&recordCount,4,1,f)!=1)                        // Number of records
-    {
-        fclose(f);
-        return false;
-    }
+    uint32 value;
+    memcpy(&value, file + index * sizeof(uint32), sizeof(uint32));
+    EndianConvert(value);
+    return value;
+}
 
-    EndianConvert(recordCount);
+bool DB2FileLoader::Load(const char *filename, const char *fmt)
+{
+    Unload();
 
-    if(fread(&fieldCount,4,1,f)!=1)                         // Number of fields
+    ACE_Mem_Map* mapping = new ACE_Mem_Map();
+    if (mapping->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_PRIVATE) == 0)
     {
-        fclose(f);
-        return false;
-    }
+        // the mapping stays valid without the descriptor, do not hold one per store
+        mapping->close_handle();
+        mappedFile = mapping;
 
-    EndianConvert(fieldCount);
+        if (!ParseFile(static_cast<unsigned char*>(mappedFile->addr()), mappedFile->size(), fmt))
+        {
+            Unload();
+            return false;
+        }
 
-    if(fread(&recordSize,4,1,f)!=1)                         // Size of a record
-    {
-        fclose(f);
-        return false;
+        return true;
     }
 
-    EndianConvert(recordSize);
+    delete mapping;
 
-    if(fread(&stringSize,4,1,f)!=1)                         // String size
+    // mapping is not available, read the whole file instead
+    FILE* f = fopen(filename, "rb");
+    if (!f)
     {
-        fclose(f);
         return false;
     }
 
-    EndianConvert(stringSize);
+    fseek(f, 0, SEEK_END);
+    long fileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
 
-    /* NEW WDB2 FIELDS*/
-    if(fread(&tableHash,4,1,f)!=1)                          // Table hash
+    if (fileSize < DB2_HEADER_SIZE)
     {
         fclose(f);
         return false;
     }
 
-    EndianConvert(tableHash);
+    fileBuffer = new unsigned char[fileSize];
 
-    if(fread(&build,4,1,f)!=1)                              // Build
+    if (fread(fileBuffer, fileSize, 1, f) != 1)
     {
         fclose(f);
+        Unload();
         return false;
     }
 
-    EndianConvert(build);
+    fclose(f);
 
-    if(fread(&unk1,4,1,f)!=1)                               // Unknown WDB2
+    if (!ParseFile(fileBuffer, size_t(fileSize), fmt))
     {
-        fclose(f);
+        Unload();
         return false;
     }
 
-    EndianConvert(unk1);
+    return true;
+}
 
-    if(fread(&unk2,4,1,f)!=1)                               // Unknown WDB2
+bool DB2FileLoader::ParseFile(unsigned char* file, size_t fileSize, const char* fmt)
+{
+    if (fileSize < DB2_HEADER_SIZE)
     {
-        fclose(f);
         return false;
     }
 
-    EndianConvert(unk2);
-
-    if(fread(&unk3,4,1,f)!=1)                               // Unknown WDB2
+    if (ReadHeaderField(file, 0) != 0x32424457)             //'WDB2'
     {
-        fclose(f);
         return false;
     }
 
-    EndianConvert(unk3);
+    recordCount = ReadHeaderField(file, 1);                 // Number of records
+    fieldCount = ReadHeaderField(file, 2);                  // Number of fields
+    recordSize = ReadHeaderField(file, 3);                  // Size of a record
+    stringSize = ReadHeaderField(file, 4);                  // String size
 
-    if(fread(&locale,4,1,f)!=1)                             // Locales
-    {
-        fclose(f);
-        return false;
-    }
-
-    EndianConvert(locale);
-
-    if(fread(&unk5,4,1,f)!=1)                               // Unknown WDB2
+    /* NEW WDB2 FIELDS*/
+    tableHash = ReadHeaderField(file, 5);                   // Table hash
+    build = ReadHeaderField(file, 6);                       // Build
+    unk1 = ReadHeaderField(file, 7);                        // Unknown WDB2
+    unk2 = ReadHeaderField(file, 8);                        // Unknown WDB2
+    unk3 = ReadHeaderField(file, 9);                        // Unknown WDB2
+    locale = ReadHeaderField(file, 10);                     // Locales
+    unk5 = ReadHeaderField(file, 11);                       // Unknown WDB2
+
+    // truncated file
+    if (DB2_HEADER_SIZE + uint64(recordSize) * recordCount + stringSize > fileSize)
     {
-        fclose(f);
         return false;
     }
 
-    EndianConvert(unk5);
-
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
     for(uint32 i = 1; i < fieldCount; i++)
@@ -165,29 +158,68 @@ bool DB2FileLoader::Load(const char *filename, const char *fmt)
         }
     }
 
-    data = new unsigned char[recordSize*recordCount+stringSize];
-    stringTable = data + recordSize*recordCount;
+    data = file + DB2_HEADER_SIZE;
+    stringTable = data + recordSize * recordCount;
+    return true;
+}
 
-    if(fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
+void DB2FileLoader::Unload()
+{
+    // a released mapping is unmapped by its new owner
+    if (!mappingReleased)
     {
-        fclose(f);
-        return false;
+        delete mappedFile;
     }
 
-    fclose(f);
-    return true;
+    delete[] fileBuffer;
+    delete[] fieldsOffset;
+
+    mappedFile = NULL;
+    fileBuffer = NULL;
+    mappingReleased = false;
+    data = NULL;
+    stringTable = NULL;
+    fieldsOffset = NULL;
 }
 
-DB2FileLoader::~DB2FileLoader()
+ACE_Mem_Map* DB2FileLoader::ReleaseMapping()
+{
+    if (!mappedFile)
+    {
+        return NULL;
+    }
+
+    mappingReleased = true;
+    return mappedFile;
+}
+
+bool DB2FileLoader::IsInPlaceFormat(const char* fmt) const
 {
-    if(data)
+#if MANGOS_ENDIAN == MANGOS_BIGENDIAN
+    // values have to be converted
+    return false;
+#else
+    if (strlen(fmt) != fieldCount || recordSize != fieldCount * sizeof(uint32))
     {
-        delete [] data;
+        return false;
     }
-    if(fieldsOffset)
+
+    // only 4 byte values kept in the record, so records are aligned and match the struct
+    for (uint32 x = 0; fmt[x]; ++x)
     {
-        delete [] fieldsOffset;
+        if (fmt[x] != DBC_FF_INT && fmt[x] != DBC_FF_IND && fmt[x] != DBC_FF_FLOAT)
+        {
+            return false;
+        }
     }
+
+    return true;
+#endif
+}
+
+DB2FileLoader::~DB2FileLoader()
+{
+    Unload();
 }
 
 DB2FileLoader::Record DB2FileLoader::getRecord(size_t id)
@@ -302,6 +334,18 @@ char* DB2FileLoader::AutoProduceData(const char* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    // the store keeps the file mapped, use the records where they are
+    if (mappingReleased && IsInPlaceFormat(format))
+    {
+        for (uint32 y = 0; y < recordCount; ++y)
+        {
+            char* record = reinterpret_cast<char*>(data + y * recordSize);
+            indexTable[i >= 0 ? getRecord(y).getUInt(i) : y] = record;
+        }
+
+        return NULL;
+    }
+
     char* dataTable = new char[recordCount * recordsize];
 
     uint32 offset = 0;
@@ -430,8 +474,13 @@ char* DB2FileLoader::AutoProduceStrings(const char* format, char* dataTable, Loc
     // each string field at load have array of string for each locale
     size_t stringHolderSize = sizeof(char*) * MAX_LOCALE;
 
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+    // strings of a mapping kept by the store are used in place, nothing to free at unload
+    char* stringPool = reinterpret_cast<char*>(stringTable);
+    if (!mappingReleased)
+    {
+        stringPool = new char[stringSize];
+        memcpy(stringPool, stringTable, stringSize);
+    }
 
     uint32 offset = 0;
 
@@ -479,5 +528,5 @@ char* DB2FileLoader::AutoProduceStrings(const char* format, char* dataTable, Loc
         }
     }
 
-    return stringPool;
+    return mappingReleased ? NULL : stringPool;
 }
@@ -30,6 +30,8 @@
 #include "Common/Common.h"
 #include <cassert>
 
+class ACE_Mem_Map;
+
 /**
  * @brief
  *
@@ -59,8 +61,15 @@ class DB2FileLoader
         DB2FileLoader();
         ~DB2FileLoader();
 
+    // Map the file into memory (private copy-on-write mapping), or read it if it can not be mapped
     bool Load(const char *filename, const char *fmt);
 
+    // Hand over the file mapping (NULL if the file was read), the caller keeps it alive
+    // as long as the data produced afterwards is used, records and strings are then used in place
+    ACE_Mem_Map* ReleaseMapping();
+    // Records of this format have the same layout in the file and in memory
+    bool IsInPlaceFormat(const char* fmt) const;
+
     class Record
     {
     public:
@@ -109,6 +118,7 @@ class DB2FileLoader
     uint32 GetCols() const { return fieldCount; }
     uint32 GetOffset(size_t id) const { return (fieldsOffset != NULL && id < fieldCount) ? fieldsOffset[id] : 0; }
     bool IsLoaded() const { return (data != NULL); }
+    // returns the data table to free at unload, NULL if the records are used in place
     char* AutoProduceData(const char* fmt, uint32& count, char**& indexTable);
     char* AutoProduceStringsArrayHolders(const char* fmt, char* dataTable);
     char* AutoProduceStrings(const char* fmt, char* dataTable, LocaleConstant loc);
@@ -116,6 +126,15 @@ class DB2FileLoader
     static uint32 GetFormatStringsFields(const char * format);
 private:
 
+    // Check the header and locate records and strings in the file contents
+    bool ParseFile(unsigned char* file, size_t fileSize, const char* fmt);
+    // Free the file contents and the field offsets
+    void Unload();
+
+    ACE_Mem_Map* mappedFile;                                // file mapping, NULL when read into fileBuffer
+    unsigned char* fileBuffer;                              // file contents when the file could not be mapped
+    bool mappingReleased;                                   // the caller keeps mappedFile alive, data can be used in place
+
     uint32 recordSize;
     uint32 recordCount;
     uint32 fieldCount;
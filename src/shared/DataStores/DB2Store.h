@@ -27,10 +27,13 @@
 
 #include "DB2FileLoader.h"
 
+#include <ace/Mem_Map.h>
+
 template<class T>
 class DB2Storage
 {
     typedef std::list<char*> StringPoolList;
+    typedef std::list<ACE_Mem_Map*> MappedFileList;
 public:
     explicit DB2Storage(const char *f) : nCount(0), fieldCount(0), fmt(f), indexTable(NULL), m_dataTable(NULL) { }
     ~DB2Storage() { Clear(); }
@@ -51,6 +54,12 @@ public:
 
         fieldCount = db2.GetCols();
 
+        // keep the file mapped, records and strings are then used in place where possible
+        if (ACE_Mem_Map* mapping = db2.ReleaseMapping())
+        {
+            m_mappedFileList.push_back(mapping);
+        }
+
         // load raw non-string data
         m_dataTable = (T*)db2.AutoProduceData(fmt,nCount,(char**&)indexTable);
 
@@ -79,6 +88,11 @@ public:
             return false;
         }
 
+        if (ACE_Mem_Map* mapping = db2.ReleaseMapping())
+        {
+            m_mappedFileList.push_back(mapping);
+        }
+
         // load strings from another locale dbc data
         m_stringPoolList.push_back(db2.AutoProduceStrings(fmt,(char*)m_dataTable,loc));
 
@@ -87,6 +101,13 @@ public:
 
     void Clear()
     {
+        // the entries and strings may point into the mapped files, also release them after a failed load
+        while (!m_mappedFileList.empty())
+        {
+            delete m_mappedFileList.front();
+            m_mappedFileList.pop_front();
+        }
+
         if (!indexTable)
         {
             return;
@@ -114,6 +135,7 @@ private:
     T** indexTable;
     T* m_dataTable;
     StringPoolList m_stringPoolList;
+    MappedFileList m_mappedFileList;                        // files the entries and strings are used from in place
 };
 
 #endif
@@ -28,68 +28,111 @@
 
 #include "DBCFileLoader.h"
 
+#include <ace/Mem_Map.h>
+
+#define DBC_HEADER_SIZE 20                                  // signature, record count, field count, record size, string size
+
 DBCFileLoader::DBCFileLoader()
 {
+    mappedFile = NULL;
+    fileBuffer = NULL;
+    mappingReleased = false;
     data = NULL;
+    stringTable = NULL;
     fieldsOffset = NULL;
 }
 
+// header fields are not aligned in the file read into memory
+static uint32 ReadHeaderField(unsigned char const* file, uint32 index)
+{
+    uint32 value;
+    memcpy(&value, file + index * sizeof(uint32), sizeof(uint32));
+    EndianConvert(value);
+    return value;
+}
+
 bool DBCFileLoader::Load(const char* filename, const char* fmt)
 {
-    uint32 header;
-    delete[] data;
+    Unload();
+
+    ACE_Mem_Map* mapping = new ACE_Mem_Map();
+    if (mapping->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_PRIVATE) == 0)
+    {
+        // the mapping stays valid without the descriptor, do not hold one per store
+        mapping->close_handle();
+        mappedFile = mapping;
+
+        if (!ParseFile(static_cast<unsigned char*>(mappedFile->addr()), mappedFile->size(), fmt))
+        {
+            Unload();
+            return false;
+        }
+
+        return true;
+    }
 
+    delete mapping;
+
+    // mapping is not available, read the whole file instead
     FILE* f = fopen(filename, "rb");
     if (!f)
     {
         return false;
     }
 
-    if (fread(&header, 4, 1, f) != 1)                       // Number of records
+    fseek(f, 0, SEEK_END);
+    long fileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if (fileSize < DBC_HEADER_SIZE)
     {
         fclose(f);
         return false;
     }
 
-    EndianConvert(header);
-    if (header != 0x43424457)                               //'WDBC'
+    fileBuffer = new unsigned char[fileSize];
+
+    if (fread(fileBuffer, fileSize, 1, f) != 1)
     {
         fclose(f);
+        Unload();
         return false;
     }
 
-    if (fread(&recordCount, 4, 1, f) != 1)                  // Number of records
+    fclose(f);
+
+    if (!ParseFile(fileBuffer, size_t(fileSize), fmt))
     {
-        fclose(f);
+        Unload();
         return false;
     }
 
-    EndianConvert(recordCount);
+    return true;
+}
 
-    if (fread(&fieldCount, 4, 1, f) != 1)                   // Number of fields
+bool DBCFileLoader::ParseFile(unsigned char* file, size_t fileSize, const char* fmt)
+{
+    if (fileSize < DBC_HEADER_SIZE)
     {
-        fclose(f);
         return false;
     }
 
-    EndianConvert(fieldCount);
-
-    if (fread(&recordSize, 4, 1, f) != 1)                   // Size of a record
+    if (ReadHeaderField(file, 0) != 0x43424457)             //'WDBC'
     {
-        fclose(f);
         return false;
     }
 
-    EndianConvert(recordSize);
+    recordCount = ReadHeaderField(file, 1);                 // Number of records
+    fieldCount = ReadHeaderField(file, 2);                  // Number of fields
+    recordSize = ReadHeaderField(file, 3);                  // Size of a record
+    stringSize = ReadHeaderField(file, 4);                  // String size
 
-    if (fread(&stringSize, 4, 1, f) != 1)                   // String size
+    // truncated file
+    if (DBC_HEADER_SIZE + uint64(recordSize) * recordCount + stringSize > fileSize)
     {
-        fclose(f);
         return false;
     }
 
-    EndianConvert(stringSize);
-
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
     for (uint32 i = 1; i < fieldCount; ++i)
@@ -105,23 +148,68 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
         }
     }
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
+    data = file + DBC_HEADER_SIZE;
     stringTable = data + recordSize * recordCount;
+    return true;
+}
 
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
+void DBCFileLoader::Unload()
+{
+    // a released mapping is unmapped by its new owner
+    if (!mappingReleased)
+    {
+        delete mappedFile;
+    }
+
+    delete[] fileBuffer;
+    delete[] fieldsOffset;
+
+    mappedFile = NULL;
+    fileBuffer = NULL;
+    mappingReleased = false;
+    data = NULL;
+    stringTable = NULL;
+    fieldsOffset = NULL;
+}
+
+ACE_Mem_Map* DBCFileLoader::ReleaseMapping()
+{
+    if (!mappedFile)
+    {
+        return NULL;
+    }
+
+    mappingReleased = true;
+    return mappedFile;
+}
+
+bool DBCFileLoader::IsInPlaceFormat(const char* fmt) const
+{
+#if MANGOS_ENDIAN == MANGOS_BIGENDIAN
+    // values have to be converted
+    return false;
+#else
+    if (strlen(fmt) != fieldCount || recordSize != fieldCount * sizeof(uint32))
     {
-        fclose(f);
         return false;
     }
 
-    fclose(f);
+    // only 4 byte values kept in the record, so records are aligned and match the struct
+    for (uint32 x = 0; fmt[x]; ++x)
+    {
+        if (fmt[x] != DBC_FF_INT && fmt[x] != DBC_FF_IND && fmt[x] != DBC_FF_FLOAT)
+        {
+            return false;
+        }
+    }
+
     return true;
+#endif
 }
 
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
-    delete[] fieldsOffset;
+    Unload();
 }
 
 DBCFileLoader::Record DBCFileLoader::getRecord(size_t id)
@@ -236,6 +324,18 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    // the store keeps the file mapped, use the records where they are
+    if (mappingReleased && IsInPlaceFormat(format))
+    {
+        for (uint32 y = 0; y < recordCount; ++y)
+        {
+            char* record = reinterpret_cast<char*>(data + y * recordSize);
+            indexTable[i >= 0 ? getRecord(y).getUInt(i) : y] = record;
+        }
+
+        return NULL;
+    }
+
     char* dataTable = new char[recordCount * recordsize];
 
     uint32 offset = 0;
@@ -364,8 +464,13 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable, Loc
     // each string field at load have array of string for each locale
     size_t stringHolderSize = sizeof(char*) * MAX_LOCALE;
 
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+    // strings of a mapping kept by the store are used in place, nothing to free at unload
+    char* stringPool = reinterpret_cast<char*>(stringTable);
+    if (!mappingReleased)
+    {
+        stringPool = new char[stringSize];
+        memcpy(stringPool, stringTable, stringSize);
+    }
 
     uint32 offset = 0;
 
@@ -411,5 +516,5 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable, Loc
         }
     }
 
-    return stringPool;
+    return mappingReleased ? NULL : stringPool;
 }
@@ -30,6 +30,8 @@
 #include "Common/Common.h"
 #include <cassert>
 
+class ACE_Mem_Map;
+
 /**
  * @brief
  *
@@ -68,7 +70,10 @@ class DBCFileLoader
         ~DBCFileLoader();
 
         /**
-         * @brief
+         * @brief Map the file into memory (or read it if it can not be mapped)
+         *
+         * The mapping is private and copy-on-write, so the pages of the file are
+         * shared with every other process using the same file until written to.
          *
          * @param filename
          * @param fmt
@@ -76,6 +81,25 @@ class DBCFileLoader
          */
         bool Load(const char* filename, const char* fmt);
 
+        /**
+         * @brief Hand over the file mapping, NULL if the file was read instead
+         *
+         * The caller owns the mapping and must keep it alive as long as the data
+         * produced afterwards is used: AutoProduceData and AutoProduceStrings then
+         * use records and strings in place instead of copying them.
+         *
+         * @return ACE_Mem_Map
+         */
+        ACE_Mem_Map* ReleaseMapping();
+
+        /**
+         * @brief Records of this format have the same layout in the file and in memory
+         *
+         * @param fmt
+         * @return bool
+         */
+        bool IsInPlaceFormat(const char* fmt) const;
+
         /**
          * @brief
          *
@@ -188,7 +212,7 @@ class DBCFileLoader
          * @param fmt
          * @param count
          * @param indexTable
-         * @return char
+         * @return char data table to free at unload, NULL if the records are used in place
          */
         char* AutoProduceData(const char* fmt, uint32& count, char**& indexTable);
         /**
@@ -212,6 +236,25 @@ class DBCFileLoader
 
     private:
 
+        /**
+         * @brief Check the header and locate records and strings in the file contents
+         *
+         * @param file
+         * @param fileSize
+         * @param fmt
+         * @return bool
+         */
+        bool ParseFile(unsigned char* file, size_t fileSize, const char* fmt);
+        /**
+         * @brief Free the file contents and the field offsets
+         *
+         */
+        void Unload();
+
+        ACE_Mem_Map* mappedFile;                            /**< file mapping, NULL when read into fileBuffer */
+        unsigned char* fileBuffer;                          /**< file contents when the file could not be mapped */
+        bool mappingReleased;                               /**< the caller keeps mappedFile alive, data can be used in place */
+
         uint32 recordSize; /**< TODO */
         uint32 recordCount; /**< TODO */
         uint32 fieldCount; /**< TODO */
@@ -27,6 +27,8 @@
 
 #include "DBCFileLoader.h"
 
+#include <ace/Mem_Map.h>
+
 template<class T>
 /**
  * @brief
@@ -39,6 +41,7 @@ class DBCStorage
          *
          */
         typedef std::list<char*> StringPoolList;
+        typedef std::list<ACE_Mem_Map*> MappedFileList;
     public:
         /**
          * @brief
@@ -108,6 +111,12 @@ class DBCStorage
 
             fieldCount = dbc.GetCols();
 
+            // keep the file mapped, records and strings are then used in place where possible
+            if (ACE_Mem_Map* mapping = dbc.ReleaseMapping())
+            {
+                m_mappedFileList.push_back(mapping);
+            }
+
             // load raw non-string data
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
 
@@ -160,6 +169,11 @@ class DBCStorage
                 return false;
             }
 
+            if (ACE_Mem_Map* mapping = dbc.ReleaseMapping())
+            {
+                m_mappedFileList.push_back(mapping);
+            }
+
             // load strings from another locale dbc data
             m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt,(char*)m_dataTable,loc));
 
@@ -178,6 +192,13 @@ class DBCStorage
                 loaded = false;
             }
 
+            // the entries and strings may point into the mapped files, also release them after a failed load
+            while (!m_mappedFileList.empty())
+            {
+                delete m_mappedFileList.front();
+                m_mappedFileList.pop_front();
+            }
+
             if (!indexTable)
             {
                 return;
@@ -193,6 +214,7 @@ class DBCStorage
                 delete[] m_stringPoolList.front();
                 m_stringPoolList.pop_front();
             }
+
             nCount = 0;
         }
 
@@ -219,6 +241,7 @@ class DBCStorage
         std::map<uint32, T const*> data;
         bool loaded;
         StringPoolList m_stringPoolList; /**< TODO */
+        MappedFileList m_mappedFileList;                    /**< files the entries and strings are used from in place */
 };
 
 #endif
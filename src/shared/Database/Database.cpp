@@ -35,6 +35,24 @@
 #define MIN_CONNECTION_POOL_SIZE 1
 #define MAX_CONNECTION_POOL_SIZE 16
 
+// affinity key of the async requests made by the current thread, see SqlAsyncAffinity
+static thread_local uint32 t_asyncAffinityKey = 0;
+
+SqlAsyncAffinity::SqlAsyncAffinity(uint32 key) : m_prevKey(t_asyncAffinityKey)
+{
+    t_asyncAffinityKey = key;
+}
+
+SqlAsyncAffinity::~SqlAsyncAffinity()
+{
+    t_asyncAffinityKey = m_prevKey;
+}
+
+uint32 SqlAsyncAffinity::GetKey()
+{
+    return t_asyncAffinityKey;
+}
+
 struct DBVersion
 {
     std::string dbname;
@@ -126,7 +144,7 @@ Database::~Database()
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -171,13 +189,23 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
+    // create and initialize connections for async requests
+    nAsyncConns = std::max(MIN_CONNECTION_POOL_SIZE, std::min(nAsyncConns, MAX_CONNECTION_POOL_SIZE));
+
+    for (int i = 0; i < nAsyncConns; ++i)
     {
-        return false;
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConnections.push_back(pConn);
     }
 
+    m_pAsyncConn = m_pAsyncConnections[0];
+
     m_pResultQueue = new SqlResultQueue;
 
     InitDelayThread();
@@ -189,9 +217,14 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
-
     m_pResultQueue = NULL;
+
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
+    {
+        delete m_pAsyncConnections[i];
+    }
+
+    m_pAsyncConnections.clear();
     m_pAsyncConn = NULL;
 
     for (size_t i = 0; i < m_pQueryConnections.size(); ++i)
@@ -202,36 +235,56 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
     m_TransStorage = new ACE_TSS<Database::TransHelper>();
-    m_delayThread = new ACE_Based::Thread(m_threadBody);
+
+    // New delay thread for delay execute, one per async connection
+    // the first one also pings the other connections
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
+    {
+        SqlDelayThread* threadBody = CreateDelayThread(m_pAsyncConnections[i], i == 0);
+        m_threadBodies.push_back(threadBody);           // will deleted at thread delete
+        m_delayThreads.push_back(new ACE_Based::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread)
+    if (m_threadBodies.empty() || m_delayThreads.empty())
     {
         return;
     }
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
+    // Stop event for all threads first, so they flush concurrently
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+    {
+        m_threadBodies[i]->Stop();
+    }
+
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+    {
+        m_delayThreads[i]->wait();                      // Wait for flush to DB
+        delete m_delayThreads[i];                       // This also deletes the thread body
+    }
+
     delete m_TransStorage;
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = NULL;
-    m_threadBody = NULL;
-    m_TransStorage=NULL;
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+    m_TransStorage = NULL;
+}
+
+SqlDelayThread* Database::getDelayThread() const
+{
+    return m_threadBodies[t_asyncAffinityKey % m_threadBodies.size()];
 }
 
 void Database::ThreadStart()
@@ -284,8 +337,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(m_pAsyncConnections[i]);
         delete guard->Query(sql);
     }
 
@@ -408,7 +462,7 @@ bool Database::Execute(const char* sql)
         }
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        getDelayThread()->Delay(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -491,7 +545,7 @@ bool Database::CommitTransaction()
     }
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay((*m_TransStorage)->detach());
+    getDelayThread()->Delay((*m_TransStorage)->detach());
     return true;
 }
 
@@ -688,7 +742,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
         }
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        getDelayThread()->Delay(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
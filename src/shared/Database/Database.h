@@ -50,6 +50,34 @@ enum DatabaseTypes
     COUNT_DATABASES,
 };
 
+/**
+ * @brief Keeps the async requests of the current thread in order for one key
+ *
+ * While a guard is alive, every async statement, query and transaction made
+ * by this thread goes to the async connection picked by the key (an account
+ * id for example). Requests with the same key are executed in the order they
+ * were made, requests with different keys may run in parallel when the
+ * database has more than one async connection. Without a guard (key 0) the
+ * requests go to the first connection. Guards can be nested, the destructor
+ * restores the previous key.
+ */
+class SqlAsyncAffinity
+{
+    public:
+        explicit SqlAsyncAffinity(uint32 key);
+        ~SqlAsyncAffinity();
+
+        /**
+         * @brief key of the current thread, 0 if there is no guard
+         *
+         * @return uint32
+         */
+        static uint32 GetKey();
+
+    private:
+        uint32 m_prevKey; /**< key to restore when leaving the scope */
+};
+
 /**
  * @brief
  *
@@ -232,17 +260,18 @@ class Database
          * @brief
          *
          * @param infoString
-         * @param nConns
+         * @param nConns number of connections for sync queries
+         * @param nAsyncConns number of connections (each with its own worker thread) for async requests
          * @return bool
          */
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
         /**
-         * @brief start worker thread for async DB request execution
+         * @brief start worker threads for async DB request execution
          *
          */
         virtual void InitDelayThread();
         /**
-         * @brief stop worker thread
+         * @brief stop worker threads, pending requests are flushed first
          *
          */
         virtual void HaltDelayThread();
@@ -597,6 +626,20 @@ class Database
          */
         operator bool () const { return m_pQueryConnections.size() && m_pAsyncConn != 0; }
 
+        /**
+         * @brief number of connections executing async requests
+         *
+         * @return uint32
+         */
+        uint32 GetAsyncConnectionCount() const { return uint32(m_pAsyncConnections.size()); }
+
+        /**
+         * @brief number of connections executing sync queries
+         *
+         * @return uint32
+         */
+        uint32 GetQueryConnectionCount() const { return uint32(m_pQueryConnections.size()); }
+
         /**
          * @brief escape string generation
          *
@@ -658,7 +701,7 @@ class Database
          */
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(NULL), m_pResultQueue(NULL),
-            m_threadBody(NULL), m_delayThread(NULL), m_bAllowAsyncTransactions(false),
+            m_bAllowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0), m_TransStorage(NULL)
         {
             m_nQueryCounter = -1;
@@ -679,9 +722,11 @@ class Database
         /**
          * @brief factory method to create SqlDelayThread objects
          *
+         * @param conn connection the thread executes its requests on
+         * @param pingDatabase if this thread keeps all connections of the database alive
          * @return SqlDelayThread
          */
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingDatabase);
 
         /**
          * @brief
@@ -748,11 +793,17 @@ class Database
          */
         SqlConnection* getQueryConnection();
         /**
-         * @brief for now return one single connection for async requests
+         * @brief connection for direct (blocking) transactions and statements
          *
          * @return SqlConnection
          */
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        /**
+         * @brief async worker selected by the SqlAsyncAffinity of the calling thread
+         *
+         * @return SqlDelayThread
+         */
+        SqlDelayThread* getDelayThread() const;
 
         friend class SqlStatement;
         // PREPARED STATEMENT API
@@ -784,12 +835,16 @@ class Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections; /**< TODO */
 
-        // only one single DB connection for transactions
-        SqlConnection* m_pAsyncConn; /**< TODO */
+        // connections for transactions and async requests, one worker thread each
+        SqlConnectionContainer m_pAsyncConnections;         /**< async connection pool */
+        SqlConnection* m_pAsyncConn;                        /**< first async connection, also used for direct execution */
+
+        typedef std::vector<SqlDelayThread*> SqlDelayThreadContainer;
+        typedef std::vector<ACE_Based::Thread*> DelayThreadContainer;
 
-        SqlResultQueue*     m_pResultQueue;                 /**< Transaction queues from diff. threads */
-        SqlDelayThread*     m_threadBody;                   /**< Pointer to delay sql executer (owned by m_delayThread) */
-        ACE_Based::Thread*  m_delayThread;                  /**< Pointer to executer thread */
+        SqlResultQueue*         m_pResultQueue;             /**< Transaction queues from diff. threads */
+        SqlDelayThreadContainer m_threadBodies;             /**< delay sql executers, one per async connection (owned by m_delayThreads) */
+        DelayThreadContainer    m_delayThreads;             /**< executer threads */
 
         bool m_bAllowAsyncTransactions;                     /**< flag which specifies if async transactions are enabled */
 
@@ -24,6 +24,41 @@
 
 #include "SQLStorage.h"
 
+#include <ace/Mem_Map.h>
+#include <ace/OS_NS_stdio.h>
+
+#define SQL_STORAGE_SNAPSHOT_MAGIC   0x534C5153             // 'SQLS'
+#define SQL_STORAGE_SNAPSHOT_VERSION 1
+
+/**
+ * @brief Snapshot file layout: header, record ids, records, string table.
+ *
+ * Every part starts 8 bytes aligned. String fields of the stored records
+ * hold an offset in the string table instead of a pointer, pointers and
+ * size_t have the same size on all supported platforms.
+ */
+struct SQLStorageSnapshotHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint64 key;
+    uint32 maxEntry;
+    uint32 recordCount;
+    uint32 recordSize;
+    uint32 padding;
+    uint64 stringsSize;
+};
+
+static_assert(sizeof(SQLStorageSnapshotHeader) % 8 == 0, "snapshot header must keep the record ids aligned");
+static_assert(sizeof(size_t) == sizeof(char*), "string offsets are stored in place of the pointers");
+
+static size_t AlignSnapshotSize(size_t size)
+{
+    return (size + 7) & ~size_t(7);
+}
+
+std::string SQLStorageBase::s_snapshotDir;
+
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
 SQLStorageBase::SQLStorageBase() :
@@ -36,7 +71,8 @@ SQLStorageBase::SQLStorageBase() :
     m_recordCount(0),
     m_maxEntry(0),
     m_recordSize(0),
-    m_data(NULL)
+    m_data(NULL),
+    m_snapshot(NULL)
 {}
 
 void SQLStorageBase::Initialize(const char* tableName, const char* entry_field, const char* src_format, const char* dst_format)
@@ -122,11 +158,290 @@ void SQLStorageBase::Free()
                 break;
         }
     }
-    delete[] m_data;
+
+    if (m_snapshot)
+    {
+        delete m_snapshot;
+        m_snapshot = NULL;
+    }
+    else
+    {
+        delete[] m_data;
+    }
+
     m_data = NULL;
     m_recordCount = 0;
 }
 
+void SQLStorageBase::SetSnapshotDir(const std::string& dir)
+{
+    s_snapshotDir = dir;
+
+    // normalize dir path to path/ or path\ form
+    if (!s_snapshotDir.empty() && s_snapshotDir.at(s_snapshotDir.length() - 1) != '/' && s_snapshotDir.at(s_snapshotDir.length() - 1) != '\\')
+    {
+        s_snapshotDir.append("/");
+    }
+}
+
+uint64 SQLStorageBase::SnapshotHash(const void* data, size_t size, uint64 hash /*= UI64LIT(14695981039346656037)*/)
+{
+    const uint8* bytes = static_cast<const uint8*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= UI64LIT(1099511628211);
+    }
+
+    return hash;
+}
+
+std::string SQLStorageBase::GetSnapshotFileName() const
+{
+    return s_snapshotDir + m_tableName + ".snapshot";
+}
+
+bool SQLStorageBase::GetStringFieldOffsets(std::vector<uint32>& offsets) const
+{
+    uint32 offset = 0;
+    for (uint32 x = 0; x < m_dstFieldCount; ++x)
+    {
+        switch (m_dst_format[x])
+        {
+            case DBC_FF_LOGIC:
+                offset += sizeof(bool);
+                break;
+            case DBC_FF_STRING:
+                offsets.push_back(offset);
+                offset += sizeof(char*);
+                break;
+            case DBC_FF_NA:
+            case DBC_FF_INT:
+                offset += sizeof(uint32);
+                break;
+            case DBC_FF_BYTE:
+            case DBC_FF_NA_BYTE:
+                offset += sizeof(char);
+                break;
+            case DBC_FF_FLOAT:
+            case DBC_FF_NA_FLOAT:
+                offset += sizeof(float);
+                break;
+            default:
+                // pointers set by the loader can not be restored from a file
+                return false;
+        }
+    }
+
+    return true;
+}
+
+uint64 SQLStorageBase::GetSnapshotKey(uint64 salt) const
+{
+    if (s_snapshotDir.empty())
+    {
+        return 0;
+    }
+
+    std::vector<uint32> stringOffsets;
+    if (!GetStringFieldOffsets(stringOffsets))
+    {
+        return 0;
+    }
+
+    // any change of the table content changes the checksum; unless the table was created with
+    // CHECKSUM=1 (MyISAM only) the server computes it by reading every row, which is still much
+    // cheaper than loading the rows through the client library
+    QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE `%s`", m_tableName);
+    if (!result)
+    {
+        return 0;
+    }
+
+    Field* fields = result->Fetch();
+    if (result->GetFieldCount() < 2 || fields[1].IsNULL())
+    {
+        delete result;
+        return 0;
+    }
+
+    std::string checksum = fields[1].GetCppString();
+    delete result;
+
+    std::string version;
+    result = WorldDatabase.Query("SELECT `version`, `structure`, `content` FROM `db_version` ORDER BY `version` DESC, `structure` DESC, `content` DESC LIMIT 1");
+    if (result)
+    {
+        fields = result->Fetch();
+        version = fields[0].GetCppString() + "." + fields[1].GetCppString() + "." + fields[2].GetCppString();
+        delete result;
+    }
+
+    const uint32 pointerSize = sizeof(char*);
+
+    uint64 key = SnapshotHash(m_tableName, strlen(m_tableName) + 1);
+    key = SnapshotHash(m_src_format, m_srcFieldCount + 1, key);
+    key = SnapshotHash(m_dst_format, m_dstFieldCount + 1, key);
+    key = SnapshotHash(checksum.c_str(), checksum.length() + 1, key);
+    key = SnapshotHash(version.c_str(), version.length() + 1, key);
+    key = SnapshotHash(&pointerSize, sizeof(pointerSize), key);
+    key = SnapshotHash(&salt, sizeof(salt), key);
+
+    return key ? key : 1;
+}
+
+bool SQLStorageBase::LoadSnapshot(uint64 key)
+{
+    ACE_Mem_Map* mapping = new ACE_Mem_Map();
+    if (mapping->map(GetSnapshotFileName().c_str(), static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_RDWR, ACE_MAP_PRIVATE) != 0)
+    {
+        delete mapping;
+        return false;
+    }
+
+    // the mapping stays valid without the descriptor, do not hold one per table
+    mapping->close_handle();
+
+    char* file = static_cast<char*>(mapping->addr());
+    const size_t fileSize = mapping->size();
+
+    SQLStorageSnapshotHeader header;
+    if (!file || fileSize < sizeof(header))
+    {
+        delete mapping;
+        return false;
+    }
+
+    memcpy(&header, file, sizeof(header));
+
+    const size_t idsPos = sizeof(header);
+    const size_t recordsPos = idsPos + AlignSnapshotSize(size_t(header.recordCount) * sizeof(uint32));
+    const size_t stringsPos = recordsPos + AlignSnapshotSize(size_t(header.recordCount) * header.recordSize);
+
+    if (header.magic != SQL_STORAGE_SNAPSHOT_MAGIC || header.version != SQL_STORAGE_SNAPSHOT_VERSION || header.key != key ||
+        fileSize != stringsPos + header.stringsSize || (header.stringsSize && file[fileSize - 1] != 0))
+    {
+        delete mapping;
+        return false;
+    }
+
+    std::vector<uint32> stringOffsets;
+    GetStringFieldOffsets(stringOffsets);
+
+    // the records stay in the (private) mapping, so only the pages changed at load are copied
+    prepareToLoad(header.maxEntry, 0, header.recordSize);
+    delete[] m_data;
+    m_data = file + recordsPos;
+    m_snapshot = mapping;
+
+    const uint32* recordIds = reinterpret_cast<const uint32*>(file + idsPos);
+    const char* strings = file + stringsPos;
+
+    for (uint32 i = 0; i < header.recordCount; ++i)
+    {
+        if (recordIds[i] >= header.maxEntry)
+        {
+            sLog.outError("Snapshot of table `%s` has entry %u out of range, ignoring it", m_tableName, recordIds[i]);
+            Free();
+            return false;
+        }
+
+        char* record = createRecord(recordIds[i]);
+
+        // strings are owned by the storage like for a database load, the post load checks may replace them
+        for (std::vector<uint32>::const_iterator itr = stringOffsets.begin(); itr != stringOffsets.end(); ++itr)
+        {
+            size_t stringPos;
+            memcpy(&stringPos, record + *itr, sizeof(stringPos));
+
+            const char* src = stringPos < header.stringsSize ? strings + stringPos : "";
+            const size_t len = strlen(src) + 1;
+
+            char* dst = new char[len];
+            memcpy(dst, src, len);
+            memcpy(record + *itr, &dst, sizeof(char*));
+        }
+    }
+
+    return true;
+}
+
+void SQLStorageBase::SaveSnapshot(uint64 key, const std::vector<uint32>& recordIds) const
+{
+    if (recordIds.size() != m_recordCount)
+    {
+        return;
+    }
+
+    std::vector<uint32> stringOffsets;
+    GetStringFieldOffsets(stringOffsets);
+
+    SQLStorageSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SQL_STORAGE_SNAPSHOT_MAGIC;
+    header.version = SQL_STORAGE_SNAPSHOT_VERSION;
+    header.key = key;
+    header.maxEntry = m_maxEntry;
+    header.recordCount = m_recordCount;
+    header.recordSize = m_recordSize;
+
+    // records with their string pointers replaced by offsets in the string table
+    std::vector<char> records(AlignSnapshotSize(size_t(m_recordCount) * m_recordSize), 0);
+    std::string strings;
+
+    if (m_recordCount)
+    {
+        memcpy(&records[0], m_data, size_t(m_recordCount) * m_recordSize);
+    }
+
+    for (uint32 i = 0; i < m_recordCount; ++i)
+    {
+        char* record = &records[size_t(i) * m_recordSize];
+        for (std::vector<uint32>::const_iterator itr = stringOffsets.begin(); itr != stringOffsets.end(); ++itr)
+        {
+            const char* src;
+            memcpy(&src, record + *itr, sizeof(char*));
+
+            size_t stringPos = strings.length();
+            strings.append(src ? src : "");
+            strings.push_back('\0');
+
+            memcpy(record + *itr, &stringPos, sizeof(stringPos));
+        }
+    }
+
+    header.stringsSize = strings.length();
+
+    std::vector<char> ids(AlignSnapshotSize(recordIds.size() * sizeof(uint32)), 0);
+    if (!recordIds.empty())
+    {
+        memcpy(&ids[0], &recordIds[0], recordIds.size() * sizeof(uint32));
+    }
+
+    // write to a temporary file first, a server starting meanwhile must never see half a snapshot
+    std::string fileName = GetSnapshotFileName();
+    std::string tmpFileName = fileName + ".tmp";
+
+    FILE* f = fopen(tmpFileName.c_str(), "wb");
+    if (!f)
+    {
+        sLog.outError("Can not write snapshot of table `%s` to %s", m_tableName, tmpFileName.c_str());
+        return;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = ok && (ids.empty() || fwrite(&ids[0], ids.size(), 1, f) == 1);
+    ok = ok && (records.empty() || fwrite(&records[0], records.size(), 1, f) == 1);
+    ok = ok && (strings.empty() || fwrite(strings.data(), strings.length(), 1, f) == 1);
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok || ACE_OS::rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+    {
+        sLog.outError("Can not write snapshot of table `%s` to %s", m_tableName, fileName.c_str());
+        remove(tmpFileName.c_str());
+    }
+}
+
 // -----------------------------------  SQLStorage  -------------------------------------------- //
 
 void SQLStorage::EraseEntry(uint32 id)
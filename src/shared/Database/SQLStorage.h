@@ -29,6 +29,8 @@
 #include "Database/DatabaseEnv.h"
 #include "DataStores/DBCFileLoader.h"
 
+class ACE_Mem_Map;
+
 /**
  * @brief
  *
@@ -166,6 +168,22 @@ class SQLStorageBase
          */
         SQLSIterator<T> getDataEnd() const { return SQLSIterator<T>(m_data + m_recordCount * m_recordSize, m_recordSize); }
 
+        /**
+         * @brief Set the directory holding the table snapshots, an empty string disables them
+         *
+         * @param dir
+         */
+        static void SetSnapshotDir(const std::string& dir);
+        /**
+         * @brief FNV-1a hash used for the snapshot validation keys
+         *
+         * @param data
+         * @param size
+         * @param hash value to continue from
+         * @return uint64
+         */
+        static uint64 SnapshotHash(const void* data, size_t size, uint64 hash = UI64LIT(14695981039346656037));
+
     protected:
         /**
          * @brief
@@ -237,6 +255,41 @@ class SQLStorageBase
          */
         char* createRecord(uint32 recordId);
 
+        /**
+         * @brief Key identifying the table content and the record layout, 0 when no snapshot can be used
+         *
+         * @param salt loader specific value, for conversions not only depending on the table rows
+         * @return uint64
+         */
+        uint64 GetSnapshotKey(uint64 salt) const;
+        /**
+         * @brief Map the snapshot of the table if its key matches and build the index from it
+         *
+         * @param key
+         * @return bool
+         */
+        bool LoadSnapshot(uint64 key);
+        /**
+         * @brief Write the freshly loaded records to the snapshot file of the table
+         *
+         * @param key
+         * @param recordIds
+         */
+        void SaveSnapshot(uint64 key, const std::vector<uint32>& recordIds) const;
+        /**
+         * @brief Offsets of the string fields in a record
+         *
+         * @param offsets
+         * @return bool false if the record has fields that can not be stored in a snapshot
+         */
+        bool GetStringFieldOffsets(std::vector<uint32>& offsets) const;
+        /**
+         * @brief
+         *
+         * @return std::string
+         */
+        std::string GetSnapshotFileName() const;
+
         // Information about the table
         const char* m_tableName; /**< TODO */
         const char* m_entry_field; /**< TODO */
@@ -252,6 +305,9 @@ class SQLStorageBase
 
         // Data Storage
         char* m_data; /**< TODO */
+        ACE_Mem_Map* m_snapshot; /**< mapping m_data points into, NULL when m_data is allocated */
+
+        static std::string s_snapshotDir; /**< empty when snapshots are disabled */
 };
 
 /**
@@ -648,6 +704,13 @@ class SQLStorageLoaderBase
          */
         void Load(StorageClass& storage, bool error_at_empty = true);
 
+        /**
+         * @brief Loaders with conversions depending on more than the table rows have to return a value changing with that data
+         *
+         * @return uint64
+         */
+        uint64 GetSnapshotSalt() const { return 0; }
+
         template<class S, class D>
         /**
          * @brief
@@ -266,6 +266,14 @@ template<class DerivedLoader, class StorageClass>
  */
 void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store, bool error_at_empty /*= true*/)
 {
+    // an unchanged table is taken from its snapshot instead of converting all rows again
+    uint64 snapshotKey = store.GetSnapshotKey(static_cast<DerivedLoader*>(this)->GetSnapshotSalt());
+    if (snapshotKey && store.LoadSnapshot(snapshotKey))
+    {
+        sLog.outString("Loaded %u records of table `%s` from snapshot", store.GetRecordCount(), store.GetTableName());
+        return;
+    }
+
     Field* fields = NULL;
     QueryResult* result  = WorldDatabase.PQuery("SELECT MAX(`%s`) FROM `%s`", store.EntryFieldName(), store.GetTableName());
     if (!result)
@@ -351,6 +359,12 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     // Prepare data storage and lookup storage
     store.prepareToLoad(maxRecordId, recordCount, recordsize);
 
+    std::vector<uint32> recordIds;
+    if (snapshotKey)
+    {
+        recordIds.reserve(recordCount);
+    }
+
     BarGoLink bar(recordCount);
     do
     {
@@ -358,6 +372,10 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         bar.step();
 
         char* record = store.createRecord(fields[0].GetUInt32());
+        if (snapshotKey)
+        {
+            recordIds.push_back(fields[0].GetUInt32());
+        }
         offset = 0;
 
         // dependend on dest-size
@@ -409,6 +427,12 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
     while (result->NextRow());
 
     delete result;
+
+    // saved before the post load checks of the caller change any record
+    if (snapshotKey)
+    {
+        store.SaveSnapshot(snapshotKey, recordIds);
+    }
 }
 
 #endif
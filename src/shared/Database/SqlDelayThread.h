@@ -50,6 +50,7 @@ class SqlDelayThread : public ACE_Based::Runnable
         Database* m_dbEngine;                               /**< Pointer to used Database engine */
         SqlConnection* m_dbConnection;                      /**< Pointer to DB connection */
         volatile bool m_running; /**< TODO */
+        bool m_pingDatabase;                                /**< ping all connections of m_dbEngine, only one thread per database does it */
 
         /**
          * @brief process all enqueued requests
@@ -63,8 +64,9 @@ class SqlDelayThread : public ACE_Based::Runnable
          *
          * @param db
          * @param conn
+         * @param pingDatabase
          */
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase = true);
         /**
          * @brief
          *
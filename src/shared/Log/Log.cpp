@@ -72,6 +72,96 @@ enum LogType
 
 const int LogType_count = int(LogError) + 1;
 
+#if PLATFORM != PLATFORM_WINDOWS
+enum ANSITextAttr
+{
+    TA_NORMAL = 0,
+    TA_BOLD = 1,
+    TA_BLINK = 5,
+    TA_REVERSE = 7
+};
+
+enum ANSIFgTextAttr
+{
+    FG_BLACK = 30, FG_RED,  FG_GREEN, FG_BROWN, FG_BLUE,
+    FG_MAGENTA,  FG_CYAN, FG_WHITE, FG_YELLOW
+};
+
+enum ANSIBgTextAttr
+{
+    BG_BLACK = 40, BG_RED,  BG_GREEN, BG_BROWN, BG_BLUE,
+    BG_MAGENTA,  BG_CYAN, BG_WHITE
+};
+
+static uint8 UnixColorFG[Color_count] =
+{
+    FG_BLACK,                                               // BLACK
+    FG_RED,                                                 // RED
+    FG_GREEN,                                               // GREEN
+    FG_BROWN,                                               // BROWN
+    FG_BLUE,                                                // BLUE
+    FG_MAGENTA,                                             // MAGENTA
+    FG_CYAN,                                                // CYAN
+    FG_WHITE,                                               // WHITE
+    FG_YELLOW,                                              // YELLOW
+    FG_RED,                                                 // LRED
+    FG_GREEN,                                               // LGREEN
+    FG_BLUE,                                                // LBLUE
+    FG_MAGENTA,                                             // LMAGENTA
+    FG_CYAN,                                                // LCYAN
+    FG_WHITE                                                // LWHITE
+};
+#endif
+
+// Buffers of the logging thread: the formatted message and the line built from it
+static thread_local std::vector<char> t_formatBuffer;
+static thread_local std::string t_lineBuffer;
+
+static const char* FormatLogMessage(const char* fmt, va_list ap)
+{
+    if (t_formatBuffer.size() < 512)
+    {
+        t_formatBuffer.resize(512);
+    }
+
+    va_list apCopy;
+    va_copy(apCopy, ap);
+    int len = vsnprintf(&t_formatBuffer[0], t_formatBuffer.size(), fmt, apCopy);
+    va_end(apCopy);
+
+    if (len < 0)
+    {
+        t_formatBuffer[0] = '\0';
+    }
+    else if (size_t(len) >= t_formatBuffer.size())
+    {
+        t_formatBuffer.resize(len + 1);
+        vsnprintf(&t_formatBuffer[0], t_formatBuffer.size(), fmt, ap);
+    }
+
+    return &t_formatBuffer[0];
+}
+
+static void AppendTime(std::string& line, bool withDate)
+{
+    time_t tt = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+
+    std::tm aTm;
+    localtime_r(&tt, &aTm);
+
+    char buf[24];
+    if (withDate)
+    {
+        snprintf(buf, sizeof(buf), "%-4d-%02d-%02d %02d:%02d:%02d ", aTm.tm_year + 1900, aTm.tm_mon + 1, aTm.tm_mday, aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+    }
+    else
+    {
+        snprintf(buf, sizeof(buf), "%02d:%02d:%02d ", aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+    }
+
+    line.append(buf);
+}
+
 Log::Log() :
     raLogfile(NULL), logfile(NULL), gmLogfile(NULL), charLogfile(NULL), dberLogfile(NULL),
 #ifdef ENABLE_ELUNA
@@ -145,46 +235,6 @@ void Log::SetColor(bool stdout_stream, Color color)
     HANDLE hConsole = GetStdHandle(stdout_stream ? STD_OUTPUT_HANDLE : STD_ERROR_HANDLE);
     SetConsoleTextAttribute(hConsole, WinColorFG[color]);
 #else
-
-    enum ANSITextAttr
-    {
-        TA_NORMAL = 0,
-        TA_BOLD = 1,
-        TA_BLINK = 5,
-        TA_REVERSE = 7
-    };
-
-    enum ANSIFgTextAttr
-    {
-        FG_BLACK = 30, FG_RED,  FG_GREEN, FG_BROWN, FG_BLUE,
-        FG_MAGENTA,  FG_CYAN, FG_WHITE, FG_YELLOW
-    };
-
-    enum ANSIBgTextAttr
-    {
-        BG_BLACK = 40, BG_RED,  BG_GREEN, BG_BROWN, BG_BLUE,
-        BG_MAGENTA,  BG_CYAN, BG_WHITE
-    };
-
-    static uint8 UnixColorFG[Color_count] =
-    {
-        FG_BLACK,                                           // BLACK
-        FG_RED,                                             // RED
-        FG_GREEN,                                           // GREEN
-        FG_BROWN,                                           // BROWN
-        FG_BLUE,                                            // BLUE
-        FG_MAGENTA,                                         // MAGENTA
-        FG_CYAN,                                            // CYAN
-        FG_WHITE,                                           // WHITE
-        FG_YELLOW,                                          // YELLOW
-        FG_RED,                                             // LRED
-        FG_GREEN,                                           // LGREEN
-        FG_BLUE,                                            // LBLUE
-        FG_MAGENTA,                                         // LMAGENTA
-        FG_CYAN,                                            // LCYAN
-        FG_WHITE                                            // LWHITE
-    };
-
     fprintf((stdout_stream ? stdout : stderr), "\x1b[%d%sm", UnixColorFG[color], (color >= YELLOW && color < Color_count ? ";1" : ""));
 #endif
 
@@ -239,6 +289,9 @@ void Log::SetLogFileLevel(char* level)
 
 void Log::Initialize()
 {
+    // lines still queued go to the files they were logged for
+    m_writer.Stop();
+
     /// Common log files data
     m_logsDir = sConfig.GetStringDefault("LogsDir", "");
     if (!m_logsDir.empty())
@@ -318,6 +371,14 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    if (sConfig.GetBoolDefault("LogAsync", false))
+    {
+        if (!m_writer.Start(sConfig.GetIntDefault("LogAsync.QueueSize", 8192), sConfig.GetBoolDefault("LogAsync.DropWhenFull", false)))
+        {
+            fprintf(stderr, "Log: can't start the LogAsync writer thread, logging synchronously\n");
+        }
+    }
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -403,33 +464,53 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outString()
+void Log::outConsole(bool stdout_stream, int logType, const char* text)
 {
-    if (m_includeTime)
-    {
-        outTime();
-    }
-    std::cout << std::endl;
-    if (logfile)
+    FILE* out = stdout_stream ? stdout : stderr;
+    bool colored = m_colored && logType >= 0;
+
+    // at Windows console colors are set through the console API, so the console is always written directly
+#if PLATFORM != PLATFORM_WINDOWS
+    if (m_writer.IsRunning())
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+        std::string& line = t_lineBuffer;
+        line.clear();
 
-    fflush(stdout);
-}
+        if (colored)
+        {
+            Color color = m_colors[logType];
 
-void Log::outString(const char* str, ...)
-{
-    if (!str)
-    {
+            char code[16];
+            snprintf(code, sizeof(code), "\x1b[%d%sm", UnixColorFG[color], (color >= YELLOW && color < Color_count ? ";1" : ""));
+            line.append(code);
+        }
+
+        if (m_includeTime)
+        {
+            AppendTime(line, false);
+        }
+
+        line.append(text);
+
+        if (colored)
+        {
+            line.append("\x1b[0m");
+        }
+
+        line.push_back('\n');
+
+        if (!m_writer.Write(out, line.data(), line.size()))
+        {
+            fwrite(line.data(), 1, line.size(), out);
+            fflush(out);
+        }
         return;
     }
+#endif
 
-    if (m_colored)
+    if (colored)
     {
-        SetColor(true, m_colors[LogNormal]);
+        SetColor(stdout_stream, m_colors[logType]);
     }
 
     if (m_includeTime)
@@ -437,189 +518,118 @@ void Log::outString(const char* str, ...)
         outTime();
     }
 
-    va_list ap;
-
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
-
-    if (m_colored)
-    {
-        ResetColor(true);
-    }
-
-    std::cout << std::endl;
+    utf8printf(out, "%s", text);
 
-    if (logfile)
+    if (colored)
     {
-        outTimestamp(logfile);
-
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-
-        fflush(logfile);
+        ResetColor(stdout_stream);
     }
 
-    fflush(stdout);
+    fprintf(out, "\n");
+    fflush(out);
 }
 
-void Log::outError(const char* err, ...)
+void Log::outFile(FILE* file, const char* prefix, const char* text, bool newline)
 {
-    if (!err)
+    if (!file)
     {
         return;
     }
 
-    if (m_colored)
-    {
-        SetColor(false, m_colors[LogError]);
-    }
+    std::string& line = t_lineBuffer;
+    line.clear();
 
-    if (m_includeTime)
-    {
-        outTime();
-    }
+    AppendTime(line, true);
+    line.append(prefix);
+    line.append(text);
 
-    va_list ap;
-
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
-
-    if (m_colored)
+    if (newline)
     {
-        ResetColor(false);
+        line.push_back('\n');
     }
 
-    fprintf(stderr, "\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    fflush(stderr);
+    WriteLine(file, line);
 }
 
-void Log::outErrorDb()
+void Log::WriteLine(FILE* file, std::string const& line)
 {
-    if (m_includeTime)
+    if (m_writer.IsRunning() && m_writer.Write(file, line.data(), line.size()))
     {
-        outTime();
+        return;
     }
 
-    fprintf(stderr, "\n");
+    fwrite(line.data(), 1, line.size(), file);
+    fflush(file);
+}
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
-    }
+void Log::outString()
+{
+    outConsole(true, -1, "");
+    outFile(logfile, "", "");
+}
 
-    if (dberLogfile)
+void Log::outString(const char* str, ...)
+{
+    if (!str)
     {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        return;
     }
 
-    fflush(stderr);
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
+
+    outConsole(true, LogNormal, text);
+    outFile(logfile, "", text);
 }
 
-void Log::outErrorDb(const char* err, ...)
+void Log::outError(const char* err, ...)
 {
     if (!err)
     {
         return;
     }
 
-    if (m_colored)
-    {
-        SetColor(false, m_colors[LogError]);
-    }
-
-    if (m_includeTime)
-    {
-        outTime();
-    }
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    const char* text = FormatLogMessage(err, ap);
     va_end(ap);
 
-    if (m_colored)
-    {
-        ResetColor(false);
-    }
+    outConsole(false, LogError, text);
+    outFile(logfile, "ERROR:", text);
+}
 
-    fprintf(stderr, "\n");
+void Log::outErrorDb()
+{
+    outConsole(false, -1, "");
+    outFile(logfile, "ERROR:", "");
+    outFile(dberLogfile, "", "");
+}
 
-    if (logfile)
+void Log::outErrorDb(const char* err, ...)
+{
+    if (!err)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        return;
     }
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
-
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
+    va_list ap;
+    va_start(ap, err);
+    const char* text = FormatLogMessage(err, ap);
+    va_end(ap);
 
-    fflush(stderr);
+    outConsole(false, LogError, text);
+    outFile(logfile, "ERROR:", text);
+    outFile(dberLogfile, "", text);
 }
 
 #ifdef ENABLE_ELUNA
 void Log::outErrorEluna()
 {
-    if (m_includeTime)
-    {
-        outTime();
-    }
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna\n");
-        fflush(logfile);
-    }
-
-    if (elunaErrLogfile)
-    {
-        outTimestamp(elunaErrLogfile);
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
-    }
-
-    fflush(stderr);
+    outConsole(false, -1, "");
+    outFile(logfile, "ERROR Eluna", "");
+    outFile(elunaErrLogfile, "", "");
 }
 #else
 /* This is made to not fiddle with the eluna code in LuaEngine/ at all */
@@ -634,56 +644,14 @@ void Log::outErrorEluna(const char* err, ...)
         return;
     }
 
-    if (m_colored)
-    {
-        SetColor(false, m_colors[LogError]);
-    }
-
-    if (m_includeTime)
-    {
-        outTime();
-    }
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    const char* text = FormatLogMessage(err, ap);
     va_end(ap);
 
-    if (m_colored)
-    {
-        ResetColor(false);
-    }
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR Eluna: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    if (elunaErrLogfile)
-    {
-        outTimestamp(elunaErrLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(elunaErrLogfile, err, ap);
-        va_end(ap);
-
-        fprintf(elunaErrLogfile, "\n");
-        fflush(elunaErrLogfile);
-    }
-
-    fflush(stderr);
+    outConsole(false, LogError, text);
+    outFile(logfile, "ERROR Eluna: ", text);
+    outFile(elunaErrLogfile, "", text);
 }
 #else
 /* This is made to not fiddle with the eluna code in LuaEngine/ at all */
@@ -692,28 +660,9 @@ void Log::outErrorEluna(const char* err, ...) {}
 
 void Log::outErrorEventAI()
 {
-    if (m_includeTime)
-    {
-        outTime();
-    }
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
-
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
-
-    fflush(stderr);
+    outConsole(false, -1, "");
+    outFile(logfile, "ERROR CreatureEventAI", "");
+    outFile(eventAiErLogfile, "", "");
 }
 
 void Log::outErrorEventAI(const char* err, ...)
@@ -723,56 +672,14 @@ void Log::outErrorEventAI(const char* err, ...)
         return;
     }
 
-    if (m_colored)
-    {
-        SetColor(false, m_colors[LogError]);
-    }
-
-    if (m_includeTime)
-    {
-        outTime();
-    }
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    const char* text = FormatLogMessage(err, ap);
     va_end(ap);
 
-    if (m_colored)
-    {
-        ResetColor(false);
-    }
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
-        va_end(ap);
-
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
-
-    fflush(stderr);
+    outConsole(false, LogError, text);
+    outFile(logfile, "ERROR CreatureEventAI: ", text);
+    outFile(eventAiErLogfile, "", text);
 }
 
 void Log::outBasic(const char* str, ...)
@@ -782,43 +689,28 @@ void Log::outBasic(const char* str, ...)
         return;
     }
 
-    if (m_logLevel >= LOG_LVL_BASIC)
-    {
-        if (m_colored)
-        {
-            SetColor(true, m_colors[LogDetails]);
-        }
-
-        if (m_includeTime)
-        {
-            outTime();
-        }
+    bool toConsole = m_logLevel >= LOG_LVL_BASIC;
+    bool toFile = logfile && m_logFileLevel >= LOG_LVL_BASIC;
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    if (!toConsole && !toFile)
+    {
+        return;
+    }
 
-        if (m_colored)
-        {
-            ResetColor(true);
-        }
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
 
-        printf("\n");
+    if (toConsole)
+    {
+        outConsole(true, LogDetails, text);
     }
 
-    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
+    if (toFile)
     {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
+        outFile(logfile, "", text);
     }
-
-    fflush(stdout);
 }
 
 void Log::outDetail(const char* str, ...)
@@ -828,45 +720,28 @@ void Log::outDetail(const char* str, ...)
         return;
     }
 
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-        {
-            SetColor(true, m_colors[LogDetails]);
-        }
-
-        if (m_includeTime)
-        {
-            outTime();
-        }
+    bool toConsole = m_logLevel >= LOG_LVL_DETAIL;
+    bool toFile = logfile && m_logFileLevel >= LOG_LVL_DETAIL;
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    if (!toConsole && !toFile)
+    {
+        return;
+    }
 
-        if (m_colored)
-        {
-            ResetColor(true);
-        }
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
 
-        printf("\n");
+    if (toConsole)
+    {
+        outConsole(true, LogDetails, text);
     }
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
+    if (toFile)
     {
-        outTimestamp(logfile);
-
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        outFile(logfile, "", text);
     }
-
-    fflush(stdout);
 }
 
 void Log::outDebug(const char* str, ...)
@@ -876,45 +751,28 @@ void Log::outDebug(const char* str, ...)
         return;
     }
 
-    if (m_logLevel >= LOG_LVL_DEBUG)
-    {
-        if (m_colored)
-        {
-            SetColor(true, m_colors[LogDebug]);
-        }
-
-        if (m_includeTime)
-        {
-            outTime();
-        }
+    bool toConsole = m_logLevel >= LOG_LVL_DEBUG;
+    bool toFile = logfile && m_logFileLevel >= LOG_LVL_DEBUG;
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    if (!toConsole && !toFile)
+    {
+        return;
+    }
 
-        if (m_colored)
-        {
-            ResetColor(true);
-        }
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
 
-        printf("\n");
+    if (toConsole)
+    {
+        outConsole(true, LogDebug, text);
     }
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
+    if (toFile)
     {
-        outTimestamp(logfile);
-
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        outFile(logfile, "", text);
     }
-
-    fflush(stdout);
 }
 
 void Log::outCommand(uint32 account, const char* str, ...)
@@ -924,84 +782,41 @@ void Log::outCommand(uint32 account, const char* str, ...)
         return;
     }
 
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
+
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
-        if (m_colored)
-        {
-            SetColor(true, m_colors[LogDetails]);
-        }
-
-        if (m_includeTime)
-        {
-            outTime();
-        }
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
-
-        if (m_colored)
-        {
-            ResetColor(true);
-        }
-
-        printf("\n");
+        outConsole(true, LogDetails, text);
     }
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
+    if (m_logFileLevel >= LOG_LVL_DETAIL)
     {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
+        outFile(logfile, "", text);
     }
 
     if (m_gmlog_per_account)
     {
+        // opened for this line only, so written directly
         if (FILE* per_file = openGmlogPerAccount(account))
         {
-            va_list ap;
             outTimestamp(per_file);
-            va_start(ap, str);
-            vfprintf(per_file, str, ap);
-            fprintf(per_file, "\n");
-            va_end(ap);
+            fprintf(per_file, "%s\n", text);
             fclose(per_file);
         }
     }
-    else if (gmLogfile)
+    else
     {
-        va_list ap;
-        outTimestamp(gmLogfile);
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
-        va_end(ap);
-        fflush(gmLogfile);
+        outFile(gmLogfile, "", text);
     }
-
-    fflush(stdout);
 }
 
 void Log::outWarden()
 {
-    if (m_includeTime)
-    {
-        outTime();
-    }
-    printf("\n");
-    if (wardenLogfile)
-    {
-        outTimestamp(wardenLogfile);
-        fprintf(wardenLogfile, "\n");
-        fflush(wardenLogfile);
-    }
-
-    fflush(stdout);
+    outConsole(true, -1, "");
+    outFile(wardenLogfile, "", "");
 }
 
 void Log::outWarden(const char* str, ...)
@@ -1010,100 +825,61 @@ void Log::outWarden(const char* str, ...)
     {
         return;
     }
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-        {
-            SetColor(true, m_colors[LogNormal]);
-        }
 
-        if (m_includeTime)
-        {
-            outTime();
-        }
-
-        va_list ap;
+    bool toConsole = m_logLevel >= LOG_LVL_DETAIL;
+    bool toFile = wardenLogfile && m_logFileLevel >= LOG_LVL_DETAIL;
 
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    if (!toConsole && !toFile)
+    {
+        return;
+    }
 
-        if (m_colored)
-        {
-            ResetColor(true);
-        }
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
 
-        printf("\n");
+    if (toConsole)
+    {
+        outConsole(true, LogNormal, text);
     }
 
-    if (wardenLogfile && m_logFileLevel >= LOG_LVL_DETAIL)
+    if (toFile)
     {
-        va_list ap;
-
-        outTimestamp(wardenLogfile);
-        fprintf(wardenLogfile, "[Warden]: ");
-
-        va_start(ap, str);
-        vfprintf(wardenLogfile, str, ap);
-        fprintf(wardenLogfile, "\n");
-        va_end(ap);
-
-        fflush(wardenLogfile);
+        outFile(wardenLogfile, "[Warden]: ", text);
     }
-
-    fflush(stdout);
 }
 
 void Log::outChar(const char* str, ...)
 {
-    if (!str)
+    if (!str || !charLogfile)
     {
         return;
     }
 
-    if (charLogfile)
-    {
-        va_list ap;
-        outTimestamp(charLogfile);
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
+
+    outFile(charLogfile, "", text);
 }
 
 void Log::outErrorScriptLib()
 {
-    if (m_includeTime)
-    {
-        outTime();
-    }
-
-    fprintf(stderr, "\n");
+    outConsole(false, -1, "");
 
-    if (logfile)
+    if (m_scriptLibName)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-        {
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        }
-        else
-        {
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        }
-        fflush(logfile);
+        std::string prefix = std::string("<") + m_scriptLibName + " ERROR:> ";
+        outFile(logfile, prefix.c_str(), "", false);
     }
-
-    if (scriptErrLogFile)
+    else
     {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
+        outFile(logfile, "<Scripting Library ERROR>: ", "", false);
     }
 
-    fflush(stderr);
+    outFile(scriptErrLogFile, "", "");
 }
 
 void Log::outErrorScriptLib(const char* err, ...)
@@ -1113,63 +889,24 @@ void Log::outErrorScriptLib(const char* err, ...)
         return;
     }
 
-    if (m_colored)
-    {
-        SetColor(false, m_colors[LogError]);
-    }
-
-    if (m_includeTime)
-    {
-        outTime();
-    }
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    const char* text = FormatLogMessage(err, ap);
     va_end(ap);
 
-    if (m_colored)
-    {
-        ResetColor(false);
-    }
-
-    fprintf(stderr, "\n");
+    outConsole(false, LogError, text);
 
-    if (logfile)
+    if (m_scriptLibName)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-        {
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        }
-        else
-        {
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        }
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        std::string prefix = std::string("<") + m_scriptLibName + " ERROR>: ";
+        outFile(logfile, prefix.c_str(), text);
     }
-
-    if (scriptErrLogFile)
+    else
     {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
-        va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
+        outFile(logfile, "<Scripting Library ERROR>: ", text);
     }
 
-    fflush(stderr);
+    outFile(scriptErrLogFile, "", text);
 }
 
 void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeName, ByteBuffer const* packet, bool incoming)
@@ -1179,57 +916,67 @@ void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeNam
         return;
     }
 
-    ACE_GUARD(ACE_Thread_Mutex, GuardObj, m_worldLogMtx);
+    // built completely first, so dumps of concurrent sockets do not interleave
+    std::string& line = t_lineBuffer;
+    line.clear();
+    line.reserve(128 + packet->size() * 3 + packet->size() / 16);
 
-    outTimestamp(worldLogfile);
+    AppendTime(line, true);
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %u\nLENGTH: %zu\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, packet->size(), opcodeName, opcode);
+    char buf[256];
+    snprintf(buf, sizeof(buf), "\n%s:\nSOCKET: %u\nLENGTH: %zu\nOPCODE: %s (0x%.4X)\nDATA:\n",
+             incoming ? "CLIENT" : "SERVER",
+             socket, packet->size(), opcodeName, opcode);
+    line.append(buf);
 
     size_t p = 0;
     while (p < packet->size())
     {
         for (size_t j = 0; j < 16 && p < packet->size(); ++j)
         {
-            fprintf(worldLogfile, "%.2X ", (*packet)[p++]);
+            snprintf(buf, sizeof(buf), "%.2X ", (*packet)[p++]);
+            line.append(buf);
         }
 
-        fprintf(worldLogfile, "\n");
+        line.push_back('\n');
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    line.append("\n\n");
+
+    WriteLine(worldLogfile, line);
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
     if (charLogfile)
     {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
+        std::string& line = t_lineBuffer;
+        line.clear();
+
+        char buf[256];
+        snprintf(buf, sizeof(buf), "== START DUMP == (account: %u guid: %u name: %s )\n", account_id, guid, name);
+
+        line.append(buf);
+        line.append(str);
+        line.append("\n== END DUMP ==\n");
+
+        WriteLine(charLogfile, line);
     }
 }
 
 void Log::outRALog(const char* str, ...)
 {
-    if (!str)
+    if (!str || !raLogfile)
     {
         return;
     }
 
-    if (raLogfile)
-    {
-        va_list ap;
-        outTimestamp(raLogfile);
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
-        va_end(ap);
-        fflush(raLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    const char* text = FormatLogMessage(str, ap);
+    va_end(ap);
 
-    fflush(stdout);
+    outFile(raLogfile, "", text);
 }
 
 void Log::WaitBeforeContinueIfNeed()
@@ -27,6 +27,7 @@
 
 #include "Common/Common.h"
 #include "Policies/Singleton.h"
+#include "LogWriter.h"
 
 class Config;
 class ByteBuffer;
@@ -130,6 +131,9 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          */
         ~Log()
         {
+            // write what is still queued before the files are closed
+            m_writer.Stop();
+
             if (logfile != NULL)
             {
                 fclose(logfile);
@@ -450,6 +454,31 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
          */
         FILE* openGmlogPerAccount(uint32 account);
 
+        /**
+         * @brief write a formatted message to stdout or stderr, with color and time as configured
+         *
+         * @param stdout_stream
+         * @param logType color of the message, -1 for none
+         * @param text
+         */
+        void outConsole(bool stdout_stream, int logType, const char* text);
+        /**
+         * @brief write a formatted message to a log file, with timestamp
+         *
+         * @param file may be NULL
+         * @param prefix
+         * @param text
+         * @param newline
+         */
+        void outFile(FILE* file, const char* prefix, const char* text, bool newline = true);
+        /**
+         * @brief write a complete line, through the writer thread when LogAsync is enabled
+         *
+         * @param file
+         * @param line
+         */
+        void WriteLine(FILE* file, std::string const& line);
+
         FILE* raLogfile; /**< TODO */
         FILE* logfile; /**< TODO */
         FILE* gmLogfile; /**< TODO */
@@ -463,7 +492,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, ACE_Th
         FILE* scriptErrLogFile; /**< TODO */
         FILE* worldLogfile; /**< TODO */
         FILE* wardenLogfile; /**< TODO */
-        ACE_Thread_Mutex m_worldLogMtx; /**< TODO */
+
+        LogWriter m_writer; /**< writer thread of LogAsync */
 
         LogLevel m_logLevel; /**< log/console control */
         LogLevel m_logFileLevel; /**< TODO */
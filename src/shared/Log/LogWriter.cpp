@@ -0,0 +1,228 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#include "LogWriter.h"
+
+#include <ace/OS_NS_unistd.h>
+
+#include <thread>
+#include <utility>
+
+// how long the writer sleeps when there is nothing to write
+#define LOG_WRITER_IDLE_USEC 5000
+
+LogWriter::LogWriter() : m_slots(NULL), m_mask(0), m_dropWhenFull(false),
+    m_enqueuePos(0), m_dequeuePos(0), m_running(false), m_producers(0), m_dropped(0), m_droppedReported(0)
+{
+}
+
+LogWriter::~LogWriter()
+{
+    Stop();
+}
+
+bool LogWriter::Start(uint32 queueSize, bool dropWhenFull)
+{
+    if (m_running)
+    {
+        return true;
+    }
+
+    size_t size = 2;
+    while (size < queueSize)
+    {
+        size <<= 1;
+    }
+
+    m_slots = new Slot[size];
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_slots[i].sequence = i;
+        m_slots[i].file = NULL;
+    }
+
+    m_mask = size - 1;
+    m_dropWhenFull = dropWhenFull;
+    m_enqueuePos = 0;
+    m_dequeuePos = 0;
+    m_running = true;
+
+    if (activate(THR_NEW_LWP | THR_JOINABLE, 1) == -1)
+    {
+        m_running = false;
+        WaitForProducers();
+        delete[] m_slots;
+        m_slots = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void LogWriter::Stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_running = false;
+    wait();
+
+    // lines queued while the thread was stopping, including the ones of the threads still inside Write
+    WaitForProducers();
+    WriteQueued();
+
+    delete[] m_slots;
+    m_slots = NULL;
+}
+
+void LogWriter::WaitForProducers()
+{
+    while (m_producers.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+bool LogWriter::Write(FILE* file, const char* text, size_t len)
+{
+    // checked after registering, so that Stop either sees this thread or this thread sees Stop
+    ++m_producers;
+    if (!m_running)
+    {
+        --m_producers;
+        return false;
+    }
+
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    for (;;)
+    {
+        slot = &m_slots[pos & m_mask];
+        size_t seq = slot->sequence.load(std::memory_order_acquire);
+        intptr_t dif = intptr_t(seq) - intptr_t(pos);
+
+        if (dif == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (dif < 0)
+        {
+            // full, the writer has not freed this slot yet
+            if (m_dropWhenFull)
+            {
+                ++m_dropped;
+                --m_producers;
+                return true;
+            }
+
+            // the writer is gone, nobody will free a slot anymore
+            if (!m_running)
+            {
+                --m_producers;
+                return false;
+            }
+
+            std::this_thread::yield();
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->file = file;
+    slot->text.assign(text, len);                           // reuses the capacity of the slot
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    --m_producers;
+    return true;
+}
+
+bool LogWriter::WriteQueued()
+{
+    // one buffer per file of this batch, there are only a few log files
+    std::vector<std::pair<FILE*, std::string> > batches;
+
+    for (;;)
+    {
+        Slot& slot = m_slots[m_dequeuePos & m_mask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1)
+        {
+            break;                                          // empty, or the next line is still being copied
+        }
+
+        size_t i = 0;
+        while (i < batches.size() && batches[i].first != slot.file)
+        {
+            ++i;
+        }
+
+        if (i == batches.size())
+        {
+            batches.push_back(std::make_pair(slot.file, std::string()));
+        }
+
+        batches[i].second.append(slot.text);
+
+        slot.text.clear();
+        slot.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+        ++m_dequeuePos;
+    }
+
+    for (size_t i = 0; i < batches.size(); ++i)
+    {
+        fwrite(batches[i].second.data(), 1, batches[i].second.size(), batches[i].first);
+        fflush(batches[i].first);
+    }
+
+    uint64 dropped = m_dropped;
+    if (dropped != m_droppedReported)
+    {
+        fprintf(stderr, "Log: " UI64FMTD " lines dropped, the LogAsync queue was full\n", dropped - m_droppedReported);
+        fflush(stderr);
+        m_droppedReported = dropped;
+    }
+
+    return !batches.empty();
+}
+
+int LogWriter::svc()
+{
+    while (m_running)
+    {
+        if (!WriteQueued())
+        {
+            ACE_OS::sleep(ACE_Time_Value(0, LOG_WRITER_IDLE_USEC));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOSSERVER_LOGWRITER_H
+#define MANGOSSERVER_LOGWRITER_H
+
+#include "Common/Common.h"
+
+#include <ace/Task.h>
+
+#include <atomic>
+
+/**
+ * @brief Background writer of the log files (LogAsync)
+ *
+ * Logging threads format their line themselves and push it into a bounded
+ * ring, which takes no lock. A single writer thread takes everything queued,
+ * groups it per file and does one write and one flush per file and batch.
+ *
+ * When the ring is full a logging thread either waits for the writer or
+ * drops the line (LogAsync.DropWhenFull). Dropped lines are counted and
+ * reported on stderr by the writer.
+ *
+ * Logging threads inside Write are counted, Stop waits for them before the
+ * ring is freed. Once stopping, Write refuses new lines and the caller
+ * writes them itself.
+ */
+class LogWriter : protected ACE_Task_Base
+{
+    public:
+        /**
+         * @brief
+         *
+         */
+        LogWriter();
+        /**
+         * @brief stops the writer thread after writing what is still queued
+         *
+         */
+        ~LogWriter();
+
+        /**
+         * @brief start the writer thread
+         *
+         * @param queueSize max number of lines waiting, rounded up to a power of 2
+         * @param dropWhenFull drop lines instead of waiting when the queue is full
+         * @return bool
+         */
+        bool Start(uint32 queueSize, bool dropWhenFull);
+        /**
+         * @brief write everything queued and stop the writer thread
+         *
+         */
+        void Stop();
+        /**
+         * @brief
+         *
+         * @return bool
+         */
+        bool IsRunning() const { return m_running; }
+
+        /**
+         * @brief queue a formatted line, can be called from any thread
+         *
+         * @param file
+         * @param text
+         * @param len
+         * @return bool false if the writer is stopped (or stopping), the line must be written directly
+         */
+        bool Write(FILE* file, const char* text, size_t len);
+
+        /**
+         * @brief
+         *
+         * @return uint64
+         */
+        uint64 GetDroppedCount() const { return m_dropped; }
+
+    private:
+        /**
+         * @brief
+         *
+         */
+        struct Slot
+        {
+            std::atomic<size_t> sequence;                   // position this slot can be written (== pos) or read (== pos + 1) at
+            FILE* file;
+            std::string text;
+        };
+
+        int svc() override;
+
+        /**
+         * @brief write everything queued, writer thread only
+         *
+         * @return bool false if there was nothing to write
+         */
+        bool WriteQueued();
+
+        /**
+         * @brief wait until no logging thread is inside Write anymore, m_running must be cleared
+         *
+         */
+        void WaitForProducers();
+
+        Slot* m_slots; /**< ring of m_mask + 1 slots */
+        size_t m_mask; /**< ring size - 1 */
+        bool m_dropWhenFull; /**< drop or wait when the ring is full */
+
+        std::atomic<size_t> m_enqueuePos; /**< next position to claim by the logging threads */
+        size_t m_dequeuePos; /**< next position to read by the writer */
+
+        std::atomic<bool> m_running; /**< cleared to stop the writer thread */
+        std::atomic<uint32> m_producers; /**< logging threads inside Write */
+        std::atomic<uint64> m_dropped; /**< lines dropped because the ring was full */
+        uint64 m_droppedReported; /**< part of m_dropped already reported */
+};
+
+#endif
@@ -24,10 +24,69 @@
 
 #include <ace/Singleton.h>
 #include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+#include <ace/Guard_T.h>
 #include <ace/Log_Msg.h>
 
 #include "DelayExecutor.h"
 
+// Completion counter of the slices of one execute_slices call
+class DelaySliceBatch
+{
+    public:
+
+        explicit DelaySliceBatch(size_t pending) : m_condition(m_mutex), m_pending(pending) {}
+
+        void finished()
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+            if (--m_pending == 0)
+            {
+                m_condition.broadcast();
+            }
+        }
+
+        void wait()
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+            while (m_pending > 0)
+            {
+                m_condition.wait();
+            }
+        }
+
+    private:
+
+        ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
+        size_t m_pending;
+};
+
+class DelaySliceRequest : public ACE_Method_Request
+{
+    public:
+
+        DelaySliceRequest(std::function<void(size_t)> const& slice, size_t index, DelaySliceBatch& batch)
+            : m_slice(slice), m_index(index), m_batch(batch)
+        {
+        }
+
+        virtual int call() override
+        {
+            m_slice(m_index);
+            m_batch.finished();
+            return 0;
+        }
+
+    private:
+
+        std::function<void(size_t)> const& m_slice;
+        size_t m_index;
+        DelaySliceBatch& m_batch;
+};
+
 DelayExecutor* DelayExecutor::instance()
 {
     return ACE_Singleton<DelayExecutor, ACE_Thread_Mutex>::instance();
@@ -148,6 +207,40 @@ int DelayExecutor::execute(ACE_Method_Request* new_req)
     return 0;
 }
 
+void DelayExecutor::execute_slices(size_t num_slices, std::function<void(size_t)> const& slice)
+{
+    if (num_slices == 0)
+    {
+        return;
+    }
+
+    if (!activated())
+    {
+        for (size_t i = 0; i < num_slices; ++i)
+        {
+            slice(i);
+        }
+        return;
+    }
+
+    DelaySliceBatch batch(num_slices - 1);
+
+    for (size_t i = 1; i < num_slices; ++i)
+    {
+        if (execute(new DelaySliceRequest(slice, i, batch)) == -1)
+        {
+            // could not queue it, do the work here instead of skipping the slice
+            slice(i);
+            batch.finished();
+        }
+    }
+
+    // the calling thread takes the first slice instead of idling until the workers are done
+    slice(0);
+
+    batch.wait();
+}
+
 bool DelayExecutor::activated()
 {
     return activated_;
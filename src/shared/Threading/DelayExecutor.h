@@ -29,6 +29,8 @@
 #include <ace/Activation_Queue.h>
 #include <ace/Method_Request.h>
 
+#include <functional>
+
 class DelayExecutor : protected ACE_Task_Base
 {
     public:
@@ -40,6 +42,11 @@ class DelayExecutor : protected ACE_Task_Base
 
         int execute(ACE_Method_Request* new_req);
 
+        // Calls slice(i) for every i < num_slices and returns when all of them are done. Slice 0 runs
+        // in the calling thread, the others on the executor threads, or in the calling thread as well
+        // when they cannot be queued.
+        void execute_slices(size_t num_slices, std::function<void(size_t)> const& slice);
+
         int activate(int num_threads = 1, ACE_Method_Request* pre_svc_hook = NULL, ACE_Method_Request* post_svc_hook = NULL);
 
         int deactivate();
@@ -24,14 +24,20 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
 /**
  * @brief Construct a new Event Processor::Event Processor object
  * Initializes member variables m_time and m_aborting.
  */
 EventProcessor::EventProcessor()
+    : m_wheel(NULL), m_dueEvents(NULL), m_readyEvents(NULL)
 {
     m_time = 0;
     m_aborting = false;
+    m_wheelTime = m_time + 1;
+    m_queueOrder = 0;
+    std::fill(m_levelCount, m_levelCount + WHEEL_LEVELS, 0);
 }
 
 /**
@@ -41,6 +47,7 @@ EventProcessor::EventProcessor()
 EventProcessor::~EventProcessor()
 {
     KillAllEvents(true);
+    delete[] m_wheel;
 }
 
 /**
@@ -53,27 +60,36 @@ void EventProcessor::Update(uint32 p_time)
     // update time
     m_time += p_time;
 
-    // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    // events added since the last update for a time already passed
+    RunReadyEvents(NULL, p_time);
+
+    // main event loop, m_wheelTime walks up to the new time
+    while (m_wheelTime <= m_time)
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        if (m_wheel && (m_wheelTime & (WHEEL_ROOT_SLOTS - 1)) == 0)
+        {
+            Cascade();
+        }
 
-        if (!Event->to_Abort)
+        if (m_levelCount[0])
         {
-            if (Event->Execute(m_time, p_time))
-            {
-                // completely destroy event if it is not re-added
-                delete Event;
-            }
+            RunReadyEvents(&m_wheel[SlotIndex(0, m_wheelTime)], p_time);
+            ++m_wheelTime;
+            continue;
         }
-        else
+
+        // nothing on the first level, skip to the next time an upper level cascades into it
+        uint64 next = m_time + 1;
+        for (uint32 level = 1; level < WHEEL_LEVELS; ++level)
         {
-            Event->Abort(m_time);
-            delete Event;
+            if (m_levelCount[level])
+            {
+                uint32 shift = LevelShift(level);
+                next = std::min(next, ((m_wheelTime >> shift) + 1) << shift);
+                break;
+            }
         }
+        m_wheelTime = next;
     }
 }
 
@@ -87,30 +103,20 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
-    {
-        EventList::iterator i_old = i;
-        ++i;
+    // abort all existing events, only non-deletable ones stay queued
+    AbortEvents(m_readyEvents, force);
+    AbortEvents(m_dueEvents, force);
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+    if (m_wheel)
+    {
+        for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
         {
-            delete i_old->second;
-
-            if (!force)                                     // need per-element cleanup
+            for (uint32 i = 0; i < LevelSlots(level); ++i)
             {
-                m_events.erase(i_old);
+                m_levelCount[level] -= AbortEvents(m_wheel[LevelOffset(level) + i], force);
             }
         }
     }
-
-    // fast clear event list (in force case)
-    if (force)
-    {
-        m_events.clear();
-    }
 }
 
 /**
@@ -128,7 +134,8 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
     }
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Event->m_queueOrder = m_queueOrder++;
+    Schedule(Event);
 }
 
 /**
@@ -141,3 +148,178 @@ uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+/**
+ * @brief Orders a queue by execution time, then by the order the events were added.
+ * Slots are filled newest first, so this is mostly a reversal.
+ *
+ * @param events
+ * @param count Set to the number of events.
+ * @return BasicEvent* First event to run.
+ */
+BasicEvent* EventProcessor::SortEvents(BasicEvent* events, uint32& count)
+{
+    BasicEvent* sorted = NULL;
+    count = 0;
+    while (events)
+    {
+        BasicEvent* Event = events;
+        events = events->m_nextEvent;
+        ++count;
+
+        BasicEvent** link = &sorted;
+        while (*link && ((*link)->m_execTime < Event->m_execTime ||
+                         ((*link)->m_execTime == Event->m_execTime && (*link)->m_queueOrder < Event->m_queueOrder)))
+        {
+            link = &(*link)->m_nextEvent;
+        }
+        Event->m_nextEvent = *link;
+        *link = Event;
+    }
+    return sorted;
+}
+
+/**
+ * @brief Queues an event on the lowest level whose span covers its delay.
+ *
+ * @param Event
+ */
+void EventProcessor::Schedule(BasicEvent* Event)
+{
+    uint64 e_time = Event->m_execTime;
+    if (e_time < m_wheelTime)
+    {
+        Event->m_nextEvent = m_dueEvents;
+        m_dueEvents = Event;
+        return;
+    }
+
+    if (!m_wheel)
+    {
+        m_wheel = new BasicEvent*[WHEEL_SLOTS];
+        std::fill(m_wheel, m_wheel + WHEEL_SLOTS, (BasicEvent*)NULL);
+    }
+
+    // delays past the last level wrap around it and are queued again when their slot comes up
+    uint64 delay = e_time - m_wheelTime;
+    uint32 level = 0;
+    while (level + 1 < WHEEL_LEVELS && delay >= (uint64(1) << LevelShift(level + 1)))
+    {
+        ++level;
+    }
+
+    BasicEvent*& slot = m_wheel[SlotIndex(level, e_time)];
+    Event->m_nextEvent = slot;
+    slot = Event;
+    ++m_levelCount[level];
+}
+
+/**
+ * @brief Called when m_wheelTime starts a new lap of the first level.
+ */
+void EventProcessor::Cascade()
+{
+    for (uint32 level = 1; level < WHEEL_LEVELS; ++level)
+    {
+        BasicEvent*& slot = m_wheel[SlotIndex(level, m_wheelTime)];
+        if (slot)
+        {
+            uint32 count;
+            BasicEvent* events = SortEvents(slot, count);
+            slot = NULL;
+            m_levelCount[level] -= count;
+
+            while (events)
+            {
+                BasicEvent* next = events->m_nextEvent;
+                Schedule(events);
+                events = next;
+            }
+        }
+
+        // the level above is only reached once this one wrapped around
+        if ((m_wheelTime >> LevelShift(level)) & (WHEEL_LEVEL_SLOTS - 1))
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Runs the overdue events and those of a slot, including events they queue again for the same time.
+ *
+ * @param slot First level slot of m_wheelTime, or NULL.
+ * @param p_time Update interval.
+ */
+void EventProcessor::RunReadyEvents(BasicEvent** slot, uint32 p_time)
+{
+    for (;;)
+    {
+        if (!m_readyEvents)
+        {
+            uint32 count;
+            if (m_dueEvents)
+            {
+                m_readyEvents = SortEvents(m_dueEvents, count);
+                m_dueEvents = NULL;
+            }
+            else if (slot && *slot)
+            {
+                m_readyEvents = SortEvents(*slot, count);
+                *slot = NULL;
+                m_levelCount[0] -= count;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        // get and remove event from queue
+        BasicEvent* Event = m_readyEvents;
+        m_readyEvents = Event->m_nextEvent;
+
+        if (!Event->to_Abort)
+        {
+            if (Event->Execute(m_time, p_time))
+            {
+                // completely destroy event if it is not re-added
+                delete Event;
+            }
+        }
+        else
+        {
+            Event->Abort(m_time);
+            delete Event;
+        }
+    }
+}
+
+/**
+ * @brief Aborts the events of a queue.
+ *
+ * @param events Queue, deleted events are unlinked from it.
+ * @param force If true, deletes non-deletable events too.
+ * @return uint32 Number of deleted events.
+ */
+uint32 EventProcessor::AbortEvents(BasicEvent*& events, bool force)
+{
+    uint32 removed = 0;
+    BasicEvent** link = &events;
+    while (BasicEvent* Event = *link)
+    {
+        Event->to_Abort = true;
+        Event->Abort(m_time);
+        if (force || Event->IsDeletable())
+        {
+            *link = Event->m_nextEvent;
+            delete Event;
+            ++removed;
+        }
+        else
+        {
+            link = &Event->m_nextEvent;
+        }
+    }
+    return removed;
+}
@@ -26,7 +26,6 @@
 #define MANGOS_H_EVENTPROCESSOR
 
 #include "Platform/Define.h"
-#include <map>
 
 /**
  * @brief Note. All times are in milliseconds here.
@@ -40,7 +39,7 @@ class BasicEvent
          * Initializes member variables to_Abort, m_addTime, and m_execTime.
          */
         BasicEvent()
-            : to_Abort(false), m_addTime(0), m_execTime(0) // Initialize member variables
+            : to_Abort(false), m_addTime(0), m_execTime(0), m_nextEvent(NULL), m_queueOrder(0) // Initialize member variables
         {
         }
 
@@ -80,17 +79,21 @@ class BasicEvent
         // These can be used for time offset control
         uint64 m_addTime; /**< Time when the event was added to queue, filled by event handler */
         uint64 m_execTime; /**< Planned time of next execution, filled by event handler */
-};
 
-/**
- * @brief Typedef for a multimap of events
- *
- */
-typedef std::multimap<uint64, BasicEvent*> EventList;
+    private:
+        friend class EventProcessor;
+
+        BasicEvent* m_nextEvent; /**< Next event queued in the same slot, filled by event handler */
+        uint64 m_queueOrder; /**< Keeps events of the same time in the order they were added, filled by event handler */
+};
 
 /**
  * @brief Event Processor class
  *
+ * Events are queued in a hierarchical timer wheel. The first level has one slot per
+ * millisecond, every further level has slots spanning a whole lap of the level below
+ * and is cascaded down as time reaches them. Events are linked through BasicEvent
+ * itself, so queuing them allocates nothing.
  */
 class EventProcessor
 {
@@ -140,8 +143,61 @@ class EventProcessor
 
     protected:
         uint64 m_time; /**< Current time in milliseconds */
-        EventList m_events; /**< List of events */
         bool m_aborting; /**< Flag indicating if the event processor is aborting */
+
+    private:
+        enum
+        {
+            WHEEL_ROOT_BITS   = 6,                          // 64 slots of 1 ms
+            WHEEL_LEVEL_BITS  = 4,                          // 16 slots per upper level, the last one wraps
+            WHEEL_LEVELS      = 4,
+            WHEEL_ROOT_SLOTS  = 1 << WHEEL_ROOT_BITS,
+            WHEEL_LEVEL_SLOTS = 1 << WHEEL_LEVEL_BITS,
+            WHEEL_SLOTS       = WHEEL_ROOT_SLOTS + (WHEEL_LEVELS - 1) * WHEEL_LEVEL_SLOTS
+        };
+
+        static uint32 LevelShift(uint32 level) { return level ? WHEEL_ROOT_BITS + (level - 1) * WHEEL_LEVEL_BITS : 0; }
+        static uint32 LevelOffset(uint32 level) { return level ? WHEEL_ROOT_SLOTS + (level - 1) * WHEEL_LEVEL_SLOTS : 0; }
+        static uint32 LevelSlots(uint32 level) { return level ? WHEEL_LEVEL_SLOTS : WHEEL_ROOT_SLOTS; }
+        static uint32 SlotIndex(uint32 level, uint64 time) { return LevelOffset(level) + uint32((time >> LevelShift(level)) & (LevelSlots(level) - 1)); }
+        static BasicEvent* SortEvents(BasicEvent* events, uint32& count);
+
+        /**
+         * @brief Queues an event at its m_execTime
+         *
+         * @param Event
+         */
+        void Schedule(BasicEvent* Event);
+
+        /**
+         * @brief Moves the upper level slots reached by m_wheelTime down the wheel
+         *
+         */
+        void Cascade();
+
+        /**
+         * @brief Runs the overdue events, then those of the given first level slot
+         *
+         * @param slot
+         * @param p_time
+         */
+        void RunReadyEvents(BasicEvent** slot, uint32 p_time);
+
+        /**
+         * @brief Aborts the events of a queue, unlinking the deleted ones
+         *
+         * @param events
+         * @param force
+         * @return uint32 number of deleted events
+         */
+        uint32 AbortEvents(BasicEvent*& events, bool force);
+
+        BasicEvent** m_wheel; /**< Slots of all levels, allocated with the first event */
+        BasicEvent* m_dueEvents; /**< Events added for a time the wheel already passed */
+        BasicEvent* m_readyEvents; /**< Events taken from a slot and being run, in scheduling order */
+        uint64 m_wheelTime; /**< First millisecond the wheel has not run yet */
+        uint64 m_queueOrder; /**< Number of events added so far */
+        uint32 m_levelCount[WHEEL_LEVELS]; /**< Number of events queued on each level */
 };
 
 #endif
@@ -33,6 +33,7 @@
 #include <string>
 #include <vector>
 #include <errno.h>
+#include <sys/stat.h>
 #include "Platform/Define.h"
 
 #ifndef WIN32
@@ -172,6 +173,23 @@ namespace MMAP
 
         return LISTFILE_OK;
     }
+
+    /**
+     * @brief last modification time of a file
+     *
+     * @param fileName
+     * @return time_t 0 when the file does not exist
+     */
+    inline time_t getFileModificationTime(const string& fileName)
+    {
+        struct stat fileInfo;
+        if (stat(fileName.c_str(), &fileInfo) != 0)
+        {
+            return 0;
+        }
+
+        return fileInfo.st_mtime;
+    }
 }
 
 #endif
@@ -30,6 +30,9 @@
 
 #include "MapTree.h"
 #include "ModelInstance.h"
+#include "VMapManager2.h"
+
+#include <thread>
 
 using namespace VMAP;
 
@@ -37,7 +40,8 @@ namespace MMAP
 {
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
+                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath,
+                           uint32 threads, bool incremental) :
         m_terrainBuilder(NULL),
         m_debugOutput(debugOutput),
         m_skipContinents(skipContinents),
@@ -45,6 +49,8 @@ namespace MMAP
         m_skipBattlegrounds(skipBattlegrounds),
         m_maxWalkableAngle(maxWalkableAngle),
         m_bigBaseUnit(bigBaseUnit),
+        m_threads(threads ? threads : 1),
+        m_incremental(incremental),
         m_rcContext(NULL),
         m_offMeshFilePath(offMeshFilePath)
     {
@@ -173,7 +179,7 @@ namespace MMAP
             return;
         }
 
-        buildTile(mapID, tileX, tileY, navMesh);
+        buildTile(mapID, tileX, tileY, navMesh, m_rcContext);
         dtFreeNavMesh(navMesh);
     }
 
@@ -213,8 +219,8 @@ namespace MMAP
             return;
         }
 
-        // now start building mmtiles for each tile
-        printf("We have %u tiles.                          \n", (unsigned int)tiles->size());
+        // tiles to build, in a fixed order so that the output does not depend on the thread count
+        vector<uint32> pendingTiles;
         for (set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
         {
             uint32 tileX, tileY;
@@ -222,12 +228,40 @@ namespace MMAP
             // unpack tile coords
             StaticMapTree::unpackTileID((*it), tileX, tileY);
 
-            if (shouldSkipTile(mapID, tileX, tileY))
+            if (!shouldSkipTile(mapID, tileX, tileY))
             {
-                continue;
+                pendingTiles.push_back(*it);
+            }
+        }
+
+        // now start building mmtiles for each tile
+        printf("We have %u tiles, %u to build.                          \n", (unsigned int)tiles->size(), (unsigned int)pendingTiles.size());
+
+        atomic<size_t> nextTile(0);
+        size_t numThreads = std::min<size_t>(m_threads, pendingTiles.size());
+        if (numThreads <= 1)
+        {
+            for (size_t i = 0; i < pendingTiles.size(); ++i)
+            {
+                uint32 tileX, tileY;
+                StaticMapTree::unpackTileID(pendingTiles[i], tileX, tileY);
+                buildTile(mapID, tileX, tileY, navMesh, m_rcContext);
+            }
+        }
+        else
+        {
+            // every worker takes the next tile of the list when it is done with one,
+            // so workers on small tiles are not left waiting for the big ones
+            vector<thread> workers;
+            for (size_t i = 0; i < numThreads; ++i)
+            {
+                workers.push_back(thread(&MapBuilder::buildTiles, this, mapID, navMesh->getParams(), &pendingTiles, &nextTile));
             }
 
-            buildTile(mapID, tileX, tileY, navMesh);
+            for (size_t i = 0; i < workers.size(); ++i)
+            {
+                workers[i].join();
+            }
         }
 
         dtFreeNavMesh(navMesh);
@@ -235,7 +269,30 @@ namespace MMAP
         printf("Complete!                               \n\n");
     }
     /**************************************************************************/
-    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
+    void MapBuilder::buildTiles(uint32 mapID, const dtNavMeshParams* navMeshParams, const vector<uint32>* tiles, atomic<size_t>* nextTile)
+    {
+        dtNavMesh* navMesh = dtAllocNavMesh();
+        if (!navMesh || !navMesh->init(navMeshParams))
+        {
+            printf("Failed creating navmesh!              \n");
+            dtFreeNavMesh(navMesh);
+            return;
+        }
+
+        rcContext context(false);
+
+        for (size_t i = (*nextTile)++; i < tiles->size(); i = (*nextTile)++)
+        {
+            uint32 tileX, tileY;
+            StaticMapTree::unpackTileID((*tiles)[i], tileX, tileY);
+            buildTile(mapID, tileX, tileY, navMesh, &context);
+        }
+
+        dtFreeNavMesh(navMesh);
+    }
+
+    /**************************************************************************/
+    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, rcContext* context)
     {
         printf("Building map %03u, tile [%02u,%02u]\n", mapID, tileX, tileY);
 
@@ -274,7 +331,7 @@ namespace MMAP
         m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
 
         // build navmesh tile
-        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh, context);
     }
 
     /**************************************************************************/
@@ -415,7 +472,7 @@ namespace MMAP
     /**************************************************************************/
     void MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
                                       MeshData& meshData, float bmin[3], float bmax[3],
-                                      dtNavMesh* navMesh)
+                                      dtNavMesh* navMesh, rcContext* context)
     {
         // console output
         char tileString[10];
@@ -500,7 +557,7 @@ namespace MMAP
 
                 // build heightfield
                 tile.solid = rcAllocHeightfield();
-                if (!tile.solid || !rcCreateHeightfield(m_rcContext, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
+                if (!tile.solid || !rcCreateHeightfield(context, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
                 {
                     printf("%s Failed building heightfield!            \n", tileString);
                     continue;
@@ -509,45 +566,45 @@ namespace MMAP
                 // mark all walkable tiles, both liquids and solids
                 unsigned char* triFlags = new unsigned char[tTriCount];
                 memset(triFlags, NAV_GROUND, tTriCount * sizeof(unsigned char));
-                rcClearUnwalkableTriangles(m_rcContext, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
-                rcRasterizeTriangles(m_rcContext, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
+                rcClearUnwalkableTriangles(context, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
+                rcRasterizeTriangles(context, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
                 delete [] triFlags;
 
-                rcFilterLowHangingWalkableObstacles(m_rcContext, config.walkableClimb, *tile.solid);
-                rcFilterLedgeSpans(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
-                rcFilterWalkableLowHeightSpans(m_rcContext, tileCfg.walkableHeight, *tile.solid);
+                rcFilterLowHangingWalkableObstacles(context, config.walkableClimb, *tile.solid);
+                rcFilterLedgeSpans(context, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
+                rcFilterWalkableLowHeightSpans(context, tileCfg.walkableHeight, *tile.solid);
 
-                rcRasterizeTriangles(m_rcContext, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
+                rcRasterizeTriangles(context, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
 
                 // compact heightfield spans
                 tile.chf = rcAllocCompactHeightfield();
-                if (!tile.chf || !rcBuildCompactHeightfield(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
+                if (!tile.chf || !rcBuildCompactHeightfield(context, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
                 {
                     printf("%s Failed compacting heightfield!            \n", tileString);
                     continue;
                 }
 
                 // build polymesh intermediates
-                if (!rcErodeWalkableArea(m_rcContext, config.walkableRadius, *tile.chf))
+                if (!rcErodeWalkableArea(context, config.walkableRadius, *tile.chf))
                 {
                     printf("%s Failed eroding area!                    \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildDistanceField(m_rcContext, *tile.chf))
+                if (!rcBuildDistanceField(context, *tile.chf))
                 {
                     printf("%s Failed building distance field!         \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildRegions(m_rcContext, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
+                if (!rcBuildRegions(context, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
                 {
                     printf("%s Failed building regions!                \n", tileString);
                     continue;
                 }
 
                 tile.cset = rcAllocContourSet();
-                if (!tile.cset || !rcBuildContours(m_rcContext, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
+                if (!tile.cset || !rcBuildContours(context, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
                 {
                     printf("%s Failed building contours!               \n", tileString);
                     continue;
@@ -555,14 +612,14 @@ namespace MMAP
 
                 // build polymesh
                 tile.pmesh = rcAllocPolyMesh();
-                if (!tile.pmesh || !rcBuildPolyMesh(m_rcContext, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
+                if (!tile.pmesh || !rcBuildPolyMesh(context, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
                 {
                     printf("%s Failed building polymesh!               \n", tileString);
                     continue;
                 }
 
                 tile.dmesh = rcAllocPolyMeshDetail();
-                if (!tile.dmesh || !rcBuildPolyMeshDetail(m_rcContext, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
+                if (!tile.dmesh || !rcBuildPolyMeshDetail(context, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
                 {
                     printf("%s Failed building polymesh detail!        \n", tileString);
                     continue;
@@ -619,7 +676,7 @@ namespace MMAP
             delete [] tiles;
             return;
         }
-        rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
+        rcMergePolyMeshes(context, pmmerge, nmerge, *iv.polyMesh);
 
         iv.polyMeshDetail = rcAllocPolyMeshDetail();
         if (!iv.polyMeshDetail)
@@ -628,7 +685,7 @@ namespace MMAP
             delete [] tiles;
             return;
         }
-        rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
+        rcMergePolyMeshDetails(context, dmmerge, nmerge, *iv.polyMeshDetail);
 
         // free things up
         delete [] pmmerge;
@@ -734,26 +791,19 @@ namespace MMAP
                 continue;
             }
 
-            dtTileRef tileRef = 0;
-            // DT_TILE_FREE_DATA tells detour to unallocate memory when the tile
-            // is removed via removeTile()
-            dtStatus dtResult = navMesh->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, &tileRef);
-            if (!tileRef || dtStatusFailed(dtResult))
-            {
-                printf(" Failed adding tile %s to navmesh !           \n", tileString);
-                continue;
-            }
-
-            // file output
+            // file output, written aside then renamed so that an interrupted build
+            // never leaves a cut tile that the next incremental build would keep
             char fileName[255];
             sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
-            FILE* file = fopen(fileName, "wb");
+            char tmpFileName[255];
+            sprintf(tmpFileName, "%s.tmp", fileName);
+            FILE* file = fopen(tmpFileName, "wb");
             if (!file)
             {
                 char message[1024];
-                sprintf(message, "Failed to open %s for writing!\n", fileName);
+                sprintf(message, "Failed to open %s for writing!\n", tmpFileName);
                 perror(message);
-                navMesh->removeTile(tileRef, NULL, NULL);
+                dtFree(navData);
                 continue;
             }
 
@@ -763,12 +813,33 @@ namespace MMAP
             header.size = uint32(navDataSize);
             fwrite(&header, sizeof(MmapTileHeader), 1, file);
 
-            // write data
+            // write data, before addTile: adding the tile writes links into navData which
+            // depend on the salt and index of the tile in the navmesh of this thread
             fwrite(navData, sizeof(unsigned char), navDataSize, file);
             fclose(file);
 
-            // now that tile is written to disk, we can unload it
+            dtTileRef tileRef = 0;
+            // DT_TILE_FREE_DATA tells detour to unallocate memory when the tile
+            // is removed via removeTile()
+            dtStatus dtResult = navMesh->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, &tileRef);
+            if (!tileRef || dtStatusFailed(dtResult))
+            {
+                printf(" Failed adding tile %s to navmesh !           \n", tileString);
+                dtFree(navData);
+                remove(tmpFileName);
+                continue;
+            }
+
+            // the tile is valid, we can unload it
             navMesh->removeTile(tileRef, NULL, NULL);
+
+            remove(fileName);
+            if (rename(tmpFileName, fileName) != 0)
+            {
+                char message[1024];
+                sprintf(message, "Failed to rename %s to %s!\n", tmpFileName, fileName);
+                perror(message);
+            }
         }
         while (0);
 
@@ -952,6 +1023,43 @@ namespace MMAP
             return false;
         }
 
+        if (!m_incremental)
+        {
+            return false;
+        }
+
+        // rebuild the tile when one of the files it is built from is newer
+        time_t tileTime = getFileModificationTime(fileName);
+
+        // TerrainBuilder::loadMap also reads the borders of the four neighbour map tiles
+        char mapFileNames[5][255];
+        sprintf(mapFileNames[0], "maps/%04u%02u%02u.map", mapID, tileY, tileX);
+        sprintf(mapFileNames[1], "maps/%04u%02u%02u.map", mapID, tileY, tileX + 1);
+        sprintf(mapFileNames[2], "maps/%04u%02u%02u.map", mapID, tileY, tileX - 1);
+        sprintf(mapFileNames[3], "maps/%04u%02u%02u.map", mapID, tileY + 1, tileX);
+        sprintf(mapFileNames[4], "maps/%04u%02u%02u.map", mapID, tileY - 1, tileX);
+
+        // the vmap tile lists every model spawn reaching into the tile, the tree the global ones
+        string sources[] =
+        {
+            mapFileNames[0],
+            mapFileNames[1],
+            mapFileNames[2],
+            mapFileNames[3],
+            mapFileNames[4],
+            "vmaps/" + StaticMapTree::getTileFileName(mapID, tileY, tileX),
+            "vmaps/" + VMapManager2::getMapFileName(mapID),
+            m_offMeshFilePath ? m_offMeshFilePath : ""
+        };
+
+        for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); ++i)
+        {
+            if (!sources[i].empty() && getFileModificationTime(sources[i]) > tileTime)
+            {
+                return false;
+            }
+        }
+
         return true;
     }
 }
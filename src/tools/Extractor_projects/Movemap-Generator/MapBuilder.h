@@ -28,6 +28,7 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <atomic>
 
 #include <Recast.h>
 #include <DetourNavMesh.h>
@@ -98,6 +99,8 @@ namespace MMAP
              * @param debugOutput
              * @param bigBaseUnit
              * @param offMeshFilePath
+             * @param threads number of tiles of a map built at the same time
+             * @param incremental only rebuild the tiles older than their map, vmap or off mesh files
              */
             MapBuilder(float maxWalkableAngle   = 60.f,
                        bool skipLiquid          = false,
@@ -106,7 +109,9 @@ namespace MMAP
                        bool skipBattlegrounds   = false,
                        bool debugOutput         = false,
                        bool bigBaseUnit         = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       uint32 threads           = 1,
+                       bool incremental         = true);
 
             /**
              * @brief
@@ -143,10 +148,23 @@ namespace MMAP
              * @param tileX
              * @param tileY
              * @param navMesh
+             * @param context recast context of the calling thread
              */
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
+            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, rcContext* context);
 
         private:
+            /**
+             * @brief worker thread, builds tiles of the list until none is left
+             *
+             * Each worker checks its tiles against its own navmesh, detour navmeshes are not thread safe.
+             *
+             * @param mapID
+             * @param navMeshParams
+             * @param tiles packed tile ids
+             * @param nextTile index of the next tile to build, shared by the workers
+             */
+            void buildTiles(uint32 mapID, const dtNavMeshParams* navMeshParams, const vector<uint32>* tiles, atomic<size_t>* nextTile);
+
             /**
              * @brief detect maps and tiles
              *
@@ -178,6 +196,7 @@ namespace MMAP
              * @param bmin[]
              * @param bmax[]
              * @param navMesh
+             * @param context
              */
             void buildMoveMapTile(uint32 mapID,
                                   uint32 tileX,
@@ -185,7 +204,8 @@ namespace MMAP
                                   MeshData& meshData,
                                   float bmin[3],
                                   float bmax[3],
-                                  dtNavMesh* navMesh);
+                                  dtNavMesh* navMesh,
+                                  rcContext* context);
 
             /**
              * @brief
@@ -236,8 +256,10 @@ namespace MMAP
 
             float m_maxWalkableAngle; /**< TODO */
             bool m_bigBaseUnit; /**< TODO */
+            uint32 m_threads; /**< number of tiles built at the same time */
+            bool m_incremental; /**< skip the tiles newer than their sources */
 
-            rcContext* m_rcContext; /**< build performance - not really used for now */
+            rcContext* m_rcContext; /**< build performance - not really used for now, only used by the calling thread */
     };
 }
 
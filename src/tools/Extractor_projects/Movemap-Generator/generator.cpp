@@ -25,6 +25,8 @@
 #include "MMapCommon.h"
 #include "MapBuilder.h"
 
+#include <thread>
+
 using namespace MMAP;
 
 bool checkDirectories(bool debugOutput)
@@ -78,7 +80,9 @@ void printUsage()
     printf("--debugOutput [true|false] : create debugging files for use with RecastDemo\n");
     printf("--bigBaseUnit [true|false] : Generate tile/map using bigger basic unit.\n");
     printf("--silent : Make script friendly. No wait for user input, error, completion.\n");
-    printf("--offMeshInput [file.*] : Path to file containing off mesh connections data.\n\n");
+    printf("--offMeshInput [file.*] : Path to file containing off mesh connections data.\n");
+    printf("--threads [#] : Number of tiles built at the same time, defaults to the number of cores.\n");
+    printf("--incremental [true|false] : Only rebuild the tiles older than their map, vmap or off mesh files.\n\n");
     printf("Exemple:\nmovemapgen (generate all mmap with default arg\n"
         "movemapgen 0 (generate map 0)\n"
         "movemapgen --tile 34,46 (builds only tile 34,46 of map 0)\n\n");
@@ -97,7 +101,9 @@ bool handleArgs(int argc, char** argv,
                 bool& debugOutput,
                 bool& silent,
                 bool& bigBaseUnit,
-                char*& offMeshInputPath)
+                char*& offMeshInputPath,
+                int& threads,
+                bool& incremental)
 {
     char* param = NULL;
     for (int i = 1; i < argc; ++i)
@@ -288,6 +294,45 @@ bool handleArgs(int argc, char** argv,
 
             offMeshInputPath = param;
         }
+        else if (strcmp(argv[i], "--threads") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                return false;
+            }
+
+            int numThreads = atoi(param);
+            if (numThreads > 0)
+            {
+                threads = numThreads;
+            }
+            else
+            {
+                printf("invalid option for '--threads', using default\n");
+            }
+        }
+        else if (strcmp(argv[i], "--incremental") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+            {
+                return false;
+            }
+
+            if (strcmp(param, "true") == 0)
+            {
+                incremental = true;
+            }
+            else if (strcmp(param, "false") == 0)
+            {
+                incremental = false;
+            }
+            else
+            {
+                printf("invalid option for '--incremental', using default true\n");
+            }
+        }
         else if (strcmp(argv[i], "-?") == 0)
         {
             printUsage();
@@ -331,11 +376,14 @@ int main(int argc, char** argv)
          silent = false,
          bigBaseUnit = false;
     char* offMeshInputPath = NULL;
+    int threads = std::max(int(thread::hardware_concurrency()), 1);
+    bool incremental = true;
 
     bool validParam = handleArgs(argc, argv, mapnum,
                                  tileX, tileY, maxAngle,
                                  skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds,
-                                 debugOutput, silent, bigBaseUnit, offMeshInputPath);
+                                 debugOutput, silent, bigBaseUnit, offMeshInputPath,
+                                 threads, incremental);
 
     if (!validParam)
     {
@@ -364,7 +412,8 @@ int main(int argc, char** argv)
     }
 
     MapBuilder builder(maxAngle, skipLiquid, skipContinents, skipJunkMaps,
-                       skipBattlegrounds, debugOutput, bigBaseUnit, offMeshInputPath);
+                       skipBattlegrounds, debugOutput, bigBaseUnit, offMeshInputPath,
+                       uint32(threads), incremental);
 
     if (tileX > -1 && tileY > -1 && mapnum >= 0)
     {
@@ -28,6 +28,7 @@
 #include <deque>
 #include <map>
 #include <set>
+#include <string>
 
 #include "dbcfile.h"
 // The following is a temp fix until the extractor is merged with the unified extractor
@@ -37,6 +38,7 @@
 #include "../loadlib/sl/wdt.h"
 //#include "sl/wdt.h"
 #include "../shared/ExtractorCommon.h"
+#include "../shared/ExtractorPipeline.h"
 #ifndef WIN32
 #include <unistd.h>
 #endif
@@ -88,6 +90,7 @@ char output_path[128] = ".";        /**< TODO */
 char input_path[128] = ".";         /**< TODO */
 uint32 maxAreaId = 0;               /**< TODO */
 uint32 CONF_max_build = 0;
+int CONF_threads = GetDefaultExtractorThreads(); /**< Number of threads converting the ADT files */
 /**
  * @brief Data types which can be extracted
  *
@@ -141,6 +144,8 @@ void Usage(char* prg)
     printf("                         size, but also accuracy\n");
     printf("   -e, --extract #       extract specified client data. 1 = maps, 2 = DBCs,\n");
     printf("                         3 = both. Defaults to extracting both.\n");
+    printf("   -t, --threads #       number of threads converting map files, defaults to\n");
+    printf("                         the number of cores minus the archive reader.\n");
     printf("\n");
     printf(" Example:\n");
     printf(" - use input path and do not flatten maps:\n");
@@ -163,6 +168,7 @@ void HandleArgs(int argc, char* arg[])
         // e - extract only MAP(1)/DBC(2) - standard both(3)
         // f - use float to int conversion
         // h - limit minimum height
+        // t - number of converting threads
         if (arg[c][0] != '-')
         {
             Usage(arg[0]);
@@ -214,6 +220,20 @@ void HandleArgs(int argc, char* arg[])
                     Usage(arg[0]);
                 }
                 break;
+            case 't':
+                if (c + 1 < argc)                           // all ok
+                {
+                    CONF_threads = atoi(arg[(c++) + 1]);
+                    if (CONF_threads < 1)
+                    {
+                        Usage(arg[0]);
+                    }
+                }
+                else
+                {
+                    Usage(arg[0]);
+                }
+                break;
             case 'b':
                 if (c + 1 < argc)                           // all ok
                 {
@@ -570,33 +590,36 @@ float selectUInt16StepStore(float maxDiff)
     return 65535 / maxDiff;
 }
 
-uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];      /**< Temporary grid data store */
+// Temporary grid data store, one per converting thread
+thread_local uint16 area_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];      /**< TODO */
 
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                         /**< TODO */
-float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];                 /**< TODO */
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                 /**< TODO */
-uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];         /**< TODO */
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                  /**< TODO */
-uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];          /**< TODO */
+thread_local float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                         /**< TODO */
+thread_local float V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];                 /**< TODO */
+thread_local uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                 /**< TODO */
+thread_local uint16 uint16_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];         /**< TODO */
+thread_local uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];                  /**< TODO */
+thread_local uint8  uint8_V9[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];          /**< TODO */
 
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];    /**< TODO */
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];     /**< TODO */
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];                /**< TODO */
-float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];      /**< TODO */
+thread_local uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];    /**< TODO */
+thread_local uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];     /**< TODO */
+thread_local bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];                /**< TODO */
+thread_local float liquid_height[ADT_GRID_SIZE + 1][ADT_GRID_SIZE + 1];      /**< TODO */
 
 /**
  * @brief
  *
+ * @param data content of the ADT file, owned by the function
+ * @param size
  * @param filename
  * @param filename2
  * @param build
  * @return bool
  */
-bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32 build)
+bool ConvertADT(uint8* data, uint32 size, char const* filename, char const* filename2, int cell_y, int cell_x, uint32 build)
 {
     ADT_file adt;
 
-    if (!adt.loadFile(filename, false))
+    if (!adt.loadData(data, size))
     {
         return false;
     }
@@ -1227,6 +1250,38 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
     return true;
 }
 
+/**
+ * @brief an ADT file read from the archives, waiting for its conversion
+ *
+ */
+struct ADTConvertJob
+{
+    uint8* data;                    /**< file content, owned by the job until converted */
+    uint32 size;
+    int cell_y;
+    int cell_x;
+    std::string mpqName;
+    std::string outputName;
+};
+
+/**
+ * @brief converting thread, takes the ADT files read by the extracting thread until there is none left
+ *
+ * @param queue
+ * @param progress
+ * @param build
+ */
+void ConvertADTWorker(ExtractorQueue<ADTConvertJob*>* queue, ExtractorProgress* progress, uint32 build)
+{
+    ADTConvertJob* job;
+    while (queue->Pop(job))
+    {
+        ConvertADT(job->data, job->size, job->mpqName.c_str(), job->outputName.c_str(), job->cell_y, job->cell_x, build);
+        progress->Converted();
+        delete job;
+    }
+}
+
 /**
  * @brief
  *
@@ -1248,7 +1303,17 @@ void ExtractMapsFromMpq(uint32 build, const int locale)
     path += "/maps/";
     CreateDir(path);
 
-    printf("\n Converting map files\n");
+    // this thread is the only one using the archives, the ADT files are converted by the workers
+    printf("\n Converting map files on %d threads\n", CONF_threads);
+    ExtractorQueue<ADTConvertJob*> queue(CONF_threads * 4);
+    ExtractorProgress progress;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < CONF_threads; ++i)
+    {
+        workers.push_back(std::thread(ConvertADTWorker, &queue, &progress, build));
+    }
+
     for (uint32 z = 0; z < map_count; ++z)
     {
         printf(" Extract %s (%d/%d)                      \n", map_ids[z].name, z + 1, map_count);
@@ -1270,12 +1335,34 @@ void ExtractMapsFromMpq(uint32 build, const int locale)
                 }
                 sprintf(mpq_filename, "World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
                 sprintf(output_filename, "%s/maps/%04u%02u%02u.map", output_path, map_ids[z].id, y, x);
-                ConvertADT(mpq_filename, output_filename, y, x, build);
+
+                ADTConvertJob* job = new ADTConvertJob;
+                if (!ReadNewestFile(mpq_filename, job->data, job->size, false))
+                {
+                    delete job;
+                    continue;
+                }
+
+                job->cell_y = y;
+                job->cell_x = x;
+                job->mpqName = mpq_filename;
+                job->outputName = output_filename;
+
+                progress.Read(job->size);
+                queue.Push(job);
             }
-            // draw progress bar
-            printf(" Processing........................%d%%\r", (100 * (y + 1)) / WDT_MAP_SIZE);
+            // draw progress
+            progress.Report();
         }
     }
+
+    queue.Close();
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        workers[i].join();
+    }
+    progress.Report(true);
+
     delete [] areas;
     delete [] map_ids;
 }
@@ -0,0 +1,143 @@
+/**
+ * MaNGOS is a full featured server for World of Warcraft, supporting
+ * the following clients: 1.12.x, 2.4.3, 3.3.5a, 4.3.4a and 5.4.8
+ *
+ * Copyright (C) 2005-2025 MaNGOS <https://www.getmangos.eu>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * World of Warcraft, and all World of Warcraft or Warcraft art, images,
+ * and lore are copyrighted by Blizzard Entertainment, Inc.
+ */
+
+#ifndef MANGOS_H_EXTRACTOR_PIPELINE
+#define MANGOS_H_EXTRACTOR_PIPELINE
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Bounded queue handing the files read from the archives to the converting threads.
+ *
+ * StormLib handles must not be shared between threads, so a single reader thread
+ * owns the archives and pushes the file contents, the workers pop and convert them.
+ * The reader blocks when the workers fall behind, which bounds the memory in use.
+ */
+template<class T>
+class ExtractorQueue
+{
+    public:
+        explicit ExtractorQueue(size_t capacity) : m_capacity(capacity), m_closed(false) {}
+
+        /// Blocks while the queue is full
+        void Push(T item)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this]() { return m_items.size() < m_capacity; });
+            m_items.push_back(item);
+            m_notEmpty.notify_one();
+        }
+
+        /// Blocks while the queue is empty, returns false once it is closed and drained
+        bool Pop(T& item)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this]() { return !m_items.empty() || m_closed; });
+            if (m_items.empty())
+            {
+                return false;
+            }
+
+            item = m_items.front();
+            m_items.pop_front();
+            m_notFull.notify_one();
+            return true;
+        }
+
+        /// No more items will be pushed, the workers stop when the queue is drained
+        void Close()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            m_notEmpty.notify_all();
+        }
+
+    private:
+        size_t m_capacity;
+        bool m_closed;
+        std::deque<T> m_items;
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+};
+
+/**
+ * @brief Counts the converted files and the bytes read, and prints the throughput.
+ */
+class ExtractorProgress
+{
+    public:
+        ExtractorProgress() : m_files(0), m_bytes(0), m_start(std::chrono::steady_clock::now()), m_lastReport(m_start) {}
+
+        /// Called by the reader for every file read from the archives
+        void Read(size_t bytes) { m_bytes += bytes; }
+
+        /// Called by the workers for every converted file
+        void Converted() { ++m_files; }
+
+        /// Print the throughput, at most once a second unless final
+        void Report(bool final = false)
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (!final && now - m_lastReport < std::chrono::seconds(1))
+            {
+                return;
+            }
+            m_lastReport = now;
+
+            double seconds = std::chrono::duration<double>(now - m_start).count();
+            if (seconds <= 0.0)
+            {
+                seconds = 1.0;
+            }
+
+            printf(" %u files converted, %.1f files/s, %.1f MB/s read from the archives%s",
+                   (unsigned int)m_files, m_files / seconds, m_bytes / seconds / (1024.0 * 1024.0), final ? "\n" : "\r");
+            fflush(stdout);
+        }
+
+    private:
+        std::atomic<unsigned int> m_files;
+        std::atomic<unsigned long long> m_bytes;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_lastReport;
+};
+
+/// Number of converting threads when none is given on the command line
+inline int GetDefaultExtractorThreads()
+{
+    int threads = int(std::thread::hardware_concurrency());
+
+    // one core is kept for the reader thread
+    return threads > 2 ? threads - 1 : 1;
+}
+
+#endif
@@ -56,6 +56,7 @@
 #include "vmapexport.h"
 
 #include "../shared/ExtractorCommon.h"
+#include "../shared/ExtractorPipeline.h"
 
 //------------------------------------------------------------------------------
 // Defines
@@ -104,6 +105,7 @@ char output_path[128] = ".";
 char input_path[1024] = ".";
 bool preciseVectorData = true;
 uint32 CONF_max_build = 0;
+int CONF_threads = GetDefaultExtractorThreads();    // threads converting the wmo files
 
 // Constants
 
@@ -456,6 +458,7 @@ void Usage(char* prg)
     printf("   -l : large size, ~500MB more vmap data. (might contain more details)\n");
     printf("   -d <path>: Path to the vector data source folder.\n");
     printf("   -b : target build (default %u)", CONF_TargetBuild);
+    printf("   -t <threads>: number of threads converting wmo files (default %d)\n", CONF_threads);
     printf("   -? : This message.\n");
 }
 
@@ -503,37 +506,35 @@ void ParsMapFiles()
     }
 }
 
-bool ExtractWmo()
+/**
+ * @brief a root wmo and its group files read from the archives, waiting for their conversion
+ */
+struct WmoExtractJob
 {
-    bool success = false;
-
-    //const char* ParsArchiveNames[] = {"patch-2.MPQ", "patch.MPQ", "common.MPQ", "expansion.MPQ"};
-
-    SFILE_FIND_DATA data;
-    HANDLE find = SFileFindFirstFile(WorldMpq, "*.wmo", &data, NULL);
-    if (find != NULL)
+    WmoExtractJob(std::string& fname) : root(fname) {}
+    ~WmoExtractJob()
     {
-        do
+        for (size_t i = 0; i < groups.size(); ++i)
         {
-            std::string str = data.cFileName;
-            //printf("Extracting wmo %s\n", str.c_str());
-            success |= ExtractSingleWmo(str);
+            delete groups[i];
         }
-        while (SFileFindNextFile(find, &data));
-    }
-    SFileFindClose(find);
-
-    if (success)
-    {
-        printf("\nExtract wmo complete (No (fatal) errors)\n");
     }
 
-    return success;
-}
+    std::string localFile;
+    WMORoot root;
+    std::vector<MPQFile*> groups;
+};
 
-bool ExtractSingleWmo(std::string& fname)
+/**
+ * @brief reads a root wmo and its groups, must be called from the thread owning the archives
+ *
+ * @param fname
+ * @param job set to the files to convert, NULL when there is nothing to convert
+ * @return bytes read
+ */
+size_t ReadSingleWmo(std::string& fname, WmoExtractJob*& job)
 {
-    // Copy files from archive
+    job = NULL;
 
     char szLocalFile[1024];
     const char* plain_name = GetPlainName(fname.c_str());
@@ -542,7 +543,7 @@ bool ExtractSingleWmo(std::string& fname)
 
     if (FileExists(szLocalFile))
     {
-        return true;
+        return 0;
     }
 
     int p = 0;
@@ -564,48 +565,77 @@ bool ExtractSingleWmo(std::string& fname)
 
     if (p == 3)
     {
-        return true;
+        return 0;
     }
 
-    bool file_ok = true;
     std::cout << "Extracting " << fname << std::endl;
-    WMORoot froot(fname);
-    if (!froot.open())
+    WmoExtractJob* froot = new WmoExtractJob(fname);
+    froot->localFile = szLocalFile;
+
+    MPQFile rootFile(WorldMpq, fname.c_str());
+    size_t bytes = rootFile.getSize();
+    if (!froot->root.open(rootFile))
     {
         printf("Couldn't open RootWmo!!!\n");
-        return true;
+        delete froot;
+        return 0;
+    }
+
+    for (uint32 i = 0; i < froot->root.nGroups; ++i)
+    {
+        char temp[1024];
+        strcpy(temp, fname.c_str());
+        temp[fname.length() - 4] = 0;
+        char groupFileName[1024];
+        sprintf(groupFileName, "%s_%03d.wmo", temp, i);
+        //printf("Trying to open groupfile %s\n",groupFileName);
+
+        MPQFile* groupFile = new MPQFile(WorldMpq, groupFileName);
+        if (groupFile->isEof())
+        {
+            // an incomplete wmo is not written at all
+            printf(" No such file.\n");
+            printf("Could not open all Group file for: %s\n", plain_name);
+            delete groupFile;
+            delete froot;
+            return bytes;
+        }
+        bytes += groupFile->getSize();
+        froot->groups.push_back(groupFile);
     }
-    FILE* output = fopen(szLocalFile, "wb");
+
+    job = froot;
+    return bytes;
+}
+
+/**
+ * @brief converts a wmo read by ReadSingleWmo, safe to call from any thread
+ *
+ * @param job
+ * @return bool false when the output file can not be written
+ */
+bool ConvertSingleWmo(WmoExtractJob* job)
+{
+    FILE* output = fopen(job->localFile.c_str(), "wb");
     if (!output)
     {
-        printf("couldn't open %s for writing!\n", szLocalFile);
+        printf("couldn't open %s for writing!\n", job->localFile.c_str());
         return false;
     }
-    froot.ConvertToVMAPRootWmo(output);
+    job->root.ConvertToVMAPRootWmo(output);
     int Wmo_nVertices = 0;
-    //printf("root has %d groups\n", froot->nGroups);
-    if (froot.nGroups != 0)
+    bool file_ok = true;
+    for (size_t i = 0; i < job->groups.size(); ++i)
     {
-        for (uint32 i = 0; i < froot.nGroups; ++i)
+        std::string groupFileName;
+        WMOGroup fgroup(groupFileName);
+        if (!fgroup.open(*job->groups[i]))
         {
-            char temp[1024];
-            strcpy(temp, fname.c_str());
-            temp[fname.length() - 4] = 0;
-            char groupFileName[1024];
-            sprintf(groupFileName, "%s_%03d.wmo", temp, i);
-            //printf("Trying to open groupfile %s\n",groupFileName);
-
-            string s = groupFileName;
-            WMOGroup fgroup(s);
-            if (!fgroup.open())
-            {
-                printf("Could not open all Group file for: %s\n", plain_name);
-                file_ok = false;
-                break;
-            }
-
-            Wmo_nVertices += fgroup.ConvertToVMAPGroupWmo(output, &froot, preciseVectorData);
+            file_ok = false;
+            break;
         }
+
+        Wmo_nVertices += fgroup.ConvertToVMAPGroupWmo(output, &job->root, preciseVectorData);
     }
 
     fseek(output, 8, SEEK_SET); // store the correct no of vertices
@@ -615,11 +645,103 @@ bool ExtractSingleWmo(std::string& fname)
     // Delete the extracted file in the case of an error
     if (!file_ok)
     {
-        remove(szLocalFile);
+        remove(job->localFile.c_str());
     }
     return true;
 }
 
+/**
+ * @brief converting thread, takes the wmo files read by the extracting thread until there is none left
+ *
+ * @param queue
+ * @param progress
+ * @param success set when a wmo could be written
+ */
+void ConvertWmoWorker(ExtractorQueue<WmoExtractJob*>* queue, ExtractorProgress* progress, std::atomic<bool>* success)
+{
+    WmoExtractJob* job;
+    while (queue->Pop(job))
+    {
+        if (ConvertSingleWmo(job))
+        {
+            *success = true;
+        }
+        progress->Converted();
+        delete job;
+    }
+}
+
+bool ExtractWmo()
+{
+    std::atomic<bool> success(false);
+
+    //const char* ParsArchiveNames[] = {"patch-2.MPQ", "patch.MPQ", "common.MPQ", "expansion.MPQ"};
+
+    // StormLib is only used from this thread, the wmo files are converted by the workers
+    printf("Converting wmo files on %d threads\n", CONF_threads);
+    ExtractorQueue<WmoExtractJob*> queue(CONF_threads * 4);
+    ExtractorProgress progress;
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < CONF_threads; ++i)
+    {
+        workers.push_back(std::thread(ConvertWmoWorker, &queue, &progress, &success));
+    }
+
+    SFILE_FIND_DATA data;
+    HANDLE find = SFileFindFirstFile(WorldMpq, "*.wmo", &data, NULL);
+    if (find != NULL)
+    {
+        do
+        {
+            std::string str = data.cFileName;
+            //printf("Extracting wmo %s\n", str.c_str());
+            WmoExtractJob* job;
+            size_t bytes = ReadSingleWmo(str, job);
+            if (!job)
+            {
+                // skipped or failed to read, which does not stop the extraction
+                success = true;
+                continue;
+            }
+            progress.Read(bytes);
+            queue.Push(job);
+            progress.Report();
+        }
+        while (SFileFindNextFile(find, &data));
+    }
+    SFileFindClose(find);
+
+    queue.Close();
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        workers[i].join();
+    }
+    progress.Report(true);
+
+    if (success)
+    {
+        printf("\nExtract wmo complete (No (fatal) errors)\n");
+    }
+
+    return success;
+}
+
+bool ExtractSingleWmo(std::string& fname)
+{
+    // Copy files from archive
+    WmoExtractJob* job;
+    ReadSingleWmo(fname, job);
+    if (!job)
+    {
+        return true;
+    }
+
+    bool result = ConvertSingleWmo(job);
+    delete job;
+    return result;
+}
+
 void getGamePath()
 {
 #ifdef _WIN32
@@ -703,6 +825,18 @@ bool processArgv(int argc, char** argv)
                 CONF_TargetBuild = atoi(argv[i++ + 1]);
             }
         }
+        else if (strcmp("-t", argv[i]) == 0)
+        {
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0)
+            {
+                CONF_threads = atoi(argv[i++ + 1]);
+            }
+            else
+            {
+                result = false;
+                break;
+            }
+        }
         else
         {
             result = false;
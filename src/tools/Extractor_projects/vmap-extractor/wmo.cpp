@@ -48,6 +48,11 @@ extern HANDLE WorldMpq;
 bool WMORoot::open()
 {
     MPQFile f(WorldMpq, filename.c_str());
+    return open(f);
+}
+
+bool WMORoot::open(MPQFile& f)
+{
     if (f.isEof())
     {
         printf(" No such file %s.\n", filename.c_str());
@@ -154,6 +159,11 @@ WMOGroup::WMOGroup(std::string& filename) : filename(filename),
 bool WMOGroup::open()
 {
     MPQFile f(WorldMpq, filename.c_str());
+    return open(f);
+}
+
+bool WMOGroup::open(MPQFile& f)
+{
     if (f.isEof())
     {
         printf(" No such file.\n");
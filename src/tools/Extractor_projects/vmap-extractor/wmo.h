@@ -79,6 +79,13 @@ class WMORoot
          * @return bool
          */
         bool open();
+        /**
+         * @brief parses a file already read from the archives
+         *
+         * @param f
+         * @return bool
+         */
+        bool open(MPQFile& f);
         /**
          * @brief
          *
@@ -165,6 +172,13 @@ class WMOGroup
          * @return bool
          */
         bool open();
+        /**
+         * @brief parses a file already read from the archives
+         *
+         * @param f
+         * @return bool
+         */
+        bool open(MPQFile& f);
         /**
          * @brief
          *